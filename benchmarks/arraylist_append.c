@@ -0,0 +1,72 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// appends APPEND_COUNT ints to an arraylist, growing it by doubling
+#define APPEND_COUNT (10000000)
+
+/* the global allocator as it used to be: every allocation is zeroed and
+   realloc allocates a new zeroed block, copies and leaks the old one */
+static Yoru_Opt legacy_alloc(anyptr ctx, usize size) {
+  (void)ctx;
+  anyptr ptr = calloc(1, size);
+  if (!ptr) return yoru_opt_none();
+  return yoru_opt_some(ptr);
+}
+
+static Yoru_Opt legacy_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  (void)alignment;
+  return legacy_alloc(ctx, size);
+}
+
+static void legacy_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  free(ptr);
+}
+
+static Yoru_Opt legacy_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  Yoru_Opt maybe_new_ptr = legacy_alloc(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  return maybe_new_ptr;
+}
+
+static void legacy_destroy(anyptr ctx) {
+  (void)ctx;
+}
+
+static const Yoru_AllocatorVTable legacy_vtable = {
+    .alloc         = legacy_alloc,
+    .alloc_uninit  = legacy_alloc,
+    .alloc_aligned = legacy_alloc_aligned,
+    .dealloc       = legacy_dealloc,
+    .realloc       = legacy_realloc,
+    .destroy       = legacy_destroy,
+};
+
+static u64 append_ints(Yoru_Allocator *allocator) {
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_ArrayList_T(i32) list = {0};
+  yoru_arraylist_init(&list, allocator, 0);
+  for (i32 i = 0; i < APPEND_COUNT; ++i) {
+    yoru_arraylist_append(&list, i);
+  }
+  YORU_BENCH_DO_NOT_OPTIMIZE(list.items[list.size - 1]);
+  yoru_allocator_dealloc(allocator, list.items);
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  printf("appending %d ints to an arraylist\n\n", APPEND_COUNT);
+
+  Yoru_Allocator legacy = {.vtable = &legacy_vtable, .ctx = NULL};
+  YORU_BENCH_REPORT("calloc + memcpy realloc (before)", APPEND_COUNT, append_ints(&legacy));
+
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  YORU_BENCH_REPORT("global allocator realloc (after)", APPEND_COUNT, append_ints(&global));
+  return 0;
+}
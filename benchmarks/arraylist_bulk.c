@@ -0,0 +1,60 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// concatenates BATCH_COUNT batches of BATCH_SIZE records into one list,
+// appending record by record vs one bulk copy per batch. The list is reused
+// for ROUNDS rounds, so after the first one this measures the copying and not
+// the page faults of a fresh list
+#define BATCH_SIZE (4096)
+#define BATCH_COUNT (64)
+#define ROUNDS (100)
+
+typedef struct Record {
+  u64 id;
+  u32 kind;
+  f32 value;
+} Record;
+
+typedef Yoru_ArrayList_T(Record) RecordList;
+
+static u64 concat(Yoru_Allocator *allocator, const RecordList *batch, bool bulk) {
+  u64 start = yoru_bench_now_ns();
+
+  RecordList all = {0};
+  yoru_arraylist_init(&all, allocator, 0);
+  for (usize round = 0; round < ROUNDS; ++round) {
+    all.size = 0;
+    for (usize i = 0; i < BATCH_COUNT; ++i) {
+      if (bulk) {
+        yoru_arraylist_extend(&all, batch);
+      } else {
+        for (usize j = 0; j < batch->size; ++j) yoru_arraylist_append(&all, batch->items[j]);
+      }
+    }
+    YORU_BENCH_DO_NOT_OPTIMIZE(all.items[all.size - 1].id);
+  }
+  yoru_allocator_dealloc(allocator, all.items);
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+
+  RecordList batch = {0};
+  yoru_arraylist_init(&batch, &global, BATCH_SIZE);
+  for (u64 i = 0; i < BATCH_SIZE; ++i) {
+    yoru_arraylist_append(&batch, ((Record){.id = i, .kind = (u32)i % 7, .value = (f32)i}));
+  }
+
+  u64 ops = (u64)ROUNDS * BATCH_COUNT * BATCH_SIZE;
+  printf("concatenating %d batches of %d records, %d times\n\n", BATCH_COUNT, BATCH_SIZE, ROUNDS);
+  YORU_BENCH_REPORT("append per record", ops, concat(&global, &batch, false));
+  YORU_BENCH_REPORT("extend per batch", ops, concat(&global, &batch, true));
+
+  yoru_allocator_dealloc(&global, batch.items);
+  return 0;
+}
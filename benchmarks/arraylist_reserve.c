@@ -0,0 +1,47 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// builds lists of LIST_SIZE ints, growing by doubling vs reserving the size
+// up front, ROUNDS times each
+#define LIST_SIZE (10000000)
+#define ROUNDS (5)
+
+typedef enum { GROW, RESERVE, INIT_CAPACITY } BuildMode;
+
+static u64 build_lists(Yoru_Allocator *allocator, BuildMode mode) {
+  u64 start = yoru_bench_now_ns();
+
+  for (usize round = 0; round < ROUNDS; ++round) {
+    Yoru_ArrayList_T(i32) list = {0};
+    yoru_arraylist_init(&list, allocator, mode == INIT_CAPACITY ? LIST_SIZE : 0);
+    if (mode == RESERVE) yoru_arraylist_reserve(&list, LIST_SIZE);
+    for (i32 i = 0; i < LIST_SIZE; ++i) {
+      yoru_arraylist_append(&list, i);
+    }
+    YORU_BENCH_DO_NOT_OPTIMIZE(list.items[list.size - 1]);
+    yoru_allocator_dealloc(allocator, list.items);
+  }
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  printf("building %d lists of %d ints\n\n", ROUNDS, LIST_SIZE);
+
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  YORU_BENCH_REPORT("global, doubling", (u64)LIST_SIZE * ROUNDS, build_lists(&global, GROW));
+  YORU_BENCH_REPORT("global, reserve", (u64)LIST_SIZE * ROUNDS, build_lists(&global, RESERVE));
+  YORU_BENCH_REPORT("global, init with capacity", (u64)LIST_SIZE * ROUNDS, build_lists(&global, INIT_CAPACITY));
+  printf("\n");
+
+  Yoru_VirtualArenaAllocator *arena = yoru_virtual_arena_allocator_make(YORU_GiB(4));
+  assert(arena);
+  YORU_BENCH_REPORT("virtual arena, doubling", (u64)LIST_SIZE * ROUNDS, build_lists(arena, GROW));
+  yoru_virtual_arena_allocator_reset(arena);
+  YORU_BENCH_REPORT("virtual arena, reserve", (u64)LIST_SIZE * ROUNDS, build_lists(arena, RESERVE));
+  yoru_allocator_destroy(arena);
+  return 0;
+}
@@ -0,0 +1,127 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// THREAD_COUNTS threads share one arena and allocate TOTAL_ALLOCS blocks of
+// ALLOC_SIZE bytes between them, touching the first byte of every block
+#define TOTAL_ALLOCS (4000000)
+#define ALLOC_SIZE (32)
+#define ARENA_CAPACITY (YORU_GiB(1))
+#define MAX_THREADS (32)
+
+/* a virtual arena behind a mutex, which is how an arena had to be shared
+   between threads before */
+typedef struct MutexArena {
+  Yoru_Mutex      mutex;
+  Yoru_Allocator *arena;
+} MutexArena;
+
+static Yoru_Opt mutex_arena_alloc(anyptr ctx, usize size) {
+  MutexArena *m = ctx;
+  yoru_mutex_lock(&m->mutex);
+  Yoru_Opt maybe_ptr = yoru_allocator_alloc(m->arena, size);
+  yoru_mutex_unlock(&m->mutex);
+  return maybe_ptr;
+}
+
+static Yoru_Opt mutex_arena_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  MutexArena *m = ctx;
+  yoru_mutex_lock(&m->mutex);
+  Yoru_Opt maybe_ptr = yoru_allocator_alloc_aligned(m->arena, size, alignment);
+  yoru_mutex_unlock(&m->mutex);
+  return maybe_ptr;
+}
+
+static void mutex_arena_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  (void)ptr;
+}
+
+static Yoru_Opt mutex_arena_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  MutexArena *m = ctx;
+  yoru_mutex_lock(&m->mutex);
+  Yoru_Opt maybe_ptr = yoru_allocator_realloc(m->arena, old_size, old_ptr, new_size);
+  yoru_mutex_unlock(&m->mutex);
+  return maybe_ptr;
+}
+
+static void mutex_arena_destroy(anyptr ctx) {
+  MutexArena *m = ctx;
+  yoru_allocator_destroy(m->arena);
+  yoru_mutex_destroy(&m->mutex);
+}
+
+static const Yoru_AllocatorVTable mutex_arena_vtable = {
+    .alloc         = mutex_arena_alloc,
+    .alloc_uninit  = mutex_arena_alloc,
+    .alloc_aligned = mutex_arena_alloc_aligned,
+    .dealloc       = mutex_arena_dealloc,
+    .realloc       = mutex_arena_realloc,
+    .destroy       = mutex_arena_destroy,
+};
+
+typedef struct Worker {
+  Yoru_Allocator *allocator;
+  usize           allocs;
+} Worker;
+
+static void worker_run(anyptr arg) {
+  Worker *worker = arg;
+  for (usize i = 0; i < worker->allocs; ++i) {
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc_uninit(worker->allocator, ALLOC_SIZE);
+    assert(maybe_ptr.has_value);
+    ((u8 *)maybe_ptr.ptr)[0] = (u8)i;
+  }
+}
+
+static u64 run_threads(Yoru_Allocator *allocator, usize thread_count) {
+  Yoru_Thread threads[MAX_THREADS];
+  Worker      workers[MAX_THREADS];
+
+  u64 start = yoru_bench_now_ns();
+  for (usize i = 0; i < thread_count; ++i) {
+    workers[i] = (Worker){.allocator = allocator, .allocs = TOTAL_ALLOCS / thread_count};
+    bool ok    = yoru_thread_spawn(&threads[i], worker_run, &workers[i]);
+    assert(ok);
+    (void)ok;
+  }
+  for (usize i = 0; i < thread_count; ++i) {
+    yoru_thread_join(&threads[i]);
+  }
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  usize thread_counts[] = {1, 2, 4, 8, 16, 32};
+  usize count           = sizeof(thread_counts) / sizeof(thread_counts[0]);
+  char  name_buf[64]    = {0};
+
+  printf(
+      "%d allocations of %d bytes shared between threads, %zu cpus\n\n",
+      TOTAL_ALLOCS,
+      ALLOC_SIZE,
+      yoru_get_cpu_count());
+
+  for (usize i = 0; i < count; ++i) {
+    MutexArena mutex_ctx = {.arena = yoru_virtual_arena_allocator_make(ARENA_CAPACITY)};
+    assert(mutex_ctx.arena);
+    bool ok = yoru_mutex_init(&mutex_ctx.mutex);
+    assert(ok);
+    (void)ok;
+    Yoru_Allocator mutex_arena = {.vtable = &mutex_arena_vtable, .ctx = &mutex_ctx};
+
+    snprintf(name_buf, sizeof(name_buf), "mutex arena, %zu threads", thread_counts[i]);
+    YORU_BENCH_REPORT(name_buf, TOTAL_ALLOCS, run_threads(&mutex_arena, thread_counts[i]));
+    yoru_allocator_destroy(&mutex_arena);
+
+    Yoru_ConcurrentArenaAllocator *concurrent = yoru_concurrent_arena_allocator_make(ARENA_CAPACITY);
+    assert(concurrent);
+    snprintf(name_buf, sizeof(name_buf), "concurrent arena, %zu threads", thread_counts[i]);
+    YORU_BENCH_REPORT(name_buf, TOTAL_ALLOCS, run_threads(concurrent, thread_counts[i]));
+    yoru_allocator_destroy(concurrent);
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// a work queue holding QUEUE_DEPTH jobs, OPS times one job is enqueued and
+// the oldest one is taken out
+#define QUEUE_DEPTH (10000)
+#define OPS (1000000)
+
+typedef struct Job {
+  u64 id;
+  u64 payload;
+} Job;
+
+/* the queue as it had to be written with an ArrayList: new jobs are
+   prepended and the oldest one is taken from the end */
+static u64 arraylist_queue(Yoru_Allocator *allocator) {
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_ArrayList_T(Job) queue = {0};
+  yoru_arraylist_init(&queue, allocator, 0);
+  for (u64 i = 0; i < QUEUE_DEPTH; ++i) yoru_arraylist_prepend(&queue, ((Job){.id = i}));
+  u64 sum = 0;
+  for (u64 i = 0; i < OPS; ++i) {
+    yoru_arraylist_prepend(&queue, ((Job){.id = i, .payload = i}));
+    sum += queue.items[--queue.size].id;
+  }
+  YORU_BENCH_DO_NOT_OPTIMIZE(sum);
+  yoru_allocator_dealloc(allocator, queue.items);
+
+  return yoru_bench_now_ns() - start;
+}
+
+static u64 deque_queue(Yoru_Allocator *allocator) {
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_Deque_T(Job) queue = {0};
+  yoru_deque_init(&queue, allocator, 0);
+  for (u64 i = 0; i < QUEUE_DEPTH; ++i) yoru_deque_push_back(&queue, ((Job){.id = i}));
+  u64 sum = 0;
+  Job job = {0};
+  for (u64 i = 0; i < OPS; ++i) {
+    yoru_deque_push_back(&queue, ((Job){.id = i, .payload = i}));
+    yoru_deque_pop_front(&queue, &job);
+    sum += job.id;
+  }
+  YORU_BENCH_DO_NOT_OPTIMIZE(sum);
+  yoru_deque_destroy(&queue);
+
+  return yoru_bench_now_ns() - start;
+}
+
+// moves OPS jobs through the queue in batches of BATCH_SIZE
+#define BATCH_SIZE (256)
+
+static u64 deque_queue_batched(Yoru_Allocator *allocator) {
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_Deque_T(Job) queue = {0};
+  yoru_deque_init(&queue, allocator, 0);
+  for (u64 i = 0; i < QUEUE_DEPTH; ++i) yoru_deque_push_back(&queue, ((Job){.id = i}));
+  Job   batch[BATCH_SIZE] = {0};
+  usize popped            = 0;
+  u64   sum               = 0;
+  for (u64 i = 0; i < OPS; i += BATCH_SIZE) {
+    for (u64 j = 0; j < BATCH_SIZE; ++j) batch[j] = (Job){.id = i + j, .payload = i + j};
+    yoru_deque_push_back_many(&queue, batch, BATCH_SIZE);
+    yoru_deque_pop_front_many(&queue, batch, BATCH_SIZE, &popped);
+    sum += batch[popped - 1].id;
+  }
+  YORU_BENCH_DO_NOT_OPTIMIZE(sum);
+  yoru_deque_destroy(&queue);
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  printf("%d jobs through a queue of %d jobs\n\n", OPS, QUEUE_DEPTH);
+
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  YORU_BENCH_REPORT("arraylist prepend + pop back", OPS, arraylist_queue(&global));
+  YORU_BENCH_REPORT("deque push back + pop front", OPS, deque_queue(&global));
+  YORU_BENCH_REPORT("deque, batches of 256", OPS, deque_queue_batched(&global));
+  return 0;
+}
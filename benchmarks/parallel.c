@@ -0,0 +1,98 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// aggregates RECORD_COUNT records with for_each, map, reduce and filter on
+// the calling thread and on pools of up to one thread per cpu
+#define RECORD_COUNT (20000000)
+#define MAX_THREADS (64)
+
+typedef struct Record {
+  u64 id;
+  u32 kind;
+  u32 amount;
+} Record;
+
+#define APPLY_FEE(x, ctx) ((x)->amount -= (x)->amount / 100)
+YORU_PARALLEL_FOR_EACH_DEFINE(apply_fee, Record, APPLY_FEE)
+
+#define AMOUNT_OF(x, ctx) ((u64)(x).amount)
+YORU_PARALLEL_MAP_DEFINE(amounts_of, Record, u64, AMOUNT_OF)
+
+#define ADD(a, b) ((a) + (b))
+YORU_PARALLEL_REDUCE_DEFINE(sum_u64s, u64, ADD)
+
+#define IS_KIND(x, ctx) ((x).kind == *(u32 *)(ctx))
+YORU_PARALLEL_FILTER_DEFINE(filter_kind, Record, IS_KIND)
+
+typedef Yoru_ArrayList_T(Record) Records;
+typedef Yoru_ArrayList_T(u64) U64s;
+
+static void run_all(Yoru_ThreadPool *pool, Records *records, cstr pool_name, Yoru_Allocator *allocator) {
+  char name_buf[64] = {0};
+  u64  start        = 0;
+
+  start = yoru_bench_now_ns();
+  yoru_arraylist_parallel_for_each(pool, records, apply_fee, NULL);
+  snprintf(name_buf, sizeof(name_buf), "for_each, %s", pool_name);
+  YORU_BENCH_REPORT(name_buf, RECORD_COUNT, yoru_bench_now_ns() - start);
+
+  U64s amounts = {0};
+  yoru_arraylist_init(&amounts, allocator, RECORD_COUNT);
+  start = yoru_bench_now_ns();
+  yoru_arraylist_parallel_map(pool, records, &amounts, amounts_of, NULL);
+  snprintf(name_buf, sizeof(name_buf), "map, %s", pool_name);
+  YORU_BENCH_REPORT(name_buf, RECORD_COUNT, yoru_bench_now_ns() - start);
+
+  u64 sum = 0;
+  start   = yoru_bench_now_ns();
+  bool ok = yoru_arraylist_parallel_reduce(pool, &amounts, sum_u64s, 0, &sum, allocator);
+  assert(ok);
+  (void)ok;
+  snprintf(name_buf, sizeof(name_buf), "reduce, %s", pool_name);
+  YORU_BENCH_REPORT(name_buf, RECORD_COUNT, yoru_bench_now_ns() - start);
+  YORU_BENCH_DO_NOT_OPTIMIZE(sum);
+
+  Records kept = {0};
+  yoru_arraylist_init(&kept, allocator, RECORD_COUNT);
+  u32 kind = 3;
+  start    = yoru_bench_now_ns();
+  yoru_arraylist_parallel_filter(pool, records, &kept, filter_kind, &kind, allocator);
+  snprintf(name_buf, sizeof(name_buf), "filter, %s", pool_name);
+  YORU_BENCH_REPORT(name_buf, RECORD_COUNT, yoru_bench_now_ns() - start);
+  YORU_BENCH_DO_NOT_OPTIMIZE(kept.size);
+
+  yoru_allocator_dealloc(allocator, amounts.items);
+  yoru_allocator_dealloc(allocator, kept.items);
+  printf("\n");
+}
+
+int main() {
+  Yoru_GlobalAllocator global       = yoru_global_allocator_make();
+  usize                cpus         = yoru_get_cpu_count();
+  char                 name_buf[64] = {0};
+
+  Records records = {0};
+  yoru_arraylist_init(&records, &global, RECORD_COUNT);
+  u64 seed = 42;
+  for (usize i = 0; i < RECORD_COUNT; ++i) {
+    u64 r = yoru_bench_rand(&seed);
+    yoru_arraylist_append(&records, ((Record){.id = i, .kind = (u32)(r % 8), .amount = (u32)(r >> 32) % 100000}));
+  }
+
+  printf("%d records of %zu bytes, %zu cpus\n\n", RECORD_COUNT, sizeof(Record), cpus);
+  run_all(NULL, &records, "calling thread", &global);
+
+  for (usize threads = 1; threads <= cpus && threads <= MAX_THREADS; threads *= 2) {
+    Yoru_ThreadPool *pool = yoru_thread_pool_make(threads);
+    assert(pool);
+    snprintf(name_buf, sizeof(name_buf), "%zu threads", threads);
+    run_all(pool, &records, name_buf, &global);
+    yoru_thread_pool_destroy(pool);
+  }
+
+  yoru_allocator_dealloc(&global, records.items);
+  return 0;
+}
@@ -0,0 +1,125 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// a table of ENTRY_COUNT entries is either parsed from text and built from
+// scratch, or mapped back from a persistent arena that a previous run built
+#define ENTRY_COUNT (1000000)
+#define TABLE_CAPACITY (2 * 1024 * 1024) // power of two, load factor below 0.5
+#define LOOKUP_COUNT (1000)
+#define ARENA_PATH "yoru_persistent_arena_bench.bin"
+
+typedef struct Entry {
+  u64 key;
+  u64 value;
+} Entry;
+
+typedef struct Table {
+  usize  capacity;
+  usize  count;
+  Entry *entries;
+} Table;
+
+static u64 hash_u64(u64 x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  return x;
+}
+
+static void table_insert(Table *table, u64 key, u64 value) {
+  usize index = hash_u64(key) & (table->capacity - 1);
+  while (table->entries[index].key != 0 && table->entries[index].key != key)
+    index = (index + 1) & (table->capacity - 1);
+  table->count += table->entries[index].key == 0;
+  table->entries[index] = (Entry){.key = key, .value = value};
+}
+
+static u64 table_get(Table *table, u64 key) {
+  usize index = hash_u64(key) & (table->capacity - 1);
+  while (table->entries[index].key != 0) {
+    if (table->entries[index].key == key) return table->entries[index].value;
+    index = (index + 1) & (table->capacity - 1);
+  }
+  return 0;
+}
+
+/// parses "key value" lines into a table allocated from `allocator`
+static Table *table_build(Yoru_Allocator *allocator, const char *text) {
+  Yoru_Opt maybe_table   = yoru_allocator_alloc(allocator, sizeof(Table));
+  Yoru_Opt maybe_entries = yoru_allocator_alloc(allocator, TABLE_CAPACITY * sizeof(Entry));
+  assert(maybe_table.has_value && maybe_entries.has_value);
+  Table *table    = maybe_table.ptr;
+  table->capacity = TABLE_CAPACITY;
+  table->entries  = maybe_entries.ptr;
+
+  char *cursor = (char *)text;
+  while (*cursor) {
+    u64 key   = strtoull(cursor, &cursor, 10);
+    u64 value = strtoull(cursor, &cursor, 10);
+    table_insert(table, key, value);
+    ++cursor; // newline
+  }
+  return table;
+}
+
+static u64 lookup_some(Table *table) {
+  u64 sum = 0;
+  for (u64 i = 1; i <= LOOKUP_COUNT; ++i) sum += table_get(table, i * (ENTRY_COUNT / LOOKUP_COUNT));
+  return sum;
+}
+
+int main() {
+  // the source everything is rebuilt from, e.g. a config file that was read
+  usize text_size = (usize)ENTRY_COUNT * 32;
+  char *text      = malloc(text_size);
+  assert(text);
+  usize written = 0;
+  for (unsigned long long key = 1; key <= ENTRY_COUNT; ++key)
+    written += (usize)snprintf(text + written, text_size - written, "%llu %llu\n", key, key * 7);
+
+  printf("a table of %d entries, %d lookups after loading it\n\n", ENTRY_COUNT, LOOKUP_COUNT);
+
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  u64                  start  = yoru_bench_now_ns();
+  Table               *table  = table_build(&global, text);
+  u64                  sum    = lookup_some(table);
+  YORU_BENCH_REPORT("rebuild on the heap", 1, yoru_bench_now_ns() - start);
+  yoru_allocator_dealloc(&global, table->entries);
+  yoru_allocator_dealloc(&global, table);
+
+  // the first run builds the table in the arena file
+  remove(ARENA_PATH);
+  start = yoru_bench_now_ns();
+  Yoru_PersistentArenaAllocator *arena =
+      yoru_persistent_arena_allocator_open(ARENA_PATH, YORU_PERSISTENT_ARENA_DEFAULT_BASE, YORU_MiB(64));
+  assert(arena);
+  yoru_persistent_arena_allocator_set_root(arena, table_build(arena, text));
+  yoru_allocator_destroy(arena);
+  YORU_BENCH_REPORT("build + persist (first run)", 1, yoru_bench_now_ns() - start);
+
+  // every later run just maps it back
+  start = yoru_bench_now_ns();
+  arena = yoru_persistent_arena_allocator_open(ARENA_PATH, NULL, 0);
+  assert(arena);
+  table = yoru_persistent_arena_allocator_get_root(arena);
+  assert(table && table->count == ENTRY_COUNT);
+  bool same = lookup_some(table) == sum;
+  YORU_BENCH_REPORT("remap (warm start)", 1, yoru_bench_now_ns() - start);
+  assert(same);
+  (void)same;
+
+  // touching every entry faults in all pages of the table
+  start     = yoru_bench_now_ns();
+  u64 total = 0;
+  for (usize i = 0; i < table->capacity; ++i) total += table->entries[i].value;
+  YORU_BENCH_DO_NOT_OPTIMIZE(total);
+  YORU_BENCH_REPORT("full scan of the remapped table", 1, yoru_bench_now_ns() - start);
+
+  yoru_allocator_destroy(arena);
+  remove(ARENA_PATH);
+  free(text);
+  return 0;
+}
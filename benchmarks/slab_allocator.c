@@ -0,0 +1,51 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// mixed workload: keep LIVE_SLOTS objects of 16-512 bytes alive and keep
+// replacing random ones, which is what long-running services look like
+#define LIVE_SLOTS (4096)
+#define ITERATIONS (20000000)
+#define MIN_SIZE (16)
+#define MAX_SIZE (512)
+
+static u64 run_mixed_workload(Yoru_Allocator *allocator) {
+  static anyptr slots[LIVE_SLOTS];
+  u64           rng = 0x9E3779B97F4A7C15ull;
+  memset(slots, 0, sizeof(slots));
+
+  u64 start = yoru_bench_now_ns();
+  for (usize i = 0; i < ITERATIONS; ++i) {
+    u64   r    = yoru_bench_rand(&rng);
+    usize slot = r % LIVE_SLOTS;
+    usize size = MIN_SIZE + (r >> 32) % (MAX_SIZE - MIN_SIZE + 1);
+
+    if (slots[slot]) yoru_allocator_dealloc(allocator, slots[slot]);
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc(allocator, size);
+    assert(maybe_ptr.has_value);
+    slots[slot]            = maybe_ptr.ptr;
+    ((u8 *)slots[slot])[0] = (u8)i;
+  }
+  u64 elapsed = yoru_bench_now_ns() - start;
+
+  for (usize i = 0; i < LIVE_SLOTS; ++i) {
+    if (slots[i]) yoru_allocator_dealloc(allocator, slots[i]);
+  }
+  return elapsed;
+}
+
+int main() {
+  printf(
+      "mixed %d-%d byte workload, %d live objects, %d alloc/free pairs\n\n", MIN_SIZE, MAX_SIZE, LIVE_SLOTS, ITERATIONS);
+
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  YORU_BENCH_REPORT("global allocator", ITERATIONS, run_mixed_workload(&global));
+
+  Yoru_SlabAllocator *slab = yoru_slab_allocator_make(YORU_GiB(1));
+  assert(slab);
+  YORU_BENCH_REPORT("slab allocator", ITERATIONS, run_mixed_workload(slab));
+  yoru_allocator_destroy(slab);
+  return 0;
+}
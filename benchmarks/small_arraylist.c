@@ -0,0 +1,72 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// splits LINE_COUNT lines of FIELD_COUNT fields into a fresh list each, like a
+// tokenizer that returns the fields of a line
+#define LINE_COUNT (5000000)
+#define FIELD_COUNT (5)
+
+typedef struct Field {
+  const char *data;
+  usize       length;
+} Field;
+
+static const char line[] = "id,name,kind,value,comment";
+
+static u64 split_arraylist(Yoru_Allocator *allocator) {
+  u64 start = yoru_bench_now_ns();
+
+  usize total = 0;
+  for (usize i = 0; i < LINE_COUNT; ++i) {
+    Yoru_ArrayList_T(Field) fields = {0};
+    yoru_arraylist_init(&fields, allocator, 8);
+    usize field_start = 0;
+    for (usize j = 0; j <= sizeof(line) - 1; ++j) {
+      if (j == sizeof(line) - 1 || line[j] == ',') {
+        yoru_arraylist_append(&fields, ((Field){.data = line + field_start, .length = j - field_start}));
+        field_start = j + 1;
+      }
+    }
+    assert(fields.size == FIELD_COUNT);
+    total += fields.items[FIELD_COUNT - 1].length;
+    yoru_allocator_dealloc(allocator, fields.items);
+  }
+  YORU_BENCH_DO_NOT_OPTIMIZE(total);
+
+  return yoru_bench_now_ns() - start;
+}
+
+static u64 split_small_arraylist(Yoru_Allocator *allocator) {
+  u64 start = yoru_bench_now_ns();
+
+  usize total = 0;
+  for (usize i = 0; i < LINE_COUNT; ++i) {
+    Yoru_SmallArrayList_T(Field, 8) fields;
+    yoru_small_arraylist_init(&fields, allocator);
+    usize field_start = 0;
+    for (usize j = 0; j <= sizeof(line) - 1; ++j) {
+      if (j == sizeof(line) - 1 || line[j] == ',') {
+        yoru_small_arraylist_append(&fields, ((Field){.data = line + field_start, .length = j - field_start}));
+        field_start = j + 1;
+      }
+    }
+    assert(fields.size == FIELD_COUNT);
+    total += yoru_small_arraylist_items(&fields)[FIELD_COUNT - 1].length;
+    yoru_small_arraylist_destroy(&fields);
+  }
+  YORU_BENCH_DO_NOT_OPTIMIZE(total);
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  printf("splitting %d lines into %d fields\n\n", LINE_COUNT, FIELD_COUNT);
+
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  YORU_BENCH_REPORT("arraylist", LINE_COUNT, split_arraylist(&global));
+  YORU_BENCH_REPORT("small arraylist, 8 inline", LINE_COUNT, split_small_arraylist(&global));
+  return 0;
+}
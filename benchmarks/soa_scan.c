@@ -0,0 +1,79 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// sums the amount of every record of one kind, over ROW_COUNT 64 byte records
+// stored as an ArrayList of structs vs a struct of arrays
+#define ROW_COUNT (10000000)
+#define ROUNDS (10)
+
+typedef struct Record {
+  u64 id;
+  u64 timestamp;
+  u32 kind;
+  u32 amount;
+  u64 owner;
+  u8  tag[32];
+} Record;
+
+#define RECORD_FIELDS(X) X(u64, id) X(u64, timestamp) X(u32, kind) X(u32, amount) X(u64, owner)
+YORU_SOA_DEFINE(Records, records, RECORD_FIELDS)
+
+static u64 scan_aos(const Record *rows, usize count, u64 *out_sum) {
+  u64 start = yoru_bench_now_ns();
+
+  u64 sum = 0;
+  for (usize round = 0; round < ROUNDS; ++round) {
+    for (usize i = 0; i < count; ++i) sum += rows[i].kind == 3 ? rows[i].amount : 0;
+  }
+  *out_sum = sum;
+
+  return yoru_bench_now_ns() - start;
+}
+
+static u64 scan_soa(const Records *records, u64 *out_sum) {
+  u64 start = yoru_bench_now_ns();
+
+  u64 sum = 0;
+  for (usize round = 0; round < ROUNDS; ++round) {
+    for (usize i = 0; i < records->size; ++i) sum += records->kind[i] == 3 ? records->amount[i] : 0;
+  }
+  *out_sum = sum;
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+
+  Yoru_ArrayList_T(Record) aos = {0};
+  Records soa                  = {0};
+  yoru_arraylist_init(&aos, &global, ROW_COUNT);
+  bool ok = records_init(&soa, &global, ROW_COUNT);
+  assert(ok);
+  (void)ok;
+
+  u64 seed = 42;
+  for (u64 i = 0; i < ROW_COUNT; ++i) {
+    u32    kind   = (u32)(yoru_bench_rand(&seed) % 8);
+    u32    amount = (u32)(i % 100);
+    Record row    = {.id = i, .timestamp = i * 1000, .kind = kind, .amount = amount, .owner = i / 16};
+    yoru_arraylist_append(&aos, row);
+    records_append(&soa, (RecordsRow){.id = i, .timestamp = i * 1000, .kind = kind, .amount = amount, .owner = i / 16});
+  }
+
+  u64 aos_sum = 0;
+  u64 soa_sum = 0;
+  printf("summing one field of %d %zu byte records where kind == 3, %d times\n\n", ROW_COUNT, sizeof(Record), ROUNDS);
+  YORU_BENCH_REPORT("array of structs", (u64)ROW_COUNT * ROUNDS, scan_aos(aos.items, aos.size, &aos_sum));
+  YORU_BENCH_REPORT("struct of arrays", (u64)ROW_COUNT * ROUNDS, scan_soa(&soa, &soa_sum));
+  assert(aos_sum == soa_sum);
+  YORU_BENCH_DO_NOT_OPTIMIZE(aos_sum);
+  YORU_BENCH_DO_NOT_OPTIMIZE(soa_sum);
+
+  yoru_allocator_dealloc(&global, aos.items);
+  records_destroy(&soa);
+  return 0;
+}
@@ -0,0 +1,103 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// sorts ELEMENT_COUNT random u64s and ELEMENT_COUNT 24 byte records by a u64
+// key with qsort, the generated introsort and the generated radix sort
+#define ELEMENT_COUNT (10000000)
+
+typedef struct Record {
+  u64 key;
+  u64 id;
+  f64 value;
+} Record;
+
+#define U64_LESS(a, b) ((a) < (b))
+#define U64_KEY(x) (x)
+YORU_SORT_DEFINE(u64s, u64, U64_LESS)
+YORU_RADIX_SORT_DEFINE(u64s, u64, U64_KEY)
+
+#define RECORD_LESS(a, b) ((a).key < (b).key)
+#define RECORD_KEY(x) ((x).key)
+YORU_SORT_DEFINE(records, Record, RECORD_LESS)
+YORU_RADIX_SORT_DEFINE(records, Record, RECORD_KEY)
+
+static int compare_u64(const void *a, const void *b) {
+  u64 x = *(const u64 *)a;
+  u64 y = *(const u64 *)b;
+  return (x > y) - (x < y);
+}
+
+static int compare_record(const void *a, const void *b) {
+  u64 x = ((const Record *)a)->key;
+  u64 y = ((const Record *)b)->key;
+  return (x > y) - (x < y);
+}
+
+typedef enum { QSORT, INTROSORT, RADIX_SORT } SortKind;
+
+static u64 sort_u64s(const u64 *input, u64 *items, SortKind kind, Yoru_Allocator *allocator) {
+  memcpy(items, input, ELEMENT_COUNT * sizeof(u64));
+  u64 start = yoru_bench_now_ns();
+  if (kind == QSORT) qsort(items, ELEMENT_COUNT, sizeof(u64), compare_u64);
+  if (kind == INTROSORT) u64s_sort(items, ELEMENT_COUNT);
+  if (kind == RADIX_SORT) {
+    bool ok = u64s_radix_sort(items, ELEMENT_COUNT, allocator);
+    assert(ok);
+    (void)ok;
+  }
+  u64 elapsed = yoru_bench_now_ns() - start;
+  for (usize i = 1; i < ELEMENT_COUNT; ++i) assert(items[i - 1] <= items[i]);
+  return elapsed;
+}
+
+static u64 sort_records(const Record *input, Record *items, SortKind kind, Yoru_Allocator *allocator) {
+  memcpy(items, input, ELEMENT_COUNT * sizeof(Record));
+  u64 start = yoru_bench_now_ns();
+  if (kind == QSORT) qsort(items, ELEMENT_COUNT, sizeof(Record), compare_record);
+  if (kind == INTROSORT) records_sort(items, ELEMENT_COUNT);
+  if (kind == RADIX_SORT) {
+    bool ok = records_radix_sort(items, ELEMENT_COUNT, allocator);
+    assert(ok);
+    (void)ok;
+  }
+  u64 elapsed = yoru_bench_now_ns() - start;
+  for (usize i = 1; i < ELEMENT_COUNT; ++i) assert(items[i - 1].key <= items[i].key);
+  return elapsed;
+}
+
+int main() {
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+
+  u64    *u64_input    = malloc(ELEMENT_COUNT * sizeof(u64));
+  u64    *u64_items    = malloc(ELEMENT_COUNT * sizeof(u64));
+  Record *record_input = malloc(ELEMENT_COUNT * sizeof(Record));
+  Record *record_items = malloc(ELEMENT_COUNT * sizeof(Record));
+  assert(u64_input && u64_items && record_input && record_items);
+
+  u64 seed = 42;
+  for (usize i = 0; i < ELEMENT_COUNT; ++i) {
+    u64_input[i]    = yoru_bench_rand(&seed);
+    record_input[i] = (Record){.key = yoru_bench_rand(&seed), .id = i, .value = (f64)i};
+  }
+
+  printf("sorting %d random elements\n\n", ELEMENT_COUNT);
+  YORU_BENCH_REPORT("u64, qsort", ELEMENT_COUNT, sort_u64s(u64_input, u64_items, QSORT, &global));
+  YORU_BENCH_REPORT("u64, introsort", ELEMENT_COUNT, sort_u64s(u64_input, u64_items, INTROSORT, &global));
+  YORU_BENCH_REPORT("u64, radix sort", ELEMENT_COUNT, sort_u64s(u64_input, u64_items, RADIX_SORT, &global));
+  printf("\n");
+  YORU_BENCH_REPORT("record, qsort", ELEMENT_COUNT, sort_records(record_input, record_items, QSORT, &global));
+  YORU_BENCH_REPORT("record, introsort", ELEMENT_COUNT, sort_records(record_input, record_items, INTROSORT, &global));
+  YORU_BENCH_REPORT(
+      "record, radix sort",
+      ELEMENT_COUNT,
+      sort_records(record_input, record_items, RADIX_SORT, &global));
+
+  free(u64_input);
+  free(u64_items);
+  free(record_input);
+  free(record_items);
+  return 0;
+}
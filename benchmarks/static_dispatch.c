@@ -0,0 +1,72 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// ALLOC_COUNT allocations of ALLOC_SIZE bytes from an arena that is reset
+// every RESET_EVERY allocations, through the vtable and the inlined fast path
+#define ALLOC_COUNT (100000000)
+#define ALLOC_SIZE (16)
+#define RESET_EVERY (1000000)
+#define APPEND_COUNT (10000000)
+
+static u64 alloc_dynamic(Yoru_ArenaAllocator *arena) {
+  u64 start = yoru_bench_now_ns();
+  for (usize i = 0; i < ALLOC_COUNT; ++i) {
+    if (i % RESET_EVERY == 0) yoru_arena_allocator_reset(arena);
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc_uninit(arena, ALLOC_SIZE);
+    YORU_BENCH_DO_NOT_OPTIMIZE(maybe_ptr.ptr);
+  }
+  return yoru_bench_now_ns() - start;
+}
+
+static u64 alloc_static(Yoru_ArenaAllocator *arena) {
+  u64 start = yoru_bench_now_ns();
+  for (usize i = 0; i < ALLOC_COUNT; ++i) {
+    if (i % RESET_EVERY == 0) yoru_arena_allocator_reset(arena);
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc_uninit_with(arena, arena, ALLOC_SIZE);
+    YORU_BENCH_DO_NOT_OPTIMIZE(maybe_ptr.ptr);
+  }
+  return yoru_bench_now_ns() - start;
+}
+
+static u64 append_dynamic(Yoru_ArenaAllocator *arena) {
+  yoru_arena_allocator_reset(arena);
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_ArrayList_T(i32) list = {0};
+  yoru_arraylist_init(&list, arena, 0);
+  for (i32 i = 0; i < APPEND_COUNT; ++i) yoru_arraylist_append(&list, i);
+  YORU_BENCH_DO_NOT_OPTIMIZE(list.items[list.size - 1]);
+
+  return yoru_bench_now_ns() - start;
+}
+
+static u64 append_static(Yoru_ArenaAllocator *arena) {
+  yoru_arena_allocator_reset(arena);
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_ArrayList_T(i32) list = {0};
+  yoru_arraylist_init_with(arena, &list, arena, 0);
+  for (i32 i = 0; i < APPEND_COUNT; ++i) yoru_arraylist_append_with(arena, &list, i);
+  YORU_BENCH_DO_NOT_OPTIMIZE(list.items[list.size - 1]);
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  Yoru_ArenaAllocator *arena = yoru_arena_allocator_make(YORU_MiB(128));
+  assert(arena);
+
+  printf("%d arena allocations of %d bytes\n\n", ALLOC_COUNT, ALLOC_SIZE);
+  YORU_BENCH_REPORT("vtable", ALLOC_COUNT, alloc_dynamic(arena));
+  YORU_BENCH_REPORT("static dispatch", ALLOC_COUNT, alloc_static(arena));
+
+  printf("\nappending %d ints to an arraylist in an arena\n\n", APPEND_COUNT);
+  YORU_BENCH_REPORT("vtable", APPEND_COUNT, append_dynamic(arena));
+  YORU_BENCH_REPORT("static dispatch", APPEND_COUNT, append_static(arena));
+
+  yoru_allocator_destroy(arena);
+  return 0;
+}
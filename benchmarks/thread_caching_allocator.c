@@ -0,0 +1,93 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// every thread keeps LIVE_SLOTS objects of 16-512 bytes alive and keeps
+// replacing random ones
+#define LIVE_SLOTS (1024)
+#define ITERATIONS_PER_THREAD (5000000)
+#define MIN_SIZE (16)
+#define MAX_SIZE (512)
+
+typedef struct {
+  Yoru_Allocator *allocator;
+  u64             seed;
+} Worker;
+
+static void worker_run(anyptr arg) {
+  Worker *worker = arg;
+  anyptr *slots  = calloc(LIVE_SLOTS, sizeof(anyptr));
+  u64     rng    = worker->seed;
+  assert(slots);
+
+  for (usize i = 0; i < ITERATIONS_PER_THREAD; ++i) {
+    u64   r    = yoru_bench_rand(&rng);
+    usize slot = r % LIVE_SLOTS;
+    usize size = MIN_SIZE + (r >> 32) % (MAX_SIZE - MIN_SIZE + 1);
+
+    if (slots[slot]) yoru_allocator_dealloc(worker->allocator, slots[slot]);
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc(worker->allocator, size);
+    assert(maybe_ptr.has_value);
+    slots[slot]            = maybe_ptr.ptr;
+    ((u8 *)slots[slot])[0] = (u8)i;
+  }
+
+  for (usize i = 0; i < LIVE_SLOTS; ++i) {
+    if (slots[i]) yoru_allocator_dealloc(worker->allocator, slots[i]);
+  }
+  free(slots);
+}
+
+static u64 run_threads(Yoru_Allocator *allocator, usize thread_count) {
+  Yoru_Thread *threads = calloc(thread_count, sizeof(Yoru_Thread));
+  Worker      *workers = calloc(thread_count, sizeof(Worker));
+  assert(threads && workers);
+
+  u64 start = yoru_bench_now_ns();
+  for (usize i = 0; i < thread_count; ++i) {
+    workers[i] = (Worker){.allocator = allocator, .seed = 0x9E3779B97F4A7C15ull * (i + 1)};
+    bool spawned = yoru_thread_spawn(&threads[i], worker_run, &workers[i]);
+    assert(spawned);
+    (void)spawned;
+  }
+  for (usize i = 0; i < thread_count; ++i) {
+    bool joined = yoru_thread_join(&threads[i]);
+    assert(joined);
+    (void)joined;
+  }
+  u64 elapsed = yoru_bench_now_ns() - start;
+
+  free(threads);
+  free(workers);
+  return elapsed;
+}
+
+int main() {
+  usize max_threads = yoru_get_cpu_count();
+  printf(
+      "%d alloc/free pairs of %d-%d bytes per thread, 1..%zu threads\n\n",
+      ITERATIONS_PER_THREAD,
+      MIN_SIZE,
+      MAX_SIZE,
+      max_threads);
+  printf("%-10s %20s %20s\n", "threads", "global Mops/s", "tcache Mops/s");
+
+  for (usize threads = 1;; threads *= 2) {
+    if (threads > max_threads) threads = max_threads;
+    f64 ops = (f64)threads * ITERATIONS_PER_THREAD;
+
+    Yoru_GlobalAllocator global         = yoru_global_allocator_make();
+    u64                  global_elapsed = run_threads(&global, threads);
+
+    Yoru_ThreadCachingAllocator *tcache = yoru_thread_caching_allocator_make(YORU_GiB(1));
+    assert(tcache);
+    u64 tcache_elapsed = run_threads(tcache, threads);
+    yoru_allocator_destroy(tcache);
+
+    printf("%-10zu %20.2f %20.2f\n", threads, ops / (f64)global_elapsed * 1e3, ops / (f64)tcache_elapsed * 1e3);
+    if (threads == max_threads) break;
+  }
+  return 0;
+}
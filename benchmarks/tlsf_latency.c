@@ -0,0 +1,103 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// LIVE_COUNT blocks of random sizes stay alive while OP_COUNT times a random
+// one is freed and replaced by a block of another size, which fragments the
+// heap. Every alloc and free is timed on its own
+#define OP_COUNT (1000000)
+#define LIVE_COUNT (10000)
+#define MIN_SIZE (16)
+#define MAX_SIZE (4096)
+#define REGION_SIZE (YORU_MiB(256))
+
+static u64 alloc_ns[OP_COUNT];
+static u64 free_ns[OP_COUNT];
+
+static int compare_u64(const void *a, const void *b) {
+  u64 x = *(const u64 *)a;
+  u64 y = *(const u64 *)b;
+  return (x > y) - (x < y);
+}
+
+static usize random_size(u64 *state) {
+  // mostly small blocks with the odd large one
+  u64 r = yoru_bench_rand(state);
+  if (r % 16 == 0) return MIN_SIZE + (usize)(r >> 8) % (16 * MAX_SIZE);
+  return MIN_SIZE + (usize)(r >> 8) % MAX_SIZE;
+}
+
+static void report_percentiles(cstr name, u64 *samples) {
+  qsort(samples, OP_COUNT, sizeof(u64), compare_u64);
+  printf(
+      "%-32s p50 %6llu ns  p99 %6llu ns  p99.9 %6llu ns  max %8llu ns\n",
+      name,
+      (unsigned long long)samples[OP_COUNT / 2],
+      (unsigned long long)samples[OP_COUNT / 100 * 99],
+      (unsigned long long)samples[OP_COUNT / 1000 * 999],
+      (unsigned long long)samples[OP_COUNT - 1]);
+}
+
+static void run_workload(cstr name, Yoru_Allocator *allocator) {
+  static anyptr live[LIVE_COUNT];
+  u64           state = 0x9E3779B97F4A7C15ull;
+
+  for (usize i = 0; i < LIVE_COUNT; ++i) {
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc_uninit(allocator, random_size(&state));
+    assert(maybe_ptr.has_value);
+    live[i] = maybe_ptr.ptr;
+  }
+
+  for (usize i = 0; i < OP_COUNT; ++i) {
+    usize slot = (usize)yoru_bench_rand(&state) % LIVE_COUNT;
+    usize size = random_size(&state);
+
+    u64 start = yoru_bench_now_ns();
+    yoru_allocator_dealloc(allocator, live[slot]);
+    u64      freed     = yoru_bench_now_ns();
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc_uninit(allocator, size);
+    u64      allocated = yoru_bench_now_ns();
+
+    assert(maybe_ptr.has_value);
+    live[slot]            = maybe_ptr.ptr;
+    ((u8 *)live[slot])[0] = (u8)i;
+    free_ns[i]            = freed - start;
+    alloc_ns[i]           = allocated - freed;
+  }
+
+  for (usize i = 0; i < LIVE_COUNT; ++i) yoru_allocator_dealloc(allocator, live[i]);
+
+  char name_buf[64] = {0};
+  snprintf(name_buf, sizeof(name_buf), "%s alloc", name);
+  report_percentiles(name_buf, alloc_ns);
+  snprintf(name_buf, sizeof(name_buf), "%s free", name);
+  report_percentiles(name_buf, free_ns);
+}
+
+int main() {
+  printf(
+      "%d frees + allocs of %d..%d bytes with %d live blocks, timer overhead included\n\n",
+      OP_COUNT,
+      MIN_SIZE,
+      16 * MAX_SIZE,
+      LIVE_COUNT);
+
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  run_workload("global", &global);
+
+  // commit everything up front so no alloc has to wait for a syscall
+  Yoru_Vmem_Ctx vm = {0};
+  bool          ok = yoru_vmem_reserve(REGION_SIZE, &vm) && yoru_vmem_commit(&vm, REGION_SIZE);
+  assert(ok);
+  (void)ok;
+  memset(vm.base, 0, REGION_SIZE);
+
+  Yoru_TlsfAllocator *tlsf = yoru_tlsf_allocator_make_from_vmem(&vm);
+  assert(tlsf);
+  run_workload("tlsf", tlsf);
+  yoru_allocator_destroy(tlsf);
+  yoru_vmem_free(&vm);
+  return 0;
+}
@@ -0,0 +1,54 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// time to fill an arena with CHUNK_SIZE allocations while touching every
+// page, for committing one page at a time vs the geometric policy
+#define CHUNK_SIZE (YORU_KiB(16))
+
+static u64 fill_arena(Yoru_VirtualArenaOptions options, usize fill_size) {
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_VirtualArenaAllocator *arena = yoru_virtual_arena_allocator_make_with_options(fill_size, options);
+  assert(arena);
+  usize page_size = yoru_get_page_size();
+  for (usize filled = 0; filled + CHUNK_SIZE <= fill_size; filled += CHUNK_SIZE) {
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc(arena, CHUNK_SIZE);
+    assert(maybe_ptr.has_value);
+    for (usize i = 0; i < CHUNK_SIZE; i += page_size) ((u8 *)maybe_ptr.ptr)[i] = (u8)i;
+  }
+  yoru_allocator_destroy(arena);
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  usize page_size    = yoru_get_page_size();
+  usize fill_sizes[] = {YORU_MiB(1), YORU_MiB(100), YORU_GiB(1)};
+  cstr  fill_names[] = {"1 MiB", "100 MiB", "1 GiB"};
+  usize fill_count   = sizeof(fill_sizes) / sizeof(fill_sizes[0]);
+  char  name_buf[64] = {0};
+
+  Yoru_VirtualArenaOptions per_page  = {.min_commit_size = page_size, .max_commit_size = page_size};
+  Yoru_VirtualArenaOptions geometric = {0};
+  Yoru_VirtualArenaOptions thp       = {.vmem_flags = YORU_VMEM_TRANSPARENT_HUGE_PAGES};
+
+  printf("filling arenas with %zu byte allocations, page size %zu\n\n", (usize)CHUNK_SIZE, page_size);
+
+  for (usize i = 0; i < fill_count; ++i) {
+    usize ops = fill_sizes[i] / CHUNK_SIZE;
+
+    snprintf(name_buf, sizeof(name_buf), "%s, commit per page", fill_names[i]);
+    YORU_BENCH_REPORT(name_buf, ops, fill_arena(per_page, fill_sizes[i]));
+
+    snprintf(name_buf, sizeof(name_buf), "%s, geometric commit", fill_names[i]);
+    YORU_BENCH_REPORT(name_buf, ops, fill_arena(geometric, fill_sizes[i]));
+
+    snprintf(name_buf, sizeof(name_buf), "%s, geometric commit + THP", fill_names[i]);
+    YORU_BENCH_REPORT(name_buf, ops, fill_arena(thp, fill_sizes[i]));
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+#define YORU_IMPL
+#include "../yoru.h"
+#include "yoru_bench_helpers.h"
+
+#include <assert.h>
+
+// appends APPEND_COUNT u64s (512 MiB) to a list that starts out empty
+#define APPEND_COUNT (64ull * 1024 * 1024)
+
+/* realloc that always moves the block like a general purpose allocator
+   without mremap would, keeping the old block alive during the copy */
+static Yoru_Opt copying_alloc(anyptr ctx, usize size) {
+  (void)ctx;
+  anyptr ptr = malloc(size);
+  if (!ptr) return yoru_opt_none();
+  return yoru_opt_some(ptr);
+}
+
+static Yoru_Opt copying_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  (void)alignment;
+  return copying_alloc(ctx, size);
+}
+
+static void copying_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  free(ptr);
+}
+
+static Yoru_Opt copying_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  Yoru_Opt maybe_new_ptr = copying_alloc(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  free(old_ptr);
+  return maybe_new_ptr;
+}
+
+static void copying_destroy(anyptr ctx) {
+  (void)ctx;
+}
+
+static const Yoru_AllocatorVTable copying_vtable = {
+    .alloc         = copying_alloc,
+    .alloc_uninit  = copying_alloc,
+    .alloc_aligned = copying_alloc_aligned,
+    .dealloc       = copying_dealloc,
+    .realloc       = copying_realloc,
+    .destroy       = copying_destroy,
+};
+
+static u64 append_arraylist(Yoru_Allocator *allocator) {
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_ArrayList_T(u64) list = {0};
+  yoru_arraylist_init(&list, allocator, 0);
+  for (u64 i = 0; i < APPEND_COUNT; ++i) {
+    yoru_arraylist_append(&list, i);
+  }
+  YORU_BENCH_DO_NOT_OPTIMIZE(list.items[list.size - 1]);
+  yoru_allocator_dealloc(allocator, list.items);
+
+  return yoru_bench_now_ns() - start;
+}
+
+static u64 append_virtual_arraylist() {
+  u64 start = yoru_bench_now_ns();
+
+  Yoru_VirtualArrayList_T(u64) list = {0};
+  yoru_virtual_arraylist_init(&list, YORU_GiB(16) / sizeof(u64));
+  for (u64 i = 0; i < APPEND_COUNT; ++i) {
+    yoru_virtual_arraylist_append(&list, i);
+  }
+  YORU_BENCH_DO_NOT_OPTIMIZE(list.items[list.size - 1]);
+  yoru_virtual_arraylist_destroy(&list);
+
+  return yoru_bench_now_ns() - start;
+}
+
+int main() {
+  printf("appending %llu u64s\n\n", APPEND_COUNT);
+
+  Yoru_Allocator copying = {.vtable = &copying_vtable, .ctx = NULL};
+  YORU_BENCH_REPORT("arraylist, malloc + memcpy realloc", APPEND_COUNT, append_arraylist(&copying));
+
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  YORU_BENCH_REPORT("arraylist, global allocator", APPEND_COUNT, append_arraylist(&global));
+
+  YORU_BENCH_REPORT("virtual arraylist, 16 GiB reserved", APPEND_COUNT, append_virtual_arraylist());
+  return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef __YORU_BENCH_HELPERS_H__
+#define __YORU_BENCH_HELPERS_H__
+
+#include "../yoru.h"
+#include <stdio.h>
+#include <time.h>
+
+/* ============================================================
+   Timing
+   ============================================================ */
+
+static inline u64 yoru_bench_now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+#define YORU_BENCH_REPORT(name, ops, elapsed_ns)                                                                       \
+  do {                                                                                                                 \
+    f64 _ns = (f64)(elapsed_ns);                                                                                       \
+    printf("%-40s %10.2f ms %10.2f ns/op\n", (name), _ns / 1e6, _ns / (f64)(ops));                                     \
+  } while (0)
+
+/* ============================================================
+   Helpers
+   ============================================================ */
+
+/// xorshift64, good enough to generate workloads
+static inline u64 yoru_bench_rand(u64 *state) {
+  u64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return x;
+}
+
+/// keeps the compiler from optimizing away a value
+#define YORU_BENCH_DO_NOT_OPTIMIZE(value) __asm__ volatile("" : : "r"(value) : "memory")
+
+#endif
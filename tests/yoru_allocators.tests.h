@@ -0,0 +1,1411 @@
+#ifndef __YORU_ALLOCATORS_TESTS_H__
+#define __YORU_ALLOCATORS_TESTS_H__
+
+#include "../yoru.h"
+#include "yoru_test_helpers.h"
+
+#if !defined(_WIN32)
+#  include <sys/wait.h>
+#endif
+
+/* ============================================================
+   MODULE: Allocators
+   ============================================================ */
+
+static bool expect_aligned_allocations(Yoru_Allocator *allocator) {
+  usize alignments[] = {1, 8, 16, 32, 64, 4096};
+  for (usize i = 0; i < sizeof(alignments) / sizeof(alignments[0]); ++i) {
+    // a single byte first, so the next allocation starts misaligned
+    YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, 1).has_value);
+
+    Yoru_Opt a = yoru_allocator_alloc(allocator, sizeof(u64));
+    YORU_EXPECT_TRUE(a.has_value);
+    YORU_EXPECT_EQ_USIZE(0, (usize)a.ptr % YORU_DEFAULT_ALIGNMENT);
+
+    Yoru_Opt b = yoru_allocator_alloc_aligned(allocator, 100, alignments[i]);
+    YORU_EXPECT_TRUE(b.has_value);
+    YORU_EXPECT_EQ_USIZE(0, (usize)b.ptr % alignments[i]);
+
+    // bigger than any size class of the slab allocators
+    Yoru_Opt c = yoru_allocator_alloc_aligned(allocator, 5000, alignments[i]);
+    YORU_EXPECT_TRUE(c.has_value);
+    YORU_EXPECT_EQ_USIZE(0, (usize)c.ptr % alignments[i]);
+  }
+  return true;
+
+err:
+  return false;
+}
+
+bool yoru_allocators_alloc_aligned_test() {
+  Yoru_GlobalAllocator        global  = yoru_global_allocator_make();
+  Yoru_ArenaAllocator        *arena   = yoru_arena_allocator_make(YORU_KiB(64));
+  Yoru_VirtualArenaAllocator *varena  = yoru_virtual_arena_allocator_make(YORU_KiB(64));
+  Yoru_SlabAllocator         *slab    = yoru_slab_allocator_make(YORU_KiB(64));
+  Yoru_Allocator             *tcache  = yoru_thread_caching_allocator_make(YORU_KiB(64));
+  bool                        success = arena && varena && slab && tcache;
+
+  // the global allocator leaks here, which is fine for a test
+  success = success && expect_aligned_allocations(&global);
+  success = success && expect_aligned_allocations(arena);
+  success = success && expect_aligned_allocations(varena);
+  success = success && expect_aligned_allocations(slab);
+  success = success && expect_aligned_allocations(tcache);
+
+  if (arena) yoru_allocator_destroy(arena);
+  if (varena) yoru_allocator_destroy(varena);
+  if (slab) yoru_allocator_destroy(slab);
+  if (tcache) yoru_allocator_destroy(tcache);
+  return success;
+}
+
+static Yoru_Opt minimal_vtable_alloc(anyptr ctx, usize size) {
+  (void)ctx;
+  anyptr ptr = calloc(1, size);
+  return ptr ? yoru_opt_some(ptr) : yoru_opt_none();
+}
+
+static void minimal_vtable_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  free(ptr);
+}
+
+static Yoru_Opt minimal_vtable_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  (void)ctx;
+  (void)old_size;
+  anyptr ptr = realloc(old_ptr, new_size);
+  return ptr ? yoru_opt_some(ptr) : yoru_opt_none();
+}
+
+static void minimal_vtable_destroy(anyptr ctx) {
+  (void)ctx;
+}
+
+bool yoru_allocators_optional_vtable_slots_test() {
+  // a user allocator that leaves alloc_uninit and alloc_aligned out
+  static const Yoru_AllocatorVTable vtable = {
+      .alloc   = minimal_vtable_alloc,
+      .dealloc = minimal_vtable_dealloc,
+      .realloc = minimal_vtable_realloc,
+      .destroy = minimal_vtable_destroy,
+  };
+  Yoru_Allocator allocator = {.vtable = &vtable, .ctx = NULL};
+
+  Yoru_Opt a = yoru_allocator_alloc_uninit(&allocator, 64);
+  YORU_EXPECT_TRUE(a.has_value);
+  YORU_EXPECT_EQ_USIZE(0, ((u8 *)a.ptr)[63]);
+  Yoru_Opt b = yoru_allocator_alloc_aligned(&allocator, 64, YORU_DEFAULT_ALIGNMENT);
+  YORU_EXPECT_TRUE(b.has_value);
+  YORU_EXPECT_EQ_USIZE(0, (usize)b.ptr % YORU_DEFAULT_ALIGNMENT);
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc_aligned(&allocator, 64, 4096).has_value);
+
+  yoru_allocator_dealloc(&allocator, a.ptr);
+  yoru_allocator_dealloc(&allocator, b.ptr);
+  yoru_allocator_destroy(&allocator);
+  return true;
+
+err:
+  return false;
+}
+
+static bool expect_realloc_keeps_contents(Yoru_Allocator *allocator) {
+  u8 pattern[100] = {0};
+  for (usize i = 0; i < sizeof(pattern); ++i) pattern[i] = (u8)(i + 1);
+
+  Yoru_Opt a = yoru_allocator_alloc_uninit(allocator, sizeof(pattern));
+  YORU_EXPECT_TRUE(a.has_value);
+  memcpy(a.ptr, pattern, sizeof(pattern));
+
+  // big enough to move the block to another size class or to the global heap
+  Yoru_Opt b = yoru_allocator_realloc(allocator, sizeof(pattern), a.ptr, YORU_KiB(8));
+  YORU_EXPECT_TRUE(b.has_value);
+  YORU_EXPECT_EQ_MEM(pattern, b.ptr, sizeof(pattern));
+
+  Yoru_Opt c = yoru_allocator_realloc(allocator, YORU_KiB(8), b.ptr, YORU_KiB(64));
+  YORU_EXPECT_TRUE(c.has_value);
+  YORU_EXPECT_EQ_MEM(pattern, c.ptr, sizeof(pattern));
+
+  Yoru_Opt d = yoru_allocator_realloc(allocator, YORU_KiB(64), c.ptr, 10);
+  YORU_EXPECT_TRUE(d.has_value);
+  YORU_EXPECT_EQ_MEM(pattern, d.ptr, 10);
+  yoru_allocator_dealloc(allocator, d.ptr);
+  return true;
+
+err:
+  return false;
+}
+
+bool yoru_allocators_realloc_test() {
+  Yoru_GlobalAllocator        global  = yoru_global_allocator_make();
+  Yoru_ArenaAllocator        *arena   = yoru_arena_allocator_make(YORU_KiB(256));
+  Yoru_VirtualArenaAllocator *varena  = yoru_virtual_arena_allocator_make(YORU_KiB(256));
+  Yoru_SlabAllocator         *slab    = yoru_slab_allocator_make(YORU_KiB(64));
+  Yoru_Allocator             *tcache  = yoru_thread_caching_allocator_make(YORU_KiB(64));
+  bool                        success = arena && varena && slab && tcache;
+
+  success = success && expect_realloc_keeps_contents(&global);
+  success = success && expect_realloc_keeps_contents(arena);
+  success = success && expect_realloc_keeps_contents(varena);
+  success = success && expect_realloc_keeps_contents(slab);
+  success = success && expect_realloc_keeps_contents(tcache);
+
+  if (arena) yoru_allocator_destroy(arena);
+  if (varena) yoru_allocator_destroy(varena);
+  if (slab) yoru_allocator_destroy(slab);
+  if (tcache) yoru_allocator_destroy(tcache);
+  return success;
+}
+
+/* ============================================================
+   MODULE: ArenaAllocator
+   ============================================================ */
+
+bool yoru_arena_allocator_realloc_in_place_test() {
+  Yoru_ArenaAllocator *allocator = yoru_arena_allocator_make(YORU_KiB(4));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 16);
+  YORU_EXPECT_TRUE(a.has_value);
+  memcpy(a.ptr, "0123456789", 10);
+
+  // `a` is the last allocation -> grows in place
+  Yoru_Opt b = yoru_allocator_realloc(allocator, 16, a.ptr, 64);
+  YORU_EXPECT_TRUE(b.has_value);
+  YORU_EXPECT_TRUE(a.ptr == b.ptr);
+
+  Yoru_Opt c = yoru_allocator_alloc(allocator, 16);
+  YORU_EXPECT_TRUE(c.has_value);
+  YORU_EXPECT_TRUE((u8 *)c.ptr >= (u8 *)b.ptr + 64);
+
+  // `b` is not the last allocation anymore -> copied to the end
+  Yoru_Opt d = yoru_allocator_realloc(allocator, 64, b.ptr, 128);
+  YORU_EXPECT_TRUE(d.has_value);
+  YORU_EXPECT_TRUE((u8 *)d.ptr > (u8 *)c.ptr);
+  YORU_EXPECT_EQ_MEM("0123456789", d.ptr, 10);
+
+  // does not fit anymore
+  YORU_EXPECT_TRUE(!yoru_allocator_realloc(allocator, 128, d.ptr, YORU_KiB(8)).has_value);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_arena_allocator_alloc_uninit_test() {
+  Yoru_ArenaAllocator *allocator = yoru_arena_allocator_make(YORU_KiB(4));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt dirty = yoru_allocator_alloc_uninit(allocator, 64);
+  YORU_EXPECT_TRUE(dirty.has_value);
+  memset(dirty.ptr, 0xFF, 64);
+
+  // memory handed out without zeroing still comes back zeroed from alloc
+  yoru_arena_allocator_reset(allocator);
+  Yoru_Opt clean = yoru_allocator_alloc(allocator, 64);
+  YORU_EXPECT_TRUE(clean.has_value);
+  YORU_EXPECT_TRUE(clean.ptr == dirty.ptr);
+  for (usize i = 0; i < 64; ++i) YORU_EXPECT_EQ_USIZE(0, ((u8 *)clean.ptr)[i]);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_arena_allocator_arraylist_test() {
+  Yoru_ArenaAllocator *allocator = yoru_arena_allocator_make(YORU_KiB(64));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_ArrayList_T(usize) xs = {0};
+  yoru_arraylist_init(&xs, allocator, 0);
+  for (usize i = 0; i < 1000; ++i) {
+    yoru_arraylist_append(&xs, i);
+  }
+  YORU_EXPECT_EQ_USIZE(1000, xs.size);
+  for (usize i = 0; i < xs.size; ++i) {
+    YORU_EXPECT_EQ_USIZE(i, xs.items[i]);
+  }
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_arena_allocator_marker_test() {
+  Yoru_ArenaAllocator *allocator = yoru_arena_allocator_make(YORU_KiB(4));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 32);
+  YORU_EXPECT_TRUE(a.has_value);
+  Yoru_ArenaMarker marker = yoru_arena_allocator_get_marker(allocator);
+
+  Yoru_Opt b = yoru_allocator_alloc(allocator, 64);
+  YORU_EXPECT_TRUE(b.has_value);
+  memset(b.ptr, 0xFF, 64);
+
+  // everything after the marker is handed out again, zeroed
+  yoru_arena_allocator_restore(allocator, marker);
+  Yoru_Opt c = yoru_allocator_alloc(allocator, 64);
+  YORU_EXPECT_TRUE(c.has_value);
+  YORU_EXPECT_TRUE(b.ptr == c.ptr);
+  u8 zeros[64] = {0};
+  YORU_EXPECT_EQ_MEM(zeros, c.ptr, 64);
+
+  // `a` is the most recent allocation again after rolling back, growing it
+  // clears what was handed out after the marker
+  memset(c.ptr, 0xFF, 64);
+  yoru_arena_allocator_restore(allocator, marker);
+  Yoru_Opt d = yoru_allocator_realloc(allocator, 32, a.ptr, 128);
+  YORU_EXPECT_TRUE(d.has_value);
+  YORU_EXPECT_TRUE(a.ptr == d.ptr);
+  for (usize i = 32; i < 128; ++i) YORU_EXPECT_EQ_USIZE(0, ((u8 *)d.ptr)[i]);
+
+  memset(d.ptr, 0xFF, 128);
+  yoru_arena_allocator_restore(allocator, marker);
+  Yoru_Opt f = yoru_arena_allocator_realloc_inline(allocator, 32, a.ptr, 96);
+  YORU_EXPECT_TRUE(f.has_value && f.ptr == a.ptr);
+  for (usize i = 32; i < 96; ++i) YORU_EXPECT_EQ_USIZE(0, ((u8 *)f.ptr)[i]);
+
+  yoru_arena_allocator_reset(allocator);
+  Yoru_Opt e = yoru_allocator_alloc(allocator, YORU_KiB(4));
+  YORU_EXPECT_TRUE(e.has_value);
+  YORU_EXPECT_TRUE(a.ptr == e.ptr);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+/* ============================================================
+   MODULE: ChainedArenaAllocator
+   ============================================================ */
+
+bool yoru_chained_arena_allocator_growth_test() {
+  Yoru_GlobalAllocator        global    = yoru_global_allocator_make();
+  Yoru_TrackingAllocator     *parent    = yoru_tracking_allocator_make(&global, "chained arena");
+  Yoru_ChainedArenaAllocator *allocator = NULL;
+  YORU_EXPECT_TRUE(parent);
+  allocator = yoru_chained_arena_allocator_make(parent, YORU_KiB(4));
+  YORU_EXPECT_TRUE(allocator);
+
+  // filling the first block chains more blocks instead of failing
+  u8 *first = NULL;
+  for (usize i = 0; i < 64; ++i) {
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc(allocator, YORU_KiB(1));
+    YORU_EXPECT_TRUE(maybe_ptr.has_value);
+    for (usize j = 0; j < YORU_KiB(1); ++j) YORU_EXPECT_EQ_USIZE(0, ((u8 *)maybe_ptr.ptr)[j]);
+    memset(maybe_ptr.ptr, 0xAB, YORU_KiB(1));
+    if (!first) first = maybe_ptr.ptr;
+  }
+  YORU_EXPECT_EQ_USIZE(0xAB, first[YORU_KiB(1) - 1]);
+  Yoru_TrackingStats stats = yoru_tracking_allocator_get_stats(parent);
+  YORU_EXPECT_TRUE(stats.alloc_count > 1 && stats.alloc_count < 8);
+
+  // bigger than any block so far, it gets a block of its own behind the
+  // current one, which keeps being bumped and does not make the next block grow
+  Yoru_ChainedArenaAllocatorCtx *ctx             = allocator->ctx;
+  usize                          next_block_size = ctx->next_block_size;
+  Yoru_Opt                       before          = yoru_allocator_alloc(allocator, 16);
+  Yoru_Opt                       big             = yoru_allocator_alloc(allocator, YORU_MiB(1));
+  Yoru_Opt                       after           = yoru_allocator_alloc(allocator, 16);
+  YORU_EXPECT_TRUE(before.has_value && big.has_value && after.has_value);
+  YORU_EXPECT_TRUE((u8 *)after.ptr == (u8 *)before.ptr + 16);
+  YORU_EXPECT_EQ_USIZE(next_block_size, ctx->next_block_size);
+  Yoru_Opt shrunk = yoru_allocator_realloc(allocator, YORU_MiB(1), big.ptr, YORU_KiB(512));
+  YORU_EXPECT_TRUE(shrunk.ptr == big.ptr);
+  Yoru_Opt grown = yoru_allocator_realloc(allocator, YORU_KiB(512), shrunk.ptr, YORU_MiB(1));
+  YORU_EXPECT_TRUE(grown.ptr == big.ptr);
+
+  YORU_EXPECT_TRUE(expect_aligned_allocations(allocator));
+  YORU_EXPECT_TRUE(expect_realloc_keeps_contents(allocator));
+
+  // reset keeps only the current block, never the oversize one
+  yoru_chained_arena_allocator_reset(allocator);
+  stats = yoru_tracking_allocator_get_stats(parent);
+  YORU_EXPECT_EQ_USIZE(stats.alloc_count - 1, stats.dealloc_count);
+  YORU_EXPECT_TRUE(stats.bytes_in_use < YORU_MiB(1));
+  Yoru_Opt again = yoru_allocator_alloc(allocator, 64);
+  YORU_EXPECT_TRUE(again.has_value);
+  for (usize j = 0; j < 64; ++j) YORU_EXPECT_EQ_USIZE(0, ((u8 *)again.ptr)[j]);
+
+  yoru_allocator_destroy(allocator);
+  stats = yoru_tracking_allocator_get_stats(parent);
+  YORU_EXPECT_EQ_USIZE(0, stats.bytes_in_use);
+  yoru_allocator_destroy(parent);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  if (parent) yoru_allocator_destroy(parent);
+  return false;
+}
+
+/* ============================================================
+   MODULE: VirtualMemory
+   ============================================================ */
+
+bool yoru_vmem_decommit_test() {
+  Yoru_Vmem_Ctx vm        = {0};
+  usize         page_size = yoru_get_page_size();
+  YORU_EXPECT_TRUE(yoru_vmem_reserve(16 * page_size, &vm));
+  YORU_EXPECT_TRUE(yoru_vmem_commit(&vm, 8 * page_size));
+  memset(vm.base, 0xAB, 8 * page_size);
+
+  // only whole pages are decommitted, from the end of the committed range
+  YORU_EXPECT_TRUE(yoru_vmem_decommit(&vm, 2 * page_size + 1, YORU_VMEM_DECOMMIT_NONE));
+  YORU_EXPECT_EQ_USIZE(6 * page_size, vm.commit_pos);
+  YORU_EXPECT_TRUE(yoru_vmem_decommit(&vm, 2 * page_size, YORU_VMEM_DECOMMIT_PROTECT));
+  YORU_EXPECT_EQ_USIZE(4 * page_size, vm.commit_pos);
+
+  // committing again hands out zeroed pages, the rest is left untouched
+  YORU_EXPECT_TRUE(yoru_vmem_commit(&vm, 4 * page_size));
+  u8 *bytes = vm.base;
+  YORU_EXPECT_EQ_USIZE(0xAB, bytes[4 * page_size - 1]);
+  for (usize i = 4 * page_size; i < 8 * page_size; ++i) YORU_EXPECT_EQ_USIZE(0, bytes[i]);
+
+  // more than committed just decommits everything
+  YORU_EXPECT_TRUE(yoru_vmem_decommit(&vm, 64 * page_size, YORU_VMEM_DECOMMIT_LAZY));
+  YORU_EXPECT_EQ_USIZE(0, vm.commit_pos);
+
+  yoru_vmem_free(&vm);
+  return true;
+
+err:
+  if (vm.base) yoru_vmem_free(&vm);
+  return false;
+}
+
+bool yoru_vmem_numa_policy_test() {
+  Yoru_Vmem_Ctx vm         = {0};
+  usize         page_size  = yoru_get_page_size();
+  usize         node_count = yoru_numa_node_count();
+  YORU_EXPECT_TRUE(node_count >= 1);
+  YORU_EXPECT_TRUE(yoru_numa_node_online(yoru_numa_current_node()));
+  YORU_EXPECT_TRUE(!yoru_numa_node_online(node_count));
+
+  // node ids can have gaps, the missing ones are not online
+  unsigned long mask[__YORU_NUMA_MAX_NODES / __YORU_NUMA_MASK_BITS] = {0};
+  YORU_EXPECT_EQ_USIZE(3, __yoru_numa_parse_node_list("0,2\n", mask));
+  YORU_EXPECT_EQ_USIZE(0x5, mask[0]);
+  mask[0] = 0;
+  YORU_EXPECT_EQ_USIZE(6, __yoru_numa_parse_node_list("0-1,4-5\n", mask));
+  YORU_EXPECT_EQ_USIZE(0x33, mask[0]);
+
+  // every machine has node 0, binding to it or interleaving works everywhere
+  YORU_EXPECT_TRUE(yoru_vmem_reserve(16 * page_size, &vm));
+  YORU_EXPECT_TRUE(yoru_vmem_set_numa_policy(&vm, YORU_VMEM_NUMA_BIND, 0));
+  YORU_EXPECT_TRUE(!yoru_vmem_set_numa_policy(&vm, YORU_VMEM_NUMA_BIND, node_count));
+  YORU_EXPECT_TRUE(yoru_vmem_commit(&vm, 4 * page_size));
+  memset(vm.base, 0xAB, 4 * page_size);
+  YORU_EXPECT_TRUE(yoru_vmem_set_numa_policy(&vm, YORU_VMEM_NUMA_INTERLEAVE, 0));
+  YORU_EXPECT_TRUE(yoru_vmem_set_numa_policy(&vm, YORU_VMEM_NUMA_DEFAULT, 0));
+  YORU_EXPECT_EQ_USIZE(0xAB, ((u8 *)vm.base)[4 * page_size - 1]);
+
+  yoru_vmem_free(&vm);
+  return true;
+
+err:
+  if (vm.base) yoru_vmem_free(&vm);
+  return false;
+}
+
+/* ============================================================
+   MODULE: VirtualArenaAllocator
+   ============================================================ */
+
+bool yoru_virtual_arena_allocator_stringbuilder_test() {
+  Yoru_VirtualArenaAllocator *allocator = yoru_virtual_arena_allocator_make(YORU_MiB(1));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_StringBuilder sb = {0};
+  yoru_stringbuilder_init(allocator, &sb);
+  for (usize i = 0; i < 10000; ++i) {
+    YORU_EXPECT_TRUE(yoru_stringbuilder_append_char(&sb, 'a' + (char)(i % 26)));
+  }
+  YORU_EXPECT_EQ_USIZE(10000, sb.size);
+  YORU_EXPECT_EQ_MEM("abcdefghijklmnopqrstuvwxyzabc", sb.items, 29);
+  YORU_EXPECT_EQ_MEM("nop", sb.items + 10000 - 3, 3);
+
+  // growing a block that is not the last one copies it
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 8);
+  YORU_EXPECT_TRUE(a.has_value);
+  Yoru_Opt b = yoru_allocator_realloc(allocator, sb.capacity, sb.items, sb.capacity * 2);
+  YORU_EXPECT_TRUE(b.has_value);
+  YORU_EXPECT_TRUE(b.ptr != (anyptr)sb.items);
+  YORU_EXPECT_EQ_MEM(sb.items, b.ptr, sb.size);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_virtual_arena_allocator_scratch_test() {
+  Yoru_VirtualArenaAllocator *allocator = yoru_virtual_arena_allocator_make(YORU_MiB(1));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 16);
+  YORU_EXPECT_TRUE(a.has_value);
+
+  Yoru_ArenaScratch outer = yoru_arena_scratch_begin(allocator);
+  Yoru_Opt          b     = yoru_allocator_alloc(outer.arena, YORU_KiB(64));
+  YORU_EXPECT_TRUE(b.has_value);
+  memset(b.ptr, 0xFF, YORU_KiB(64));
+
+  anyptr inner_ptr = NULL;
+  yoru_arena_scratch_scope(inner, outer.arena) {
+    Yoru_Opt c = yoru_allocator_alloc(inner.arena, 16);
+    if (c.has_value) inner_ptr = c.ptr;
+  }
+  YORU_EXPECT_TRUE(inner_ptr);
+
+  // the inner scratch is released, the outer one is not
+  Yoru_Opt d = yoru_allocator_alloc(allocator, 16);
+  YORU_EXPECT_TRUE(d.has_value);
+  YORU_EXPECT_TRUE(d.ptr == inner_ptr);
+
+  yoru_arena_scratch_end(&outer);
+  Yoru_Opt e = yoru_allocator_alloc(allocator, 16);
+  YORU_EXPECT_TRUE(e.has_value);
+  YORU_EXPECT_TRUE(e.ptr == b.ptr);
+  u8 zeros[16] = {0};
+  YORU_EXPECT_EQ_MEM(zeros, e.ptr, 16);
+
+  yoru_virtual_arena_allocator_reset(allocator);
+  Yoru_Opt f = yoru_allocator_alloc(allocator, 16);
+  YORU_EXPECT_TRUE(f.has_value);
+  YORU_EXPECT_TRUE(f.ptr == a.ptr);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_virtual_arena_allocator_commit_growth_test() {
+  Yoru_VirtualArenaOptions options = {
+      .min_commit_size = YORU_KiB(64),
+      .max_commit_size = YORU_KiB(256),
+      .vmem_flags      = YORU_VMEM_TRANSPARENT_HUGE_PAGES,
+  };
+  Yoru_VirtualArenaAllocator *allocator = yoru_virtual_arena_allocator_make_with_options(YORU_MiB(4), options);
+  YORU_EXPECT_TRUE(allocator);
+  Yoru_Vmem_Ctx *vm = ((Yoru_VirtualArenaAllocatorCtx *)allocator->ctx)->vmem_ctx;
+  YORU_EXPECT_EQ_USIZE(0, vm->commit_pos);
+
+  // 64 KiB, 128 KiB, 256 KiB, 256 KiB, ...
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, 16).has_value);
+  YORU_EXPECT_EQ_USIZE(YORU_KiB(64), vm->commit_pos);
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, YORU_KiB(64)).has_value);
+  YORU_EXPECT_EQ_USIZE(YORU_KiB(192), vm->commit_pos);
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, YORU_KiB(128)).has_value);
+  YORU_EXPECT_EQ_USIZE(YORU_KiB(448), vm->commit_pos);
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, YORU_KiB(400)).has_value);
+  YORU_EXPECT_EQ_USIZE(YORU_KiB(704), vm->commit_pos);
+
+  // a single allocation bigger than the step commits everything it needs
+  Yoru_Opt big = yoru_allocator_alloc(allocator, YORU_MiB(2));
+  YORU_EXPECT_TRUE(big.has_value);
+  YORU_EXPECT_TRUE((u8 *)big.ptr + YORU_MiB(2) <= (u8 *)vm->base + vm->commit_pos);
+
+  // the commit never goes past the reservation
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(allocator, YORU_MiB(4)).has_value);
+  YORU_EXPECT_TRUE(vm->commit_pos <= vm->addr_space_size);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+static bool expect_decommit_on_reset(Yoru_Vmem_DecommitFlags flags) {
+  Yoru_VirtualArenaOptions options = {
+      .min_commit_size = YORU_KiB(64),
+      .decommit_above  = YORU_KiB(64),
+      .decommit_flags  = flags,
+  };
+  Yoru_VirtualArenaAllocator *allocator = yoru_virtual_arena_allocator_make_with_options(YORU_MiB(4), options);
+  YORU_EXPECT_TRUE(allocator);
+  Yoru_Vmem_Ctx *vm = ((Yoru_VirtualArenaAllocatorCtx *)allocator->ctx)->vmem_ctx;
+
+  Yoru_Opt spike = yoru_allocator_alloc(allocator, YORU_MiB(1));
+  YORU_EXPECT_TRUE(spike.has_value);
+  memset(spike.ptr, 0xAB, YORU_MiB(1));
+  YORU_EXPECT_TRUE(vm->commit_pos >= YORU_MiB(1));
+
+  // a marker above the mark keeps everything up to the arena position
+  Yoru_ArenaMarker marker = yoru_virtual_arena_allocator_get_marker(allocator);
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, YORU_MiB(1)).has_value);
+  yoru_virtual_arena_allocator_restore(allocator, marker);
+  YORU_EXPECT_EQ_USIZE(yoru_align_up(YORU_MiB(1), vm->page_size), vm->commit_pos);
+
+  yoru_virtual_arena_allocator_reset(allocator);
+  YORU_EXPECT_EQ_USIZE(YORU_KiB(64), vm->commit_pos);
+
+  // the memory is zeroed again, no matter how the pages were released
+  Yoru_Opt again = yoru_allocator_alloc(allocator, YORU_MiB(1));
+  YORU_EXPECT_TRUE(again.has_value);
+  for (usize i = 0; i < YORU_MiB(1); i += 1021) YORU_EXPECT_EQ_USIZE(0, ((u8 *)again.ptr)[i]);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_virtual_arena_allocator_decommit_test() {
+  YORU_EXPECT_TRUE(expect_decommit_on_reset(YORU_VMEM_DECOMMIT_NONE));
+  YORU_EXPECT_TRUE(expect_decommit_on_reset(YORU_VMEM_DECOMMIT_LAZY));
+  YORU_EXPECT_TRUE(expect_decommit_on_reset(YORU_VMEM_DECOMMIT_PROTECT));
+  return true;
+
+err:
+  return false;
+}
+
+bool yoru_virtual_arena_allocator_per_node_test() {
+  Yoru_VirtualArenaAllocator *arenas[64] = {0};
+  usize                       node_count = yoru_numa_node_count();
+  if (node_count > 64) return true;
+
+  YORU_EXPECT_TRUE(yoru_virtual_arena_allocator_make_per_node(YORU_MiB(1), (Yoru_VirtualArenaOptions){0}, arenas));
+  for (usize node = 0; node < node_count; ++node) {
+    YORU_EXPECT_TRUE(!arenas[node] == !yoru_numa_node_online(node));
+    if (!arenas[node]) continue;
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc(arenas[node], YORU_KiB(64));
+    YORU_EXPECT_TRUE(maybe_ptr.has_value);
+    memset(maybe_ptr.ptr, 0xAB, YORU_KiB(64));
+  }
+
+  // the local arena is the one of the node this thread runs on
+  Yoru_VirtualArenaAllocator *local = arenas[yoru_numa_current_node()];
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(local, 16).has_value);
+  for (usize node = 0; node < node_count; ++node) {
+    if (arenas[node]) yoru_allocator_destroy(arenas[node]);
+  }
+
+  // an arena bound to a node that does not exist can not be created
+  Yoru_VirtualArenaOptions options = {.numa_mode = YORU_VMEM_NUMA_BIND, .numa_node = node_count};
+  YORU_EXPECT_TRUE(!yoru_virtual_arena_allocator_make_with_options(YORU_MiB(1), options));
+  return true;
+
+err:
+  return false;
+}
+
+/* ============================================================
+   MODULE: PersistentArenaAllocator
+   ============================================================ */
+
+#define PERSISTENT_ARENA_TEST_PATH "yoru_persistent_arena_test.bin"
+
+typedef struct PersistentArenaTestRoot {
+  usize  count;
+  u32   *values;
+  usize  values_offset;
+} PersistentArenaTestRoot;
+
+bool yoru_persistent_arena_allocator_reopen_test() {
+  remove(PERSISTENT_ARENA_TEST_PATH);
+  Yoru_PersistentArenaAllocator *arena = yoru_persistent_arena_allocator_open(
+      PERSISTENT_ARENA_TEST_PATH,
+      YORU_PERSISTENT_ARENA_DEFAULT_BASE,
+      YORU_MiB(16));
+  YORU_EXPECT_TRUE(arena);
+  YORU_EXPECT_TRUE(!yoru_persistent_arena_allocator_get_root(arena));
+
+  Yoru_Opt maybe_root   = yoru_allocator_alloc(arena, sizeof(PersistentArenaTestRoot));
+  Yoru_Opt maybe_values = yoru_allocator_alloc(arena, 1000 * sizeof(u32));
+  YORU_EXPECT_TRUE(maybe_root.has_value && maybe_values.has_value);
+  PersistentArenaTestRoot *root = maybe_root.ptr;
+  root->count                   = 1000;
+  root->values                  = maybe_values.ptr;
+  root->values_offset           = yoru_persistent_arena_allocator_to_offset(arena, root->values);
+  for (u32 i = 0; i < 1000; ++i) root->values[i] = i * i;
+  yoru_persistent_arena_allocator_set_root(arena, root);
+  yoru_allocator_destroy(arena);
+
+  // the base and capacity come from the file, so plain pointers still work
+  arena = yoru_persistent_arena_allocator_open(PERSISTENT_ARENA_TEST_PATH, NULL, 0);
+  YORU_EXPECT_TRUE(arena);
+  root = yoru_persistent_arena_allocator_get_root(arena);
+  YORU_EXPECT_TRUE(root == maybe_root.ptr);
+  YORU_EXPECT_EQ_USIZE(1000, root->count);
+  YORU_EXPECT_TRUE(yoru_persistent_arena_allocator_from_offset(arena, root->values_offset) == root->values);
+  for (u32 i = 0; i < 1000; ++i) YORU_EXPECT_EQ_USIZE(i * i, root->values[i]);
+
+  // new allocations continue behind the old ones
+  Yoru_Opt next = yoru_allocator_alloc(arena, 16);
+  YORU_EXPECT_TRUE((u32 *)next.ptr >= root->values + 1000);
+
+  // reused memory is zeroed after a reset
+  yoru_persistent_arena_allocator_reset(arena);
+  YORU_EXPECT_TRUE(!yoru_persistent_arena_allocator_get_root(arena));
+  Yoru_Opt again = yoru_allocator_alloc(arena, sizeof(PersistentArenaTestRoot));
+  YORU_EXPECT_TRUE(again.ptr == maybe_root.ptr);
+  YORU_EXPECT_EQ_USIZE(0, ((PersistentArenaTestRoot *)again.ptr)->count);
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(arena, YORU_MiB(16)).has_value);
+  yoru_allocator_destroy(arena);
+
+  // a file that is not an arena is rejected
+  YORU_EXPECT_TRUE(yoru_file_write_exact(PERSISTENT_ARENA_TEST_PATH, (const u8 *)"not an arena", 12, 0));
+  arena = yoru_persistent_arena_allocator_open(PERSISTENT_ARENA_TEST_PATH, NULL, YORU_MiB(16));
+  YORU_EXPECT_TRUE(!arena);
+
+  remove(PERSISTENT_ARENA_TEST_PATH);
+  return true;
+
+err:
+  if (arena) yoru_allocator_destroy(arena);
+  remove(PERSISTENT_ARENA_TEST_PATH);
+  return false;
+}
+
+/* ============================================================
+   MODULE: StaticDispatch
+   ============================================================ */
+
+bool yoru_static_dispatch_arena_test() {
+  Yoru_ArenaAllocator *arena = yoru_arena_allocator_make(YORU_KiB(4));
+  YORU_EXPECT_TRUE(arena);
+
+  // reused memory is zeroed like through the vtable
+  Yoru_Opt a = yoru_allocator_alloc_uninit_with(arena, arena, 100);
+  YORU_EXPECT_TRUE(a.has_value);
+  memset(a.ptr, 0xAB, 100);
+  yoru_arena_allocator_reset(arena);
+  Yoru_Opt b = yoru_allocator_alloc_with(arena, arena, 100);
+  YORU_EXPECT_TRUE(b.ptr == a.ptr);
+  for (usize i = 0; i < 100; ++i) YORU_EXPECT_EQ_USIZE(0, ((u8 *)b.ptr)[i]);
+
+  // the most recent allocation grows in place, others are copied
+  Yoru_Opt grown = yoru_allocator_realloc_with(arena, arena, 100, b.ptr, 200);
+  YORU_EXPECT_TRUE(grown.ptr == b.ptr);
+  Yoru_Opt c     = yoru_allocator_alloc_with(arena, arena, 16);
+  Yoru_Opt moved = yoru_allocator_realloc_with(arena, arena, 200, grown.ptr, 300);
+  YORU_EXPECT_TRUE(c.has_value && moved.has_value);
+  YORU_EXPECT_TRUE(moved.ptr != grown.ptr);
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc_with(arena, arena, YORU_KiB(4)).has_value);
+
+  // the arraylist only takes the fast path
+  yoru_arena_allocator_reset(arena);
+  Yoru_ArrayList_T(u32) xs = {0};
+  yoru_arraylist_init_with(arena, &xs, arena, 0);
+  for (u32 i = 0; i < 512; ++i) yoru_arraylist_append_with(arena, &xs, i);
+  for (u32 i = 0; i < 512; ++i) YORU_EXPECT_EQ_USIZE(i, xs.items[i]);
+
+  yoru_allocator_destroy(arena);
+  return true;
+
+err:
+  if (arena) yoru_allocator_destroy(arena);
+  return false;
+}
+
+bool yoru_static_dispatch_fallback_test() {
+  Yoru_VirtualArenaAllocator *virtual_arena = yoru_virtual_arena_allocator_make(YORU_MiB(64));
+  Yoru_GlobalAllocator        global        = yoru_global_allocator_make();
+  Yoru_ChainedArenaAllocator *chained_arena = yoru_chained_arena_allocator_make(&global, YORU_KiB(4));
+  YORU_EXPECT_TRUE(virtual_arena && chained_arena);
+
+  // nothing is committed yet, so the first allocation goes through the vtable
+  Yoru_HashMap_T(usize) map = {0};
+  yoru_hashmap_init_with(virtual_arena, &map, virtual_arena);
+  char key[16] = {0};
+  for (usize n = 0; n < 1000; ++n) {
+    snprintf(key, sizeof(key), "key-%zu", n);
+    yoru_hashmap_set_with(virtual_arena, &map, key, n);
+  }
+  usize value = 0;
+  yoru_hashmap_get(&map, "key-777", &value);
+  YORU_EXPECT_EQ_USIZE(777, value);
+  for (usize i = 0; i < map.keys.size; ++i) free(map.keys.items[i].key);
+
+  // filling the first block chains new ones through the vtable
+  for (usize i = 0; i < 64; ++i) {
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc_with(chained_arena, chained_arena, YORU_KiB(1));
+    YORU_EXPECT_TRUE(maybe_ptr.has_value);
+    for (usize j = 0; j < YORU_KiB(1); ++j) YORU_EXPECT_EQ_USIZE(0, ((u8 *)maybe_ptr.ptr)[j]);
+    memset(maybe_ptr.ptr, 0xAB, YORU_KiB(1));
+  }
+
+  yoru_allocator_destroy(chained_arena);
+  yoru_allocator_destroy(virtual_arena);
+  return true;
+
+err:
+  if (chained_arena) yoru_allocator_destroy(chained_arena);
+  if (virtual_arena) yoru_allocator_destroy(virtual_arena);
+  return false;
+}
+
+/* ============================================================
+   MODULE: SlabAllocator
+   ============================================================ */
+
+bool yoru_slab_allocator_reuse_test() {
+  Yoru_SlabAllocator *allocator = yoru_slab_allocator_make(YORU_MiB(1));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 24);
+  YORU_EXPECT_TRUE(a.has_value);
+  memset(a.ptr, 0xAB, 24);
+  yoru_allocator_dealloc(allocator, a.ptr);
+
+  // same size class -> the freed block is handed out again and zeroed
+  Yoru_Opt b = yoru_allocator_alloc(allocator, 32);
+  YORU_EXPECT_TRUE(b.has_value);
+  YORU_EXPECT_TRUE(a.ptr == b.ptr);
+  u8 zeros[32] = {0};
+  YORU_EXPECT_EQ_MEM(zeros, b.ptr, 32);
+
+  // different size class -> different block
+  Yoru_Opt c = yoru_allocator_alloc(allocator, 100);
+  YORU_EXPECT_TRUE(c.has_value);
+  YORU_EXPECT_TRUE(c.ptr != b.ptr);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_slab_allocator_realloc_test() {
+  Yoru_SlabAllocator *allocator = yoru_slab_allocator_make(YORU_MiB(1));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 20);
+  YORU_EXPECT_TRUE(a.has_value);
+  memcpy(a.ptr, "0123456789", 10);
+
+  // still fits the 32 byte block
+  Yoru_Opt b = yoru_allocator_realloc(allocator, 20, a.ptr, 30);
+  YORU_EXPECT_TRUE(b.has_value);
+  YORU_EXPECT_TRUE(a.ptr == b.ptr);
+
+  // moves into a bigger class and then into the global allocator
+  Yoru_Opt c = yoru_allocator_realloc(allocator, 30, b.ptr, 500);
+  YORU_EXPECT_TRUE(c.has_value);
+  YORU_EXPECT_EQ_MEM("0123456789", c.ptr, 10);
+
+  Yoru_Opt d = yoru_allocator_realloc(allocator, 500, c.ptr, YORU_KiB(8));
+  YORU_EXPECT_TRUE(d.has_value);
+  YORU_EXPECT_EQ_MEM("0123456789", d.ptr, 10);
+  yoru_allocator_dealloc(allocator, d.ptr);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_slab_allocator_exhaustion_test() {
+  Yoru_SlabAllocator *allocator = yoru_slab_allocator_make(YORU_SLAB_COMMIT_SIZE);
+  YORU_EXPECT_TRUE(allocator);
+
+  usize blocks = YORU_SLAB_COMMIT_SIZE / YORU_SLAB_MAX_BLOCK_SIZE;
+  for (usize i = 0; i < blocks; ++i) {
+    YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, YORU_SLAB_MAX_BLOCK_SIZE).has_value);
+  }
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(allocator, YORU_SLAB_MAX_BLOCK_SIZE).has_value);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+/* ============================================================
+   MODULE: BuddyAllocator
+   ============================================================ */
+
+bool yoru_buddy_allocator_split_merge_test() {
+  Yoru_BuddyAllocator *allocator = yoru_buddy_allocator_make(YORU_BUDDY_MAX_BLOCK_SIZE);
+  YORU_EXPECT_TRUE(allocator);
+  usize min_block = (usize)1 << ((Yoru_BuddyAllocatorCtx *)allocator->ctx)->min_shift;
+
+  // two smallest blocks are buddies next to each other
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 1);
+  Yoru_Opt b = yoru_allocator_alloc(allocator, min_block);
+  YORU_EXPECT_TRUE(a.has_value && b.has_value);
+  YORU_EXPECT_TRUE((u8 *)b.ptr == (u8 *)a.ptr + min_block);
+  memset(a.ptr, 0xAB, min_block);
+
+  // once both are free they merge again and the memory comes back zeroed
+  yoru_allocator_dealloc(allocator, b.ptr);
+  yoru_allocator_dealloc(allocator, a.ptr);
+  Yoru_Opt c = yoru_allocator_alloc(allocator, 2 * min_block);
+  YORU_EXPECT_TRUE(c.has_value);
+  YORU_EXPECT_TRUE(c.ptr == a.ptr);
+  for (usize i = 0; i < 2 * min_block; ++i) YORU_EXPECT_EQ_USIZE(0, ((u8 *)c.ptr)[i]);
+  yoru_allocator_dealloc(allocator, c.ptr);
+
+  // everything merged back into one max block
+  Yoru_Opt all = yoru_allocator_alloc(allocator, YORU_BUDDY_MAX_BLOCK_SIZE);
+  YORU_EXPECT_TRUE(all.has_value);
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(allocator, 1).has_value);
+  yoru_allocator_dealloc(allocator, all.ptr);
+
+  YORU_EXPECT_TRUE(expect_aligned_allocations(allocator));
+
+  // blocks above the max size come from the global heap, aligned as well
+  Yoru_Opt big = yoru_allocator_alloc_aligned(allocator, YORU_BUDDY_MAX_BLOCK_SIZE + 1, 64);
+  YORU_EXPECT_TRUE(big.has_value);
+  YORU_EXPECT_EQ_USIZE(0, (usize)big.ptr % 64);
+  yoru_allocator_dealloc(allocator, big.ptr);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_buddy_allocator_realloc_test() {
+  Yoru_BuddyAllocator *allocator = yoru_buddy_allocator_make(YORU_BUDDY_MAX_BLOCK_SIZE);
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt a = yoru_allocator_alloc(allocator, YORU_KiB(16));
+  YORU_EXPECT_TRUE(a.has_value);
+  memset(a.ptr, 0xAB, YORU_KiB(16));
+
+  // the buddies above are free, so the block grows without moving
+  Yoru_Opt grown = yoru_allocator_realloc(allocator, YORU_KiB(16), a.ptr, YORU_MiB(1));
+  YORU_EXPECT_TRUE(grown.has_value);
+  YORU_EXPECT_TRUE(grown.ptr == a.ptr);
+  ((u8 *)grown.ptr)[YORU_MiB(1) - 1] = 1;
+
+  // shrinking hands the upper half back, which blocks the next in-place growth
+  Yoru_Opt shrunk = yoru_allocator_realloc(allocator, YORU_MiB(1), grown.ptr, YORU_KiB(512));
+  YORU_EXPECT_TRUE(shrunk.ptr == a.ptr);
+  Yoru_Opt blocker = yoru_allocator_alloc(allocator, YORU_KiB(512));
+  YORU_EXPECT_TRUE(blocker.has_value);
+  YORU_EXPECT_TRUE((u8 *)blocker.ptr == (u8 *)a.ptr + YORU_KiB(512));
+
+  Yoru_Opt moved = yoru_allocator_realloc(allocator, YORU_KiB(512), shrunk.ptr, YORU_MiB(1));
+  YORU_EXPECT_TRUE(moved.has_value);
+  YORU_EXPECT_TRUE(moved.ptr != a.ptr);
+  for (usize i = 0; i < YORU_KiB(16); ++i) YORU_EXPECT_EQ_USIZE(0xAB, ((u8 *)moved.ptr)[i]);
+
+  // blocks above the max size live on the global heap
+  Yoru_Opt big = yoru_allocator_realloc(allocator, YORU_MiB(1), moved.ptr, YORU_BUDDY_MAX_BLOCK_SIZE + 1);
+  YORU_EXPECT_TRUE(big.has_value);
+  YORU_EXPECT_EQ_USIZE(0xAB, ((u8 *)big.ptr)[0]);
+  yoru_allocator_dealloc(allocator, big.ptr);
+  yoru_allocator_dealloc(allocator, blocker.ptr);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+/* ============================================================
+   MODULE: TlsfAllocator
+   ============================================================ */
+
+#define TLSF_TEST_REGION_SIZE (YORU_MiB(1))
+#define TLSF_TEST_LIVE (256)
+
+bool yoru_tlsf_allocator_coalesce_test() {
+  anyptr              region    = malloc(TLSF_TEST_REGION_SIZE);
+  Yoru_TlsfAllocator *allocator = yoru_tlsf_allocator_make(region, TLSF_TEST_REGION_SIZE);
+  YORU_EXPECT_TRUE(allocator);
+
+  // neighbours are carved out of the same free block one after another
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 100);
+  Yoru_Opt b = yoru_allocator_alloc(allocator, 200);
+  Yoru_Opt c = yoru_allocator_alloc(allocator, 300);
+  YORU_EXPECT_TRUE(a.has_value && b.has_value && c.has_value);
+  YORU_EXPECT_TRUE((u8 *)a.ptr < (u8 *)b.ptr && (u8 *)b.ptr < (u8 *)c.ptr);
+  memset(b.ptr, 0xAB, 200);
+
+  // freeing the middle last merges all three with the rest of the region
+  yoru_allocator_dealloc(allocator, a.ptr);
+  yoru_allocator_dealloc(allocator, c.ptr);
+  yoru_allocator_dealloc(allocator, b.ptr);
+  Yoru_Opt all = yoru_allocator_alloc(allocator, TLSF_TEST_REGION_SIZE / 2);
+  YORU_EXPECT_TRUE(all.has_value);
+  YORU_EXPECT_TRUE(all.ptr == a.ptr);
+  for (usize i = 0; i < 400; ++i) YORU_EXPECT_EQ_USIZE(0, ((u8 *)all.ptr)[i]);
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(allocator, TLSF_TEST_REGION_SIZE / 2).has_value);
+  yoru_allocator_dealloc(allocator, all.ptr);
+
+  YORU_EXPECT_TRUE(expect_aligned_allocations(allocator));
+  YORU_EXPECT_TRUE(expect_realloc_keeps_contents(allocator));
+
+  // random sizes and lifetimes, every block keeps its fill pattern
+  anyptr live[TLSF_TEST_LIVE]  = {0};
+  usize  sizes[TLSF_TEST_LIVE] = {0};
+  u32    state                 = 1;
+  for (usize round = 0; round < 20000; ++round) {
+    state   = state * 1664525u + 1013904223u;
+    usize i = (state >> 8) % TLSF_TEST_LIVE;
+    if (live[i]) {
+      for (usize j = 0; j < sizes[i]; ++j) YORU_EXPECT_EQ_USIZE((u8)i, ((u8 *)live[i])[j]);
+      yoru_allocator_dealloc(allocator, live[i]);
+      live[i] = NULL;
+      continue;
+    }
+    sizes[i]           = 1 + (state >> 16) % 2000;
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc_uninit(allocator, sizes[i]);
+    YORU_EXPECT_TRUE(maybe_ptr.has_value);
+    live[i] = maybe_ptr.ptr;
+    memset(live[i], (int)i, sizes[i]);
+  }
+  for (usize i = 0; i < TLSF_TEST_LIVE; ++i) yoru_allocator_dealloc(allocator, live[i]);
+
+  // nothing leaked into fragments
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, TLSF_TEST_REGION_SIZE / 2).has_value);
+
+  yoru_allocator_destroy(allocator);
+  free(region);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  free(region);
+  return false;
+}
+
+bool yoru_tlsf_allocator_vmem_test() {
+  Yoru_Vmem_Ctx       vm        = {0};
+  Yoru_TlsfAllocator *allocator = NULL;
+  YORU_EXPECT_TRUE(yoru_vmem_reserve(YORU_MiB(64), &vm));
+  allocator = yoru_tlsf_allocator_make_from_vmem(&vm);
+  YORU_EXPECT_TRUE(allocator);
+
+  // the next block is free, so realloc grows in place
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 64);
+  YORU_EXPECT_TRUE(a.has_value);
+  memset(a.ptr, 0xAB, 64);
+  Yoru_Opt grown = yoru_allocator_realloc(allocator, 64, a.ptr, YORU_KiB(64));
+  YORU_EXPECT_TRUE(grown.ptr == a.ptr);
+
+  // more than the first commit, the reservation is committed further
+  Yoru_Opt big = yoru_allocator_alloc(allocator, YORU_MiB(8));
+  YORU_EXPECT_TRUE(big.has_value);
+  ((u8 *)big.ptr)[YORU_MiB(8) - 1] = 1;
+  YORU_EXPECT_TRUE(vm.commit_pos > YORU_MiB(8));
+
+  Yoru_Opt moved = yoru_allocator_realloc(allocator, YORU_KiB(64), grown.ptr, YORU_MiB(16));
+  YORU_EXPECT_TRUE(moved.has_value);
+  for (usize i = 0; i < 64; ++i) YORU_EXPECT_EQ_USIZE(0xAB, ((u8 *)moved.ptr)[i]);
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(allocator, YORU_MiB(64)).has_value);
+
+  yoru_allocator_dealloc(allocator, moved.ptr);
+  yoru_allocator_dealloc(allocator, big.ptr);
+  yoru_allocator_destroy(allocator);
+  yoru_vmem_free(&vm);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  if (vm.base) yoru_vmem_free(&vm);
+  return false;
+}
+
+/* ============================================================
+   MODULE: ThreadCachingAllocator
+   ============================================================ */
+
+#define TCACHE_TEST_THREADS (4)
+#define TCACHE_TEST_ROUNDS (1000)
+#define TCACHE_TEST_LIVE (64)
+
+static _Atomic usize tcache_test_failures = 0;
+
+static void tcache_test_worker(anyptr arg) {
+  Yoru_Allocator *allocator = arg;
+  anyptr          live[TCACHE_TEST_LIVE];
+
+  for (usize round = 0; round < TCACHE_TEST_ROUNDS; ++round) {
+    for (usize i = 0; i < TCACHE_TEST_LIVE; ++i) {
+      Yoru_Opt maybe_ptr = yoru_allocator_alloc(allocator, 16 + (i * 7) % 500);
+      if (!maybe_ptr.has_value) {
+        atomic_fetch_add(&tcache_test_failures, 1);
+        return;
+      }
+      live[i] = maybe_ptr.ptr;
+      memset(live[i], (int)i, 16);
+    }
+    for (usize i = 0; i < TCACHE_TEST_LIVE; ++i) {
+      if (((u8 *)live[i])[15] != (u8)i) atomic_fetch_add(&tcache_test_failures, 1);
+      yoru_allocator_dealloc(allocator, live[i]);
+    }
+  }
+  yoru_thread_caching_allocator_flush(allocator);
+}
+
+bool yoru_thread_caching_allocator_reuse_test() {
+  Yoru_ThreadCachingAllocator *allocator = yoru_thread_caching_allocator_make(YORU_MiB(1));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 40);
+  YORU_EXPECT_TRUE(a.has_value);
+  memset(a.ptr, 0xAB, 40);
+  yoru_allocator_dealloc(allocator, a.ptr);
+
+  // the freed block sits in the magazine of this thread and is handed out again
+  Yoru_Opt b = yoru_allocator_alloc(allocator, 64);
+  YORU_EXPECT_TRUE(b.has_value);
+  YORU_EXPECT_TRUE(a.ptr == b.ptr);
+  u8 zeros[64] = {0};
+  YORU_EXPECT_EQ_MEM(zeros, b.ptr, 64);
+
+  Yoru_Opt c = yoru_allocator_realloc(allocator, 64, b.ptr, YORU_KiB(4));
+  YORU_EXPECT_TRUE(c.has_value);
+  yoru_allocator_dealloc(allocator, c.ptr);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_thread_caching_allocator_threads_test() {
+  Yoru_ThreadCachingAllocator *allocator = yoru_thread_caching_allocator_make(YORU_MiB(16));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Thread threads[TCACHE_TEST_THREADS];
+  for (usize i = 0; i < TCACHE_TEST_THREADS; ++i) {
+    YORU_EXPECT_TRUE(yoru_thread_spawn(&threads[i], tcache_test_worker, allocator));
+  }
+  for (usize i = 0; i < TCACHE_TEST_THREADS; ++i) {
+    YORU_EXPECT_TRUE(yoru_thread_join(&threads[i]));
+  }
+  YORU_EXPECT_EQ_USIZE(0, atomic_load(&tcache_test_failures));
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+/* ============================================================
+   MODULE: ConcurrentArenaAllocator
+   ============================================================ */
+
+#define CONCURRENT_ARENA_TEST_THREADS (4)
+#define CONCURRENT_ARENA_TEST_ALLOCS (20000)
+
+typedef struct ConcurrentArenaTestWorker {
+  Yoru_Allocator *allocator;
+  u8              id;
+  anyptr          blocks[CONCURRENT_ARENA_TEST_ALLOCS];
+} ConcurrentArenaTestWorker;
+
+static void concurrent_arena_test_worker(anyptr arg) {
+  ConcurrentArenaTestWorker *worker = arg;
+  for (usize i = 0; i < CONCURRENT_ARENA_TEST_ALLOCS; ++i) {
+    Yoru_Opt maybe_ptr = yoru_allocator_alloc(worker->allocator, 24);
+    worker->blocks[i]  = maybe_ptr.has_value ? maybe_ptr.ptr : NULL;
+    if (maybe_ptr.has_value) memset(maybe_ptr.ptr, worker->id, 24);
+  }
+}
+
+bool yoru_concurrent_arena_allocator_threads_test() {
+  static ConcurrentArenaTestWorker workers[CONCURRENT_ARENA_TEST_THREADS];
+  Yoru_ConcurrentArenaAllocator   *allocator = yoru_concurrent_arena_allocator_make(YORU_MiB(64));
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Thread threads[CONCURRENT_ARENA_TEST_THREADS];
+  for (usize i = 0; i < CONCURRENT_ARENA_TEST_THREADS; ++i) {
+    workers[i].allocator = allocator;
+    workers[i].id        = (u8)(i + 1);
+    YORU_EXPECT_TRUE(yoru_thread_spawn(&threads[i], concurrent_arena_test_worker, &workers[i]));
+  }
+  for (usize i = 0; i < CONCURRENT_ARENA_TEST_THREADS; ++i) {
+    YORU_EXPECT_TRUE(yoru_thread_join(&threads[i]));
+  }
+
+  // no two threads got overlapping blocks
+  for (usize i = 0; i < CONCURRENT_ARENA_TEST_THREADS; ++i) {
+    for (usize j = 0; j < CONCURRENT_ARENA_TEST_ALLOCS; ++j) {
+      u8 *block = workers[i].blocks[j];
+      YORU_EXPECT_TRUE(block);
+      YORU_EXPECT_EQ_USIZE(0, (usize)block % YORU_DEFAULT_ALIGNMENT);
+      YORU_EXPECT_EQ_USIZE(workers[i].id, block[0]);
+      YORU_EXPECT_EQ_USIZE(workers[i].id, block[23]);
+    }
+  }
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_concurrent_arena_allocator_reset_test() {
+  Yoru_ConcurrentArenaAllocator *allocator = yoru_concurrent_arena_allocator_make(YORU_MiB(1));
+  YORU_EXPECT_TRUE(allocator);
+  YORU_EXPECT_TRUE(expect_aligned_allocations(allocator));
+
+  // the most recent allocation grows in place
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 100);
+  YORU_EXPECT_TRUE(a.has_value);
+  memset(a.ptr, 0xAB, 100);
+  Yoru_Opt b = yoru_allocator_realloc(allocator, 100, a.ptr, 1000);
+  YORU_EXPECT_TRUE(b.has_value);
+  YORU_EXPECT_TRUE(a.ptr == b.ptr);
+  memset(b.ptr, 0xAB, 1000);
+
+  // reused memory comes back zeroed
+  yoru_concurrent_arena_allocator_reset(allocator);
+  Yoru_Opt c = yoru_allocator_alloc(allocator, YORU_KiB(32));
+  YORU_EXPECT_TRUE(c.has_value);
+  for (usize i = 0; i < YORU_KiB(32); ++i) YORU_EXPECT_EQ_USIZE(0, ((u8 *)c.ptr)[i]);
+
+  // an allocation that does not fit fails without using up the arena
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(allocator, YORU_MiB(2)).has_value);
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc_aligned(allocator, YORU_MiB(2), 64).has_value);
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(allocator, YORU_MiB(1) - YORU_KiB(16)).has_value);
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, 16).has_value);
+  YORU_EXPECT_TRUE(yoru_allocator_alloc(allocator, YORU_KiB(512)).has_value);
+  YORU_EXPECT_TRUE(yoru_allocator_alloc_aligned(allocator, 16, 64).has_value);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+/* ============================================================
+   MODULE: SharedArenaAllocator
+   ============================================================ */
+
+/* both tests fork a second process */
+#if !defined(_WIN32)
+#  define SHARED_ARENA_TEST_NAME "/yoru_shared_arena_test"
+
+typedef struct SharedArenaTestRoot {
+  usize count;
+  usize values_offset;
+} SharedArenaTestRoot;
+
+/// checks the published data from a forked reader, the exit code is the result
+static int shared_arena_read_in_child() {
+  Yoru_SharedArenaAllocator *reader = yoru_shared_arena_allocator_attach(SHARED_ARENA_TEST_NAME, true);
+  if (!reader) return 1;
+  SharedArenaTestRoot *root   = yoru_shared_arena_allocator_get_root(reader);
+  u32                 *values = yoru_shared_arena_allocator_from_offset(reader, root ? root->values_offset : 0);
+  if (!root || !values || root->count != 1000) return 2;
+  for (u32 i = 0; i < 1000; ++i) {
+    if (values[i] != i * 3) return 3;
+  }
+  if (yoru_allocator_alloc(reader, 16).has_value) return 4;
+  yoru_allocator_destroy(reader);
+  return 0;
+}
+
+bool yoru_shared_arena_allocator_attach_test() {
+  Yoru_SharedArenaAllocator *writer = NULL;
+  Yoru_SharedArenaAllocator *other  = NULL;
+  yoru_shared_arena_allocator_unlink(SHARED_ARENA_TEST_NAME);
+
+  writer = yoru_shared_arena_allocator_create(SHARED_ARENA_TEST_NAME, YORU_MiB(1));
+  YORU_EXPECT_TRUE(writer);
+  YORU_EXPECT_TRUE(!yoru_shared_arena_allocator_create(SHARED_ARENA_TEST_NAME, YORU_MiB(1)));
+  YORU_EXPECT_TRUE(!yoru_shared_arena_allocator_get_root(writer));
+
+  Yoru_Opt maybe_root   = yoru_allocator_alloc(writer, sizeof(SharedArenaTestRoot));
+  Yoru_Opt maybe_values = yoru_allocator_alloc(writer, 1000 * sizeof(u32));
+  YORU_EXPECT_TRUE(maybe_root.has_value && maybe_values.has_value);
+  SharedArenaTestRoot *root   = maybe_root.ptr;
+  u32                 *values = maybe_values.ptr;
+  root->count                 = 1000;
+  root->values_offset         = yoru_shared_arena_allocator_to_offset(writer, values);
+  for (u32 i = 0; i < 1000; ++i) values[i] = i * 3;
+  yoru_shared_arena_allocator_set_root(writer, root);
+
+  // a second attachment maps the same memory somewhere else and allocates behind the writer
+  other = yoru_shared_arena_allocator_attach(SHARED_ARENA_TEST_NAME, false);
+  YORU_EXPECT_TRUE(other);
+  SharedArenaTestRoot *other_root = yoru_shared_arena_allocator_get_root(other);
+  YORU_EXPECT_TRUE(other_root && other_root != root);
+  YORU_EXPECT_EQ_USIZE(1000, other_root->count);
+  Yoru_Opt next = yoru_allocator_alloc(other, 16);
+  YORU_EXPECT_TRUE(next.has_value);
+  YORU_EXPECT_TRUE(yoru_shared_arena_allocator_to_offset(other, next.ptr) >= root->values_offset + 1000 * sizeof(u32));
+  YORU_EXPECT_TRUE(!yoru_allocator_alloc(other, YORU_MiB(1)).has_value);
+
+  // values is no longer at the end, growing it has to copy
+  Yoru_Opt grown = yoru_allocator_realloc(writer, 1000 * sizeof(u32), values, 2000 * sizeof(u32));
+  YORU_EXPECT_TRUE(grown.has_value && grown.ptr != values);
+  YORU_EXPECT_EQ_USIZE(999 * 3, ((u32 *)grown.ptr)[999]);
+  YORU_EXPECT_EQ_USIZE(0, ((u32 *)grown.ptr)[1999]);
+
+  // another process attaches read-only and sees everything published before the root
+  pid_t pid = fork();
+  if (pid == 0) _exit(shared_arena_read_in_child());
+  YORU_EXPECT_TRUE(pid > 0);
+  int status = 0;
+  YORU_EXPECT_TRUE(waitpid(pid, &status, 0) == pid);
+  YORU_EXPECT_TRUE(WIFEXITED(status));
+  YORU_EXPECT_EQ_USIZE(0, (usize)WEXITSTATUS(status));
+
+  // the name is gone, attached processes keep their memory
+  YORU_EXPECT_TRUE(yoru_shared_arena_allocator_unlink(SHARED_ARENA_TEST_NAME));
+  YORU_EXPECT_TRUE(!yoru_shared_arena_allocator_attach(SHARED_ARENA_TEST_NAME, true));
+  YORU_EXPECT_EQ_USIZE(1000, other_root->count);
+  yoru_allocator_destroy(other);
+  yoru_allocator_destroy(writer);
+  return true;
+
+err:
+  if (other) yoru_allocator_destroy(other);
+  if (writer) yoru_allocator_destroy(writer);
+  yoru_shared_arena_allocator_unlink(SHARED_ARENA_TEST_NAME);
+  return false;
+}
+
+bool yoru_shared_arena_allocator_fork_test() {
+  // anonymous memory is shared with children forked after creating it
+  Yoru_SharedArenaAllocator *arena = yoru_shared_arena_allocator_create(NULL, YORU_KiB(64));
+  YORU_EXPECT_TRUE(arena);
+  Yoru_Opt maybe_counter = yoru_allocator_alloc(arena, sizeof(u64));
+  YORU_EXPECT_TRUE(maybe_counter.has_value);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    Yoru_Opt child = yoru_allocator_alloc(arena, sizeof(u64));
+    if (!child.has_value) _exit(1);
+    *(u64 *)child.ptr = 42;
+    yoru_shared_arena_allocator_set_root(arena, child.ptr);
+    _exit(0);
+  }
+  YORU_EXPECT_TRUE(pid > 0);
+  int status = 0;
+  YORU_EXPECT_TRUE(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // the child's allocation moved the shared offset, the next one lands behind it
+  u64 *from_child = yoru_shared_arena_allocator_get_root(arena);
+  YORU_EXPECT_TRUE(from_child && *from_child == 42);
+  Yoru_Opt next = yoru_allocator_alloc(arena, sizeof(u64));
+  YORU_EXPECT_TRUE(next.has_value && (u8 *)next.ptr > (u8 *)from_child);
+  yoru_allocator_destroy(arena);
+  return true;
+
+err:
+  if (arena) yoru_allocator_destroy(arena);
+  return false;
+}
+#endif // !_WIN32
+
+/* ============================================================
+   MODULE: TrackingAllocator
+   ============================================================ */
+
+bool yoru_tracking_allocator_stats_test() {
+  Yoru_GlobalAllocator    global    = yoru_global_allocator_make();
+  Yoru_TrackingAllocator *allocator = yoru_tracking_allocator_make(&global, "test");
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_Opt a = yoru_allocator_alloc(allocator, 10);
+  Yoru_Opt b = yoru_allocator_alloc_uninit(allocator, 100);
+  Yoru_Opt c = yoru_allocator_alloc_aligned(allocator, 1000, 256);
+  YORU_EXPECT_TRUE(a.has_value && b.has_value && c.has_value);
+  YORU_EXPECT_EQ_USIZE(0, (usize)c.ptr % 256);
+
+  Yoru_TrackingStats stats = yoru_tracking_allocator_get_stats(allocator);
+  YORU_EXPECT_EQ_USIZE(3, stats.alloc_count);
+  YORU_EXPECT_EQ_USIZE(1110, stats.bytes_in_use);
+  YORU_EXPECT_EQ_USIZE(1, stats.histogram[0]); // <= 16
+  YORU_EXPECT_EQ_USIZE(1, stats.histogram[3]); // <= 128
+  YORU_EXPECT_EQ_USIZE(1, stats.histogram[6]); // <= 1024
+
+  // the aligned block keeps its contents when it grows
+  memset(c.ptr, 0xAB, 1000);
+  Yoru_Opt grown = yoru_allocator_realloc(allocator, 1000, c.ptr, 5000);
+  YORU_EXPECT_TRUE(grown.has_value);
+  for (usize i = 0; i < 1000; ++i) YORU_EXPECT_EQ_USIZE(0xAB, ((u8 *)grown.ptr)[i]);
+
+  yoru_allocator_dealloc(allocator, a.ptr);
+  yoru_allocator_dealloc(allocator, b.ptr);
+  stats = yoru_tracking_allocator_get_stats(allocator);
+  YORU_EXPECT_EQ_USIZE(1, stats.realloc_count);
+  YORU_EXPECT_EQ_USIZE(2, stats.dealloc_count);
+  YORU_EXPECT_EQ_USIZE(5000, stats.bytes_in_use);
+  YORU_EXPECT_EQ_USIZE(5110, stats.peak_bytes_in_use);
+
+  yoru_allocator_dealloc(allocator, grown.ptr);
+  stats = yoru_tracking_allocator_get_stats(allocator);
+  YORU_EXPECT_EQ_USIZE(0, stats.bytes_in_use);
+  YORU_EXPECT_EQ_USIZE(5110, stats.peak_bytes_in_use);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_tracking_allocator_hashmap_test() {
+  Yoru_GlobalAllocator    global    = yoru_global_allocator_make();
+  Yoru_TrackingAllocator *allocator = yoru_tracking_allocator_make(&global, "hashmap");
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_HashMap_T(usize) map = {0};
+  yoru_hashmap_init(&map, allocator);
+  char key[16] = {0};
+  for (usize i = 0; i < 100; ++i) {
+    snprintf(key, sizeof(key), "key-%zu", i);
+    yoru_hashmap_set(&map, key, i);
+  }
+
+  Yoru_TrackingStats stats = yoru_tracking_allocator_get_stats(allocator);
+  YORU_EXPECT_TRUE(stats.realloc_count > 0);
+  YORU_EXPECT_TRUE(stats.bytes_in_use >= 100 * sizeof(map.entries.items[0]));
+  YORU_EXPECT_TRUE(stats.peak_bytes_in_use >= stats.bytes_in_use);
+
+  for (usize i = 0; i < map.keys.size; ++i) free(map.keys.items[i].key);
+  yoru_allocator_dealloc(allocator, map.entries.items);
+  yoru_allocator_dealloc(allocator, map.keys.items);
+  YORU_EXPECT_EQ_USIZE(0, yoru_tracking_allocator_get_stats(allocator).bytes_in_use);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+#endif
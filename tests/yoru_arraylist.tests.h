@@ -0,0 +1,676 @@
+#ifndef __YORU_ARRAYLIST_TESTS_H__
+#define __YORU_ARRAYLIST_TESTS_H__
+
+#include "../yoru.h"
+#include "yoru_test_helpers.h"
+
+/* ============================================================
+   MODULE: ArrayList
+   ============================================================ */
+
+bool yoru_arraylist_init_capacity_test() {
+  Yoru_GlobalAllocator    global    = yoru_global_allocator_make();
+  Yoru_TrackingAllocator *allocator = yoru_tracking_allocator_make(&global, "arraylist");
+  YORU_EXPECT_TRUE(allocator);
+
+  // the requested capacity is what gets allocated, filling it does not grow
+  Yoru_ArrayList_T(u32) xs = {0};
+  yoru_arraylist_init(&xs, allocator, 1000);
+  YORU_EXPECT_EQ_USIZE(1000, xs.capacity);
+  for (u32 i = 0; i < 1000; ++i) yoru_arraylist_append(&xs, i);
+  Yoru_TrackingStats stats = yoru_tracking_allocator_get_stats(allocator);
+  YORU_EXPECT_EQ_USIZE(1000 * sizeof(u32), stats.bytes_in_use);
+  YORU_EXPECT_EQ_USIZE(0, stats.realloc_count);
+  yoru_allocator_dealloc(allocator, xs.items);
+
+  Yoru_ArrayList_T(u32) ys = {0};
+  yoru_arraylist_init(&ys, allocator, 0);
+  YORU_EXPECT_EQ_USIZE(YORU_ARRAYLIST_INITIAL_CAPACITY, ys.capacity);
+
+  // filling a new list writes every slot, none of them are left uninitialized
+  yoru_arraylist_fill(&ys, 7);
+  YORU_EXPECT_EQ_USIZE(ys.capacity, ys.size);
+  for (usize i = 0; i < ys.size; ++i) YORU_EXPECT_EQ_USIZE(7, ys.items[i]);
+  yoru_allocator_dealloc(allocator, ys.items);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_arraylist_reserve_shrink_test() {
+  Yoru_GlobalAllocator    global    = yoru_global_allocator_make();
+  Yoru_TrackingAllocator *allocator = yoru_tracking_allocator_make(&global, "arraylist");
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_ArrayList_T(u64) xs = {0};
+  yoru_arraylist_init(&xs, allocator, 0);
+  for (u64 i = 0; i < 10; ++i) yoru_arraylist_append(&xs, i);
+
+  // grows to exactly the target with one reallocation, and never shrinks
+  yoru_arraylist_reserve(&xs, 5000);
+  YORU_EXPECT_EQ_USIZE(5000, xs.capacity);
+  yoru_arraylist_reserve(&xs, 100);
+  YORU_EXPECT_EQ_USIZE(5000, xs.capacity);
+  for (u64 i = 10; i < 5000; ++i) yoru_arraylist_append(&xs, i);
+  YORU_EXPECT_EQ_USIZE(1, yoru_tracking_allocator_get_stats(allocator).realloc_count);
+  for (u64 i = 0; i < 5000; ++i) YORU_EXPECT_EQ_USIZE(i, xs.items[i]);
+
+  // shrinking keeps the items and releases the rest
+  xs.size = 42;
+  yoru_arraylist_shrink_to_fit(&xs);
+  YORU_EXPECT_EQ_USIZE(42, xs.capacity);
+  YORU_EXPECT_EQ_USIZE(42 * sizeof(u64), yoru_tracking_allocator_get_stats(allocator).bytes_in_use);
+  for (u64 i = 0; i < 42; ++i) YORU_EXPECT_EQ_USIZE(i, xs.items[i]);
+
+  // an empty list keeps room for one item so appending can grow again
+  xs.size = 0;
+  yoru_arraylist_shrink_to_fit(&xs);
+  YORU_EXPECT_EQ_USIZE(1, xs.capacity);
+  for (u64 i = 0; i < 3; ++i) yoru_arraylist_append(&xs, i * 7);
+  YORU_EXPECT_EQ_USIZE(14, xs.items[2]);
+  yoru_allocator_dealloc(allocator, xs.items);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+bool yoru_arraylist_bulk_test() {
+  Yoru_GlobalAllocator    global    = yoru_global_allocator_make();
+  Yoru_TrackingAllocator *allocator = yoru_tracking_allocator_make(&global, "arraylist");
+  YORU_EXPECT_TRUE(allocator);
+
+  Yoru_ArrayList_T(i32) xs    = {0};
+  Yoru_ArrayList_T(i32) other = {0};
+  yoru_arraylist_init(&xs, allocator, 4);
+  yoru_arraylist_init(&other, allocator, 0);
+
+  // a batch larger than double the capacity grows exactly once
+  i32 batch[100] = {0};
+  for (i32 i = 0; i < 100; ++i) batch[i] = i;
+  yoru_arraylist_append_many(&xs, batch, 100);
+  YORU_EXPECT_EQ_USIZE(100, xs.size);
+  YORU_EXPECT_EQ_USIZE(100, xs.capacity);
+  YORU_EXPECT_EQ_USIZE(1, yoru_tracking_allocator_get_stats(allocator).realloc_count);
+  yoru_arraylist_append_many(&xs, batch, 0);
+  YORU_EXPECT_EQ_USIZE(100, xs.size);
+
+  for (i32 i = 0; i < 10; ++i) yoru_arraylist_append(&other, -i - 1);
+  yoru_arraylist_extend(&xs, &other);
+  YORU_EXPECT_EQ_USIZE(110, xs.size);
+  YORU_EXPECT_EQ_USIZE(200, xs.capacity);
+  YORU_EXPECT_EQ_USIZE(99, (usize)xs.items[99]);
+  YORU_EXPECT_EQ_USIZE(10, (usize)-xs.items[109]);
+
+  // [0, 1, 2, 3, 4, ...] -> [0, 1, -1, -2, -3, 2, 3, ...]
+  yoru_arraylist_insert_range(&xs, 2, other.items, 3);
+  YORU_EXPECT_EQ_USIZE(113, xs.size);
+  i32 expected_insert[] = {0, 1, -1, -2, -3, 2, 3};
+  YORU_EXPECT_EQ_MEM(expected_insert, xs.items, sizeof(expected_insert));
+  yoru_arraylist_insert_range(&xs, xs.size, batch, 2);
+  YORU_EXPECT_EQ_USIZE(1, (usize)xs.items[xs.size - 1]);
+
+  // takes the inserted range out again and the two appended items at the end
+  yoru_arraylist_remove_range(&xs, 2, 3);
+  yoru_arraylist_remove_range(&xs, xs.size - 2, 2);
+  YORU_EXPECT_EQ_USIZE(110, xs.size);
+  for (i32 i = 0; i < 100; ++i) YORU_EXPECT_EQ_USIZE((usize)i, (usize)xs.items[i]);
+  yoru_arraylist_remove_range(&xs, 0, 0);
+  YORU_EXPECT_EQ_USIZE(110, xs.size);
+
+  // the last item moves into the hole
+  yoru_arraylist_swap_remove(&xs, 0);
+  YORU_EXPECT_EQ_USIZE(109, xs.size);
+  YORU_EXPECT_EQ_USIZE(10, (usize)-xs.items[0]);
+  yoru_arraylist_swap_remove(&xs, xs.size - 1);
+  YORU_EXPECT_EQ_USIZE(108, xs.size);
+  YORU_EXPECT_EQ_USIZE(8, (usize)-xs.items[xs.size - 1]);
+
+  yoru_allocator_dealloc(allocator, xs.items);
+  yoru_allocator_dealloc(allocator, other.items);
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+/* ============================================================
+   MODULE: VirtualArrayList
+   ============================================================ */
+
+bool yoru_virtual_arraylist_growth_test() {
+  Yoru_VirtualArrayList_T(u64) xs = {0};
+  yoru_virtual_arraylist_init(&xs, 1000000);
+  YORU_EXPECT_TRUE(xs.items);
+  YORU_EXPECT_EQ_USIZE(0, xs.capacity);
+
+  // growing commits in place, so the items never move
+  u64 *first = xs.items;
+  for (u64 i = 0; i < 100000; ++i) yoru_virtual_arraylist_append(&xs, i);
+  YORU_EXPECT_TRUE(xs.items == first);
+  YORU_EXPECT_TRUE(xs.capacity >= 100000 && xs.capacity < 200000);
+  for (u64 i = 0; i < 100000; ++i) YORU_EXPECT_EQ_USIZE(i, xs.items[i]);
+
+  u64 batch[1000] = {0};
+  for (u64 i = 0; i < 1000; ++i) batch[i] = i * 2;
+  yoru_virtual_arraylist_append_many(&xs, batch, 1000);
+  YORU_EXPECT_EQ_USIZE(101000, xs.size);
+  YORU_EXPECT_EQ_USIZE(1998, xs.items[100999]);
+
+  // the whole reservation can be committed, but not more
+  yoru_virtual_arraylist_reserve(&xs, 1000000);
+  YORU_EXPECT_TRUE(xs.capacity >= 1000000);
+  YORU_EXPECT_TRUE(!__yoru_virtual_arraylist_commit(&xs.vmem, xs.vmem.addr_space_size + 1));
+
+  // shrinking releases the pages above the items, growing again reuses them
+  xs.size = 10;
+  yoru_virtual_arraylist_shrink_to_fit(&xs);
+  YORU_EXPECT_TRUE(xs.capacity >= 10 && xs.capacity * sizeof(u64) <= yoru_get_page_size());
+  YORU_EXPECT_EQ_USIZE(9, xs.items[9]);
+  yoru_virtual_arraylist_append(&xs, 42);
+  for (u64 i = 0; i < 1000; ++i) yoru_virtual_arraylist_append(&xs, i);
+  YORU_EXPECT_TRUE(xs.items == first);
+  YORU_EXPECT_EQ_USIZE(42, xs.items[10]);
+
+  yoru_virtual_arraylist_destroy(&xs);
+  YORU_EXPECT_TRUE(!xs.items && !xs.vmem.base);
+  return true;
+
+err:
+  if (xs.vmem.base) yoru_virtual_arraylist_destroy(&xs);
+  return false;
+}
+
+/* ============================================================
+   MODULE: Deque
+   ============================================================ */
+
+bool yoru_deque_wrap_around_test() {
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  Yoru_Deque_T(i32) dq        = {0};
+  yoru_deque_init(&dq, &global, 5);
+  YORU_EXPECT_EQ_USIZE(8, dq.capacity);
+
+  // a FIFO that never holds more than its capacity moves around the buffer
+  // without growing
+  i32 value = 0;
+  for (i32 i = 0; i < 3; ++i) yoru_deque_push_back(&dq, i);
+  for (i32 i = 3; i < 100; ++i) {
+    yoru_deque_push_back(&dq, i);
+    yoru_deque_pop_front(&dq, &value);
+    YORU_EXPECT_EQ_USIZE((usize)i - 3, (usize)value);
+  }
+  YORU_EXPECT_EQ_USIZE(8, dq.capacity);
+  YORU_EXPECT_EQ_USIZE(3, dq.size);
+
+  // growing while wrapped keeps the order
+  dq.size = 0;
+  dq.head = 6;
+  for (i32 i = 0; i < 8; ++i) yoru_deque_push_back(&dq, i);
+  yoru_deque_push_back(&dq, 8);
+  YORU_EXPECT_EQ_USIZE(16, dq.capacity);
+  for (i32 i = 0; i < 9; ++i) YORU_EXPECT_EQ_USIZE((usize)i, (usize)yoru_deque_at(&dq, i));
+
+  // both ends
+  yoru_deque_push_front(&dq, -1);
+  yoru_deque_push_front(&dq, -2);
+  YORU_EXPECT_EQ_USIZE(11, dq.size);
+  yoru_deque_pop_front(&dq, &value);
+  YORU_EXPECT_EQ_USIZE(2, (usize)-value);
+  yoru_deque_pop_back(&dq, &value);
+  YORU_EXPECT_EQ_USIZE(8, (usize)value);
+  yoru_deque_pop_front(&dq, &value);
+  YORU_EXPECT_EQ_USIZE(1, (usize)-value);
+  YORU_EXPECT_EQ_USIZE(8, dq.size);
+
+  yoru_deque_clear(&dq);
+  YORU_EXPECT_TRUE(yoru_deque_is_empty(&dq));
+  yoru_deque_destroy(&dq);
+  YORU_EXPECT_TRUE(!dq.items);
+  return true;
+
+err:
+  yoru_deque_destroy(&dq);
+  return false;
+}
+
+bool yoru_deque_batch_test() {
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  Yoru_Deque_T(u64) dq        = {0};
+  yoru_deque_init(&dq, &global, 16);
+
+  u64 in[64]  = {0};
+  u64 out[64] = {0};
+  for (u64 i = 0; i < 64; ++i) in[i] = i * 10;
+
+  // the pushed span wraps around the end, the popped one as well
+  u64 value = 0;
+  for (u64 i = 0; i < 12; ++i) yoru_deque_push_back(&dq, i);
+  for (u64 i = 0; i < 12; ++i) yoru_deque_pop_front(&dq, &value);
+  yoru_deque_push_back_many(&dq, in, 10);
+  YORU_EXPECT_EQ_USIZE(16, dq.capacity);
+  YORU_EXPECT_TRUE(dq.head + dq.size > dq.capacity);
+  usize popped = 0;
+  yoru_deque_pop_front_many(&dq, out, 7, &popped);
+  YORU_EXPECT_EQ_USIZE(7, popped);
+  YORU_EXPECT_EQ_MEM(in, out, 7 * sizeof(u64));
+
+  // more than fits grows once, popping more than there is takes what is there
+  yoru_deque_push_back_many(&dq, in + 10, 54);
+  YORU_EXPECT_EQ_USIZE(57, dq.size);
+  YORU_EXPECT_EQ_USIZE(64, dq.capacity);
+  yoru_deque_pop_front_many(&dq, out, 64, &popped);
+  YORU_EXPECT_EQ_USIZE(57, popped);
+  YORU_EXPECT_EQ_MEM(in + 7, out, 57 * sizeof(u64));
+  YORU_EXPECT_TRUE(yoru_deque_is_empty(&dq));
+
+  yoru_deque_destroy(&dq);
+  return true;
+
+err:
+  yoru_deque_destroy(&dq);
+  return false;
+}
+
+/* ============================================================
+   MODULE: SmallArrayList
+   ============================================================ */
+
+typedef Yoru_SmallArrayList_T(u32, 4) SmallU32List;
+
+bool yoru_small_arraylist_spill_test() {
+  Yoru_GlobalAllocator    global    = yoru_global_allocator_make();
+  Yoru_TrackingAllocator *allocator = yoru_tracking_allocator_make(&global, "small arraylist");
+  YORU_EXPECT_TRUE(allocator);
+
+  SmallU32List xs = {0};
+  yoru_small_arraylist_init(&xs, allocator);
+  YORU_EXPECT_EQ_USIZE(4, xs.capacity);
+
+  // filling the inline items does not allocate
+  for (u32 i = 0; i < 4; ++i) yoru_small_arraylist_append(&xs, i);
+  YORU_EXPECT_TRUE(yoru_small_arraylist_is_inline(&xs));
+  YORU_EXPECT_EQ_USIZE(0, yoru_tracking_allocator_get_stats(allocator).alloc_count);
+
+  // a copy is independent, nothing points into the original
+  SmallU32List copy    = xs;
+  copy.inline_items[0] = 42;
+  YORU_EXPECT_EQ_USIZE(0, yoru_small_arraylist_items(&xs)[0]);
+  YORU_EXPECT_EQ_USIZE(42, yoru_small_arraylist_items(&copy)[0]);
+
+  // one more spills to the allocator and keeps growing there
+  for (u32 i = 4; i < 100; ++i) yoru_small_arraylist_append(&xs, i);
+  YORU_EXPECT_TRUE(!yoru_small_arraylist_is_inline(&xs));
+  YORU_EXPECT_EQ_USIZE(1, yoru_tracking_allocator_get_stats(allocator).alloc_count);
+  YORU_EXPECT_EQ_USIZE(128, xs.capacity);
+  for (u32 i = 0; i < 100; ++i) YORU_EXPECT_EQ_USIZE(i, yoru_small_arraylist_items(&xs)[i]);
+
+  // shrinking to what fits inline moves the items back and frees the allocation
+  yoru_small_arraylist_resize(&xs, 3);
+  YORU_EXPECT_TRUE(yoru_small_arraylist_is_inline(&xs));
+  YORU_EXPECT_EQ_USIZE(3, xs.size);
+  YORU_EXPECT_EQ_USIZE(4, xs.capacity);
+  YORU_EXPECT_EQ_USIZE(2, yoru_small_arraylist_items(&xs)[2]);
+  YORU_EXPECT_EQ_USIZE(0, yoru_tracking_allocator_get_stats(allocator).bytes_in_use);
+
+  yoru_small_arraylist_resize(&xs, 10);
+  yoru_small_arraylist_destroy(&xs);
+  YORU_EXPECT_TRUE(yoru_small_arraylist_is_inline(&xs));
+  YORU_EXPECT_EQ_USIZE(0, xs.size);
+  YORU_EXPECT_EQ_USIZE(0, yoru_tracking_allocator_get_stats(allocator).bytes_in_use);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+/* ============================================================
+   MODULE: StructOfArrays
+   ============================================================ */
+
+#define SOA_TEST_FIELDS(X) X(u64, id) X(u8, kind) X(f64, value)
+YORU_SOA_DEFINE(SoaTestRecords, soa_test_records, SOA_TEST_FIELDS)
+
+/* the global allocator, but allocations fail once `budget` is used up */
+typedef struct SoaTestFailingCtx {
+  usize budget;
+  usize live;
+} SoaTestFailingCtx;
+
+static Yoru_Opt soa_test_failing_alloc(anyptr ctx, usize size) {
+  SoaTestFailingCtx *failing = ctx;
+  if (failing->budget == 0) return yoru_opt_none();
+  --failing->budget;
+  ++failing->live;
+  return __yoru_global_allocator_alloc(NULL, size);
+}
+
+static Yoru_Opt soa_test_failing_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  (void)alignment;
+  return soa_test_failing_alloc(ctx, size);
+}
+
+static void soa_test_failing_dealloc(anyptr ctx, anyptr ptr) {
+  SoaTestFailingCtx *failing = ctx;
+  --failing->live;
+  __yoru_global_allocator_dealloc(NULL, ptr);
+}
+
+static Yoru_Opt soa_test_failing_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  (void)ctx;
+  return __yoru_global_allocator_realloc(NULL, old_size, old_ptr, new_size);
+}
+
+static void soa_test_failing_destroy(anyptr ctx) {
+  (void)ctx;
+}
+
+static const Yoru_AllocatorVTable soa_test_failing_vtable = {
+    .alloc         = soa_test_failing_alloc,
+    .alloc_uninit  = soa_test_failing_alloc,
+    .alloc_aligned = soa_test_failing_alloc_aligned,
+    .dealloc       = soa_test_failing_dealloc,
+    .realloc       = soa_test_failing_realloc,
+    .destroy       = soa_test_failing_destroy,
+};
+
+bool yoru_soa_columns_test() {
+  Yoru_GlobalAllocator global  = yoru_global_allocator_make();
+  SoaTestRecords       records = {0};
+  YORU_EXPECT_TRUE(soa_test_records_init(&records, &global, 4));
+
+  for (u64 i = 0; i < 100; ++i) {
+    YORU_EXPECT_TRUE(soa_test_records_append(&records, (SoaTestRecordsRow){.id = i, .kind = i % 3, .value = i * 0.5}));
+  }
+  YORU_EXPECT_EQ_USIZE(100, records.size);
+  YORU_EXPECT_EQ_USIZE(128, records.capacity);
+
+  // every field is its own contiguous array
+  u64 kind_two = 0;
+  for (usize i = 0; i < records.size; ++i) kind_two += records.kind[i] == 2;
+  YORU_EXPECT_EQ_USIZE(33, kind_two);
+  YORU_EXPECT_EQ_USIZE(99, records.id[99]);
+
+  SoaTestRecordsRow row = soa_test_records_get(&records, 42);
+  YORU_EXPECT_EQ_USIZE(42, row.id);
+  YORU_EXPECT_EQ_USIZE(0, row.kind);
+  YORU_EXPECT_TRUE(row.value == 21.0);
+  soa_test_records_set(&records, 42, (SoaTestRecordsRow){.id = 7, .kind = 1, .value = -1.0});
+  YORU_EXPECT_EQ_USIZE(1, records.kind[42]);
+  YORU_EXPECT_TRUE(records.value[42] == -1.0);
+
+  // shrinking cuts off the rows that do not fit anymore
+  YORU_EXPECT_TRUE(soa_test_records_resize(&records, 10));
+  YORU_EXPECT_EQ_USIZE(10, records.size);
+  YORU_EXPECT_EQ_USIZE(9, records.id[9]);
+
+  soa_test_records_destroy(&records);
+  YORU_EXPECT_TRUE(!records.id && !records.kind && !records.value);
+  return true;
+
+err:
+  if (records.allocator) soa_test_records_destroy(&records);
+  return false;
+}
+
+bool yoru_soa_resize_failure_test() {
+  SoaTestFailingCtx failing   = {.budget = USIZE_MAX};
+  Yoru_Allocator    allocator = {.vtable = &soa_test_failing_vtable, .ctx = &failing};
+  SoaTestRecords    records   = {0};
+  YORU_EXPECT_TRUE(soa_test_records_init(&records, &allocator, 64));
+  for (u64 i = 0; i < 50; ++i) {
+    YORU_EXPECT_TRUE(soa_test_records_append(&records, (SoaTestRecordsRow){.id = i, .kind = 1, .value = i * 2.0}));
+  }
+
+  // the last column fails, nothing changes and the new columns are freed
+  failing.budget = 2;
+  YORU_EXPECT_TRUE(!soa_test_records_resize(&records, 10));
+  YORU_EXPECT_EQ_USIZE(50, records.size);
+  YORU_EXPECT_EQ_USIZE(64, records.capacity);
+  YORU_EXPECT_EQ_USIZE(3, failing.live);
+  for (u64 i = 0; i < 50; ++i) {
+    SoaTestRecordsRow row = soa_test_records_get(&records, i);
+    YORU_EXPECT_EQ_USIZE(i, row.id);
+    YORU_EXPECT_TRUE(row.value == i * 2.0);
+  }
+  soa_test_records_set(&records, 49, (SoaTestRecordsRow){.id = 1, .kind = 2, .value = 3.0});
+
+  failing.budget = USIZE_MAX;
+  YORU_EXPECT_TRUE(soa_test_records_resize(&records, 10));
+  YORU_EXPECT_EQ_USIZE(10, records.size);
+  YORU_EXPECT_EQ_USIZE(9, records.id[9]);
+  YORU_EXPECT_EQ_USIZE(3, failing.live);
+
+  soa_test_records_destroy(&records);
+  YORU_EXPECT_EQ_USIZE(0, failing.live);
+  return true;
+
+err:
+  if (records.allocator) soa_test_records_destroy(&records);
+  return false;
+}
+
+/* ============================================================
+   MODULE: Sort
+   ============================================================ */
+
+#define SORT_TEST_U64_LESS(a, b) ((a) < (b))
+#define SORT_TEST_U64_KEY(x) (x)
+YORU_SORT_DEFINE(sort_test_u64s, u64, SORT_TEST_U64_LESS)
+YORU_RADIX_SORT_DEFINE(sort_test_u64s, u64, SORT_TEST_U64_KEY)
+
+typedef struct SortTestItem {
+  f64 key;
+  u32 order; // position before sorting, to check stability
+} SortTestItem;
+
+#define SORT_TEST_ITEM_LESS(a, b) ((a).key < (b).key)
+#define SORT_TEST_ITEM_KEY(x) yoru_sort_key_f64((x).key)
+YORU_SORT_DEFINE(sort_test_items, SortTestItem, SORT_TEST_ITEM_LESS)
+YORU_RADIX_SORT_DEFINE(sort_test_items, SortTestItem, SORT_TEST_ITEM_KEY)
+
+bool yoru_sort_introsort_test() {
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  Yoru_ArrayList_T(u64) xs    = {0};
+  yoru_arraylist_init(&xs, &global, 10000);
+
+  // random values with many duplicates, then already sorted and reversed
+  // input, which are the worst cases of a naive quicksort
+  u64 seed = 0x9E3779B97F4A7C15ull;
+  for (usize i = 0; i < 10000; ++i) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    yoru_arraylist_append(&xs, seed % 1000);
+  }
+  for (usize round = 0; round < 3; ++round) {
+    if (round == 2) {
+      for (usize i = 0; i < xs.size; ++i) xs.items[i] = xs.size - i;
+    }
+    yoru_arraylist_sort(&xs, sort_test_u64s);
+    for (usize i = 1; i < xs.size; ++i) YORU_EXPECT_TRUE(xs.items[i - 1] <= xs.items[i]);
+  }
+
+  // [1, 2, 2, 2, 5]
+  u64 small[] = {2, 5, 2, 1, 2};
+  sort_test_u64s_sort(small, 5);
+  YORU_EXPECT_EQ_USIZE(1, sort_test_u64s_lower_bound(small, 5, 2));
+  YORU_EXPECT_EQ_USIZE(4, sort_test_u64s_upper_bound(small, 5, 2));
+  YORU_EXPECT_EQ_USIZE(4, sort_test_u64s_lower_bound(small, 5, 3));
+  YORU_EXPECT_EQ_USIZE(0, sort_test_u64s_upper_bound(small, 5, 0));
+  YORU_EXPECT_EQ_USIZE(5, sort_test_u64s_lower_bound(small, 5, 6));
+  YORU_EXPECT_EQ_USIZE(0, sort_test_u64s_lower_bound(small, 0, 6));
+
+  usize first = yoru_arraylist_lower_bound(&xs, sort_test_u64s, 500);
+  usize last  = yoru_arraylist_upper_bound(&xs, sort_test_u64s, 500);
+  YORU_EXPECT_EQ_USIZE(1, last - first);
+  YORU_EXPECT_EQ_USIZE(500, xs.items[first]);
+
+  yoru_allocator_dealloc(&global, xs.items);
+  return true;
+
+err:
+  yoru_allocator_dealloc(&global, xs.items);
+  return false;
+}
+
+bool yoru_sort_radix_test() {
+  Yoru_GlobalAllocator    global    = yoru_global_allocator_make();
+  Yoru_TrackingAllocator *allocator = yoru_tracking_allocator_make(&global, "radix sort");
+  YORU_EXPECT_TRUE(allocator);
+
+  u64 values[1000] = {0};
+  for (u64 i = 0; i < 1000; ++i) values[i] = (i * 7919) % 1000 + (i % 3 == 0 ? (u64)1 << 60 : 0);
+  YORU_EXPECT_TRUE(sort_test_u64s_radix_sort(values, 1000, allocator));
+  for (usize i = 1; i < 1000; ++i) YORU_EXPECT_TRUE(values[i - 1] <= values[i]);
+  YORU_EXPECT_EQ_USIZE(0, yoru_tracking_allocator_get_stats(allocator).bytes_in_use);
+
+  // negative, positive and equal float keys, equal keys keep their order
+  Yoru_ArrayList_T(SortTestItem) items = {0};
+  yoru_arraylist_init(&items, allocator, 0);
+  f64 keys[] = {3.5, -1.0, 0.0, -250.25, 3.5, 1e300, -0.5, 3.5, -1e300, 2.0};
+  for (u32 i = 0; i < 10; ++i) yoru_arraylist_append(&items, ((SortTestItem){.key = keys[i], .order = i}));
+  YORU_EXPECT_TRUE(yoru_arraylist_radix_sort(&items, sort_test_items, allocator));
+
+  f64 expected[] = {-1e300, -250.25, -1.0, -0.5, 0.0, 2.0, 3.5, 3.5, 3.5, 1e300};
+  for (usize i = 0; i < 10; ++i) YORU_EXPECT_TRUE(items.items[i].key == expected[i]);
+  YORU_EXPECT_EQ_USIZE(0, items.items[6].order);
+  YORU_EXPECT_EQ_USIZE(4, items.items[7].order);
+  YORU_EXPECT_EQ_USIZE(7, items.items[8].order);
+
+  // the introsort agrees on the keys
+  for (u32 i = 0; i < 10; ++i) items.items[i] = (SortTestItem){.key = keys[i], .order = i};
+  yoru_arraylist_sort(&items, sort_test_items);
+  for (usize i = 0; i < 10; ++i) YORU_EXPECT_TRUE(items.items[i].key == expected[i]);
+  yoru_allocator_dealloc(allocator, items.items);
+
+  yoru_allocator_destroy(allocator);
+  return true;
+
+err:
+  if (allocator) yoru_allocator_destroy(allocator);
+  return false;
+}
+
+/* ============================================================
+   MODULE: Parallel
+   ============================================================ */
+
+#define PARALLEL_TEST_COUNT (200000)
+#define PARALLEL_TEST_THREADS (4)
+
+#define PARALLEL_TEST_SCALE(x, ctx) (*(x) *= *(u64 *)(ctx))
+YORU_PARALLEL_FOR_EACH_DEFINE(parallel_test_scale, u64, PARALLEL_TEST_SCALE)
+
+#define PARALLEL_TEST_SQUARE(x, ctx) ((u64)(x) * (u64)(x))
+YORU_PARALLEL_MAP_DEFINE(parallel_test_square, u32, u64, PARALLEL_TEST_SQUARE)
+
+#define PARALLEL_TEST_ADD(a, b) ((a) + (b))
+YORU_PARALLEL_REDUCE_DEFINE(parallel_test_sum, u64, PARALLEL_TEST_ADD)
+
+#define PARALLEL_TEST_IS_MULTIPLE(x, ctx) ((x) % *(u64 *)(ctx) == 0)
+YORU_PARALLEL_FILTER_DEFINE(parallel_test_multiples, u64, PARALLEL_TEST_IS_MULTIPLE)
+
+static void parallel_test_count_chunk(anyptr ctx, usize chunk, usize begin, usize end) {
+  _Atomic u32 *visits = ctx;
+  (void)chunk;
+  for (usize i = begin; i < end; ++i) atomic_fetch_add(&visits[i], 1);
+}
+
+bool yoru_parallel_thread_pool_test() {
+  Yoru_ThreadPool *pool = yoru_thread_pool_make(PARALLEL_TEST_THREADS);
+  YORU_EXPECT_TRUE(pool);
+  YORU_EXPECT_EQ_USIZE(PARALLEL_TEST_THREADS, yoru_thread_pool_thread_count(pool));
+
+  // every item is visited exactly once, for uneven chunks and over many jobs
+  static _Atomic u32 visits[1000];
+  usize              chunk_sizes[] = {1, 7, 64, 999, 1000, 5000};
+  for (usize run = 0; run < 100; ++run) {
+    for (usize i = 0; i < 1000; ++i) atomic_store(&visits[i], 0);
+    yoru_thread_pool_run(pool, 1000, chunk_sizes[run % 6], parallel_test_count_chunk, visits);
+    for (usize i = 0; i < 1000; ++i) YORU_EXPECT_EQ_USIZE(1, atomic_load(&visits[i]));
+  }
+
+  // no items, no chunks
+  yoru_thread_pool_run(pool, 0, 16, parallel_test_count_chunk, visits);
+  YORU_EXPECT_EQ_USIZE(1, atomic_load(&visits[0]));
+
+  yoru_thread_pool_destroy(pool);
+  return true;
+
+err:
+  yoru_thread_pool_destroy(pool);
+  return false;
+}
+
+bool yoru_parallel_algorithms_test() {
+  Yoru_GlobalAllocator global = yoru_global_allocator_make();
+  Yoru_ThreadPool     *pool   = yoru_thread_pool_make(PARALLEL_TEST_THREADS);
+  YORU_EXPECT_TRUE(pool);
+
+  Yoru_ArrayList_T(u32) xs        = {0};
+  Yoru_ArrayList_T(u64) squares   = {0};
+  Yoru_ArrayList_T(u64) multiples = {0};
+  yoru_arraylist_init(&xs, &global, PARALLEL_TEST_COUNT);
+  yoru_arraylist_init(&squares, &global, 0);
+  yoru_arraylist_init(&multiples, &global, 0);
+  for (u32 i = 0; i < PARALLEL_TEST_COUNT; ++i) yoru_arraylist_append(&xs, i);
+
+  yoru_arraylist_parallel_map(pool, &xs, &squares, parallel_test_square, NULL);
+  YORU_EXPECT_EQ_USIZE(PARALLEL_TEST_COUNT, squares.size);
+  for (usize i = 0; i < squares.size; ++i) YORU_EXPECT_TRUE(squares.items[i] == (u64)i * i);
+
+  u64 factor = 3;
+  yoru_arraylist_parallel_for_each(pool, &squares, parallel_test_scale, &factor);
+  u64 expected_sum = 0;
+  for (u64 i = 0; i < PARALLEL_TEST_COUNT; ++i) expected_sum += 3 * i * i;
+
+  // the same result with and without threads
+  u64 sum = 0;
+  YORU_EXPECT_TRUE(yoru_arraylist_parallel_reduce(pool, &squares, parallel_test_sum, 7, &sum, &global));
+  YORU_EXPECT_TRUE(sum == expected_sum + 7);
+  YORU_EXPECT_TRUE(yoru_arraylist_parallel_reduce(NULL, &squares, parallel_test_sum, 7, &sum, &global));
+  YORU_EXPECT_TRUE(sum == expected_sum + 7);
+
+  // the kept items are in their original order
+  u64 divisor = 5;
+  yoru_arraylist_parallel_filter(pool, &squares, &multiples, parallel_test_multiples, &divisor, &global);
+  usize kept = 0;
+  for (usize i = 0; i < squares.size; ++i) {
+    if (squares.items[i] % 5 != 0) continue;
+    YORU_EXPECT_TRUE(multiples.items[kept] == squares.items[i]);
+    ++kept;
+  }
+  YORU_EXPECT_EQ_USIZE(kept, multiples.size);
+
+  // empty lists
+  squares.size = 0;
+  YORU_EXPECT_TRUE(yoru_arraylist_parallel_reduce(pool, &squares, parallel_test_sum, 7, &sum, &global));
+  YORU_EXPECT_TRUE(sum == 7);
+  yoru_arraylist_parallel_filter(pool, &squares, &multiples, parallel_test_multiples, &divisor, &global);
+  YORU_EXPECT_EQ_USIZE(0, multiples.size);
+
+  yoru_allocator_dealloc(&global, xs.items);
+  yoru_allocator_dealloc(&global, squares.items);
+  yoru_allocator_dealloc(&global, multiples.items);
+  yoru_thread_pool_destroy(pool);
+  return true;
+
+err:
+  yoru_thread_pool_destroy(pool);
+  return false;
+}
+
+#endif
@@ -1,5 +1,7 @@
 #define YORU_IMPL
 #include "../yoru.h"
+#include "yoru_allocators.tests.h"
+#include "yoru_arraylist.tests.h"
 #include "yoru_stringview.tests.h"
 
 #include <stdbool.h>
@@ -37,6 +39,54 @@ int main(void) {
       {"stringview_trim", yoru_stringview_trim_test},
       {"stringview_trim_while", yoru_stringview_trim_while_test},
       {"stringview_split_by_char", yoru_stringview_split_by_char_test},
+      {"allocators_alloc_aligned", yoru_allocators_alloc_aligned_test},
+      {"allocators_optional_vtable_slots", yoru_allocators_optional_vtable_slots_test},
+      {"allocators_realloc", yoru_allocators_realloc_test},
+      {"arena_allocator_realloc_in_place", yoru_arena_allocator_realloc_in_place_test},
+      {"arena_allocator_alloc_uninit", yoru_arena_allocator_alloc_uninit_test},
+      {"arena_allocator_arraylist", yoru_arena_allocator_arraylist_test},
+      {"arena_allocator_marker", yoru_arena_allocator_marker_test},
+      {"chained_arena_allocator_growth", yoru_chained_arena_allocator_growth_test},
+      {"vmem_decommit", yoru_vmem_decommit_test},
+      {"vmem_numa_policy", yoru_vmem_numa_policy_test},
+      {"virtual_arena_allocator_stringbuilder", yoru_virtual_arena_allocator_stringbuilder_test},
+      {"virtual_arena_allocator_scratch", yoru_virtual_arena_allocator_scratch_test},
+      {"virtual_arena_allocator_commit_growth", yoru_virtual_arena_allocator_commit_growth_test},
+      {"virtual_arena_allocator_decommit", yoru_virtual_arena_allocator_decommit_test},
+      {"virtual_arena_allocator_per_node", yoru_virtual_arena_allocator_per_node_test},
+      {"persistent_arena_allocator_reopen", yoru_persistent_arena_allocator_reopen_test},
+      {"static_dispatch_arena", yoru_static_dispatch_arena_test},
+      {"static_dispatch_fallback", yoru_static_dispatch_fallback_test},
+      {"slab_allocator_reuse", yoru_slab_allocator_reuse_test},
+      {"slab_allocator_realloc", yoru_slab_allocator_realloc_test},
+      {"slab_allocator_exhaustion", yoru_slab_allocator_exhaustion_test},
+      {"buddy_allocator_split_merge", yoru_buddy_allocator_split_merge_test},
+      {"buddy_allocator_realloc", yoru_buddy_allocator_realloc_test},
+      {"tlsf_allocator_coalesce", yoru_tlsf_allocator_coalesce_test},
+      {"tlsf_allocator_vmem", yoru_tlsf_allocator_vmem_test},
+      {"thread_caching_allocator_reuse", yoru_thread_caching_allocator_reuse_test},
+      {"thread_caching_allocator_threads", yoru_thread_caching_allocator_threads_test},
+      {"concurrent_arena_allocator_threads", yoru_concurrent_arena_allocator_threads_test},
+      {"concurrent_arena_allocator_reset", yoru_concurrent_arena_allocator_reset_test},
+#if !defined(_WIN32)
+      {"shared_arena_allocator_attach", yoru_shared_arena_allocator_attach_test},
+      {"shared_arena_allocator_fork", yoru_shared_arena_allocator_fork_test},
+#endif
+      {"tracking_allocator_stats", yoru_tracking_allocator_stats_test},
+      {"tracking_allocator_hashmap", yoru_tracking_allocator_hashmap_test},
+      {"arraylist_init_capacity", yoru_arraylist_init_capacity_test},
+      {"arraylist_reserve_shrink", yoru_arraylist_reserve_shrink_test},
+      {"arraylist_bulk", yoru_arraylist_bulk_test},
+      {"virtual_arraylist_growth", yoru_virtual_arraylist_growth_test},
+      {"deque_wrap_around", yoru_deque_wrap_around_test},
+      {"deque_batch", yoru_deque_batch_test},
+      {"small_arraylist_spill", yoru_small_arraylist_spill_test},
+      {"soa_columns", yoru_soa_columns_test},
+      {"soa_resize_failure", yoru_soa_resize_failure_test},
+      {"sort_introsort", yoru_sort_introsort_test},
+      {"sort_radix", yoru_sort_radix_test},
+      {"parallel_thread_pool", yoru_parallel_thread_pool_test},
+      {"parallel_algorithms", yoru_parallel_algorithms_test},
   };
 
   usize test_count = sizeof(tests) / sizeof(tests[0]);
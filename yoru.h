@@ -4,6 +4,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -12,10 +13,18 @@
 #include <string.h>
 
 #if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+#  include <pthread.h>
+#  include <fcntl.h>
+#  include <sched.h>
 #  include <sys/mman.h>
+#  include <sys/stat.h>
 #  include <unistd.h>
 #endif
 
+#if defined(__linux__)
+#  include <sys/syscall.h>
+#endif
+
 #if defined(_WIN32)
 #  include <windows.h>
 #endif
@@ -48,6 +57,14 @@
 #define YORU_TODO(__msg) assert(false && __msg)
 #define YORU_NAMEOF(__x) (#__x)
 
+#define YORU_B(_n) ((usize)1 * (_n))
+#define YORU_KB(_n) ((_n) * YORU_B(1000))    // 1 KB = 1000 bytes
+#define YORU_KiB(_n) ((_n) * YORU_B(1024))   // 1 KiB = 1024 bytes
+#define YORU_MB(_n) ((_n) * YORU_KB(1000))   // 1 MB = 1000 KB
+#define YORU_MiB(_n) ((_n) * YORU_KiB(1024)) // 1 MiB = 1024 KiB
+#define YORU_GB(_n) ((_n) * YORU_MB(1000))   // 1 GB = 1000 MB
+#define YORU_GiB(_n) ((_n) * YORU_MiB(1024)) // 1 GiB = 1024 MiB
+
 typedef int8_t        i8;
 typedef uint8_t       u8;
 typedef int16_t       i16;
@@ -130,18 +147,30 @@ anyptr yoru_ref_get(const Yoru_Ref *ref) {
    MODULE: Allocators
    ============================================================ */
 
+/// @brief alignment of every allocation that does not ask for a specific one
+#define YORU_DEFAULT_ALIGNMENT (_Alignof(max_align_t))
+
+/// @brief size of a cache line on common x86-64 and arm64 cpus
+#define YORU_CACHE_LINE_SIZE (64)
+
 typedef Yoru_Opt (*Yoru_Allocator_Alloc_Func)(anyptr ctx, usize size);
+typedef Yoru_Opt (*Yoru_Allocator_AllocUninit_Func)(anyptr ctx, usize size);
+typedef Yoru_Opt (*Yoru_Allocator_AllocAligned_Func)(anyptr ctx, usize size, usize alignment);
 typedef void (*Yoru_Allocator_DeAlloc_Func)(anyptr ctx, anyptr ptr);
 typedef Yoru_Opt (*Yoru_Allocator_ReAlloc_Func)(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
 typedef void (*Yoru_Allocator_Destroy_Func)(anyptr ctx);
 
 /// @brief Functions that an allocator must implement.
 /// If a function would be a no-op, they would still need to be provided.
+/// Only `alloc_uninit` and `alloc_aligned` may be left NULL, see
+/// `yoru_allocator_alloc_uninit` and `yoru_allocator_alloc_aligned`
 typedef struct Yoru_AllocatorVTable {
-  Yoru_Allocator_Alloc_Func   alloc;
-  Yoru_Allocator_DeAlloc_Func dealloc;
-  Yoru_Allocator_ReAlloc_Func realloc;
-  Yoru_Allocator_Destroy_Func destroy;
+  Yoru_Allocator_Alloc_Func        alloc;
+  Yoru_Allocator_AllocUninit_Func  alloc_uninit;
+  Yoru_Allocator_AllocAligned_Func alloc_aligned;
+  Yoru_Allocator_DeAlloc_Func      dealloc;
+  Yoru_Allocator_ReAlloc_Func      realloc;
+  Yoru_Allocator_Destroy_Func      destroy;
 } Yoru_AllocatorVTable;
 
 /// @brief Allocator Interface
@@ -150,22 +179,45 @@ typedef struct Yoru_Allocator {
   anyptr                      ctx;
 } Yoru_Allocator;
 
-/// @brief Allocates memory using the alloc function inside the allocators
-/// vtable
+/// @brief Allocates zeroed memory using the alloc function inside the
+/// allocators vtable. The memory is aligned to at least `YORU_DEFAULT_ALIGNMENT`
 Yoru_Opt yoru_allocator_alloc(Yoru_Allocator *allocator, usize size);
 
+/// @brief Same as `yoru_allocator_alloc` but the memory is NOT zeroed. Meant
+/// for buffers that are overwritten right away, e.g. when reading a file.
+/// Allocators without alloc_uninit hand out zeroed memory through alloc
+Yoru_Opt yoru_allocator_alloc_uninit(Yoru_Allocator *allocator, usize size);
+
+/// @brief Allocates memory aligned to `alignment` using the alloc_aligned
+/// function inside the allocators vtable
+/// @note `alignment` must be a power of two. Re-allocating the memory only
+/// keeps `YORU_DEFAULT_ALIGNMENT`. Allocators without alloc_aligned go
+/// through alloc, which only serves up to `YORU_DEFAULT_ALIGNMENT`, bigger
+/// alignments return none
+Yoru_Opt yoru_allocator_alloc_aligned(Yoru_Allocator *allocator, usize size, usize alignment);
+
 /// @brief De-Allocates/Frees memory using the dealloc function inside the
 /// allocators vtable
 void yoru_allocator_dealloc(Yoru_Allocator *allocator, anyptr ptr);
 
 /// @brief Re-Allocates memory using the realloc function inside the allocators
-/// vtable
+/// vtable. The first min(`old_size`, `new_size`) bytes are kept, the contents
+/// of the grown part are unspecified
 Yoru_Opt yoru_allocator_realloc(Yoru_Allocator *allocator, usize old_size, anyptr old_ptr, usize new_size);
 
 // @brief Destroys the allocator instance using the destroy function iside the
 // allocators vtable
 void yoru_allocator_destroy(Yoru_Allocator *allocator);
 
+/// @brief aligns `x` to `alignment`
+usize yoru_align_up(usize x, usize alignment);
+
+/// @brief returns true if `x` is a power of two, else false
+bool yoru_is_power_of_two(usize x);
+
+/// @brief returns the smallest power of two that is >= `x` (1 for 0)
+usize yoru_next_power_of_two(usize x);
+
 #ifdef YORU_IMPL
 Yoru_Opt yoru_allocator_alloc(Yoru_Allocator *allocator, usize size) {
   assert(allocator);
@@ -174,6 +226,26 @@ Yoru_Opt yoru_allocator_alloc(Yoru_Allocator *allocator, usize size) {
   return allocator->vtable->alloc(allocator->ctx, size);
 }
 
+Yoru_Opt yoru_allocator_alloc_uninit(Yoru_Allocator *allocator, usize size) {
+  assert(allocator);
+  assert(allocator->vtable);
+  if (!allocator->vtable->alloc_uninit) return yoru_allocator_alloc(allocator, size);
+  return allocator->vtable->alloc_uninit(allocator->ctx, size);
+}
+
+Yoru_Opt yoru_allocator_alloc_aligned(Yoru_Allocator *allocator, usize size, usize alignment) {
+  assert(allocator);
+  assert(allocator->vtable);
+  assert(yoru_is_power_of_two(alignment) && "alignment must be a power of two");
+  if (!allocator->vtable->alloc_aligned) {
+    /* the pointer has to stay the one alloc returned so dealloc gets it back,
+       which leaves no room to align it any further */
+    if (alignment > YORU_DEFAULT_ALIGNMENT) return yoru_opt_none();
+    return yoru_allocator_alloc(allocator, size);
+  }
+  return allocator->vtable->alloc_aligned(allocator->ctx, size, alignment);
+}
+
 void yoru_allocator_dealloc(Yoru_Allocator *allocator, anyptr ptr) {
   assert(allocator);
   assert(allocator->vtable);
@@ -194,15 +266,35 @@ void yoru_allocator_destroy(Yoru_Allocator *allocator) {
   assert(allocator->vtable->destroy);
   allocator->vtable->destroy(allocator->ctx);
 }
+
+usize yoru_align_up(usize x, usize alignment) {
+  return (x + alignment - 1) & ~(alignment - 1);
+}
+
+bool yoru_is_power_of_two(usize x) {
+  return x != 0 && (x & (x - 1)) == 0;
+}
+
+usize yoru_next_power_of_two(usize x) {
+  if (x <= 1) return 1;
+  /* smear the highest set bit of x - 1 into all lower bits */
+  --x;
+  for (usize shift = 1; shift < sizeof(usize) * 8; shift *= 2) x |= x >> shift;
+  return x + 1;
+}
 #endif // YORU_IMPL
 
 /* ============================================================
    MODULE: GlobalAllocator
    provides a global allocator that is just a wrapper around
-   calloc and free that fits the ALlocator interface
+   calloc, malloc, realloc and free that fits the ALlocator
+   interface
 
    This is for individual allocations and frees unlike the
    `ArenaAllocator` or the `VirtualArenaAllocator`.
+
+   On windows every allocation goes through `_aligned_malloc`
+   because memory from it must be released with `_aligned_free`.
    ============================================================ */
 
 typedef Yoru_Allocator Yoru_GlobalAllocator;
@@ -212,15 +304,19 @@ Yoru_GlobalAllocator yoru_global_allocator_make();
 
 #ifdef YORU_IMPL
 Yoru_Opt __yoru_global_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_global_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_global_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
 void     __yoru_global_allocator_dealloc(anyptr ctx, anyptr ptr);
 Yoru_Opt __yoru_global_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
 void     __yoru_global_allocator_destroy(anyptr ctx);
 
 static const Yoru_AllocatorVTable __yoru_global_allocator_vtable = {
-    .alloc   = __yoru_global_allocator_alloc,
-    .dealloc = __yoru_global_allocator_dealloc,
-    .realloc = __yoru_global_allocator_realloc,
-    .destroy = __yoru_global_allocator_destroy,
+    .alloc         = __yoru_global_allocator_alloc,
+    .alloc_uninit  = __yoru_global_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_global_allocator_alloc_aligned,
+    .dealloc       = __yoru_global_allocator_dealloc,
+    .realloc       = __yoru_global_allocator_realloc,
+    .destroy       = __yoru_global_allocator_destroy,
 };
 
 Yoru_GlobalAllocator yoru_global_allocator_make() {
@@ -231,25 +327,69 @@ Yoru_GlobalAllocator yoru_global_allocator_make() {
 }
 
 Yoru_Opt __yoru_global_allocator_alloc(anyptr ctx, usize size) {
+  return __yoru_global_allocator_alloc_aligned(ctx, size, YORU_DEFAULT_ALIGNMENT);
+}
+
+Yoru_Opt __yoru_global_allocator_alloc_uninit(anyptr ctx, usize size) {
+  (void)ctx;
+#  if defined(_WIN32)
+  anyptr ptr = _aligned_malloc(size, YORU_DEFAULT_ALIGNMENT);
+#  else
+  anyptr ptr = malloc(size);
+#  endif
+  if (!ptr) return yoru_opt_none();
+  return yoru_opt_some(ptr);
+}
+
+Yoru_Opt __yoru_global_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
   (void)ctx;
-  anyptr ptr = calloc(1, size);
-  if (!ptr) { return yoru_opt_none(); }
+#  if defined(_WIN32)
+  anyptr ptr = _aligned_malloc(size, alignment);
+  if (!ptr) return yoru_opt_none();
+  memset(ptr, 0, size);
+#  else
+  /* malloc already returns memory that is aligned for any builtin type */
+  if (alignment <= YORU_DEFAULT_ALIGNMENT) {
+    anyptr ptr = calloc(1, size);
+    if (!ptr) { return yoru_opt_none(); }
+    return yoru_opt_some(ptr);
+  }
+
+  anyptr ptr = aligned_alloc(alignment, yoru_align_up(size, alignment));
+  if (!ptr) return yoru_opt_none();
+  memset(ptr, 0, size);
+#  endif
   return yoru_opt_some(ptr);
 }
 
 void __yoru_global_allocator_dealloc(anyptr ctx, anyptr ptr) {
   (void)ctx;
   if (!ptr) return;
+#  if defined(_WIN32)
+  _aligned_free(ptr);
+#  else
   free(ptr);
+#  endif
 }
 
 Yoru_Opt __yoru_global_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
-  (void)ctx;
-  usize  copy_size = old_size < new_size ? old_size : new_size;
-  anyptr new_ptr   = calloc(1, new_size);
-  if (!new_ptr) return yoru_opt_none();
-  memcpy(new_ptr, old_ptr, copy_size);
-  return yoru_opt_some(new_ptr);
+  if (!old_ptr) return __yoru_global_allocator_alloc(ctx, new_size);
+#  if defined(_WIN32)
+  /* _aligned_realloc must be called with the alignment the block was
+     allocated with, which is not known here */
+  Yoru_Opt maybe_new_ptr = __yoru_global_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  _aligned_free(old_ptr);
+  return maybe_new_ptr;
+#  else
+  /* lets libc grow the block in place (or remap it for big blocks) instead of
+     always copying. The old block stays valid if this fails */
+  (void)old_size;
+  anyptr ptr = realloc(old_ptr, new_size ? new_size : 1);
+  if (!ptr) return yoru_opt_none();
+  return yoru_opt_some(ptr);
+#  endif
 }
 
 void __yoru_global_allocator_destroy(anyptr ctx) {
@@ -268,27 +408,59 @@ void __yoru_global_allocator_destroy(anyptr ctx) {
 
 typedef Yoru_Allocator Yoru_ArenaAllocator;
 
+/// @brief A position inside an arena that the arena can be rolled back to
+typedef struct Yoru_ArenaMarker {
+  usize offset;
+  usize last_offset;
+} Yoru_ArenaMarker;
+
 /// @brief Creates a heap-based arena allocator
 Yoru_ArenaAllocator *yoru_arena_allocator_make(usize capacity);
 
+/// @brief Returns a marker to the current position of the arena
+Yoru_ArenaMarker yoru_arena_allocator_get_marker(Yoru_ArenaAllocator *allocator);
+
+/// @brief Rolls the arena back to `marker`. Everything allocated after the
+/// marker was taken must not be used anymore.
+void yoru_arena_allocator_restore(Yoru_ArenaAllocator *allocator, Yoru_ArenaMarker marker);
+
+/// @brief Rolls the arena back to the start. The memory is kept for the next
+/// allocations instead of being freed.
+void yoru_arena_allocator_reset(Yoru_ArenaAllocator *allocator);
+
+/* the context is public so the fast paths of the StaticDispatch module can be
+   inlined */
+typedef struct Yoru_ArenaAllocatorCtx {
+  byte *mem;
+  usize offset;
+  usize capacity;
+  usize last_offset; // start of the most recent allocation, which can be resized in place
+  usize high_water;  // everything above was never handed out and is still zeroed
+} Yoru_ArenaAllocatorCtx;
+
 #ifdef YORU_IMPL
 Yoru_Opt __yoru_arena_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_arena_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
 void     __yoru_arena_allocator_dealloc(anyptr ctx, anyptr ptr);
 Yoru_Opt __yoru_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
 void     __yoru_arena_allocator_destroy(anyptr ctx);
 
 static const Yoru_AllocatorVTable __yoru_arena_allocator_vtable = {
-    .alloc   = __yoru_arena_allocator_alloc,
-    .dealloc = __yoru_arena_allocator_dealloc,
-    .realloc = __yoru_arena_allocator_realloc,
-    .destroy = __yoru_arena_allocator_destroy,
+    .alloc         = __yoru_arena_allocator_alloc,
+    .alloc_uninit  = __yoru_arena_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_arena_allocator_alloc_aligned,
+    .dealloc       = __yoru_arena_allocator_dealloc,
+    .realloc       = __yoru_arena_allocator_realloc,
+    .destroy       = __yoru_arena_allocator_destroy,
 };
 
-typedef struct Yoru_ArenaAllocatorCtx {
-  byte *mem;
-  usize offset;
-  usize capacity;
-} Yoru_ArenaAllocatorCtx;
+/// clears the part of [start, end) that was handed out before and raises the
+/// high-water mark, so reused memory is zeroed just like fresh memory
+static inline void __yoru_arena_clear_reused(byte *mem, usize *high_water, usize start, usize end) {
+  if (start < *high_water) memset(mem + start, 0, (end < *high_water ? end : *high_water) - start);
+  if (end > *high_water) *high_water = end;
+}
 
 Yoru_ArenaAllocator *yoru_arena_allocator_make(usize capacity) {
   Yoru_ArenaAllocator    *a   = NULL;
@@ -305,9 +477,11 @@ Yoru_ArenaAllocator *yoru_arena_allocator_make(usize capacity) {
 
   mem = (byte *)calloc(1, capacity);
   if (!mem) goto err;
-  ctx->mem      = mem;
-  ctx->offset   = 0;
-  ctx->capacity = capacity;
+  ctx->mem         = mem;
+  ctx->offset      = 0;
+  ctx->capacity    = capacity;
+  ctx->last_offset = 0;
+  ctx->high_water  = 0;
   return a;
 
 err:
@@ -317,18 +491,38 @@ err:
   return NULL;
 }
 
-Yoru_Opt __yoru_arena_allocator_alloc(anyptr ctx, usize size) {
-  if (!ctx) return yoru_opt_none();
-  Yoru_ArenaAllocatorCtx *arena = (Yoru_ArenaAllocatorCtx *)ctx;
-
-  if (arena->offset + size > arena->capacity) { return yoru_opt_none(); }
+static inline Yoru_Opt __yoru_arena_bump(Yoru_ArenaAllocatorCtx *arena, usize size, usize alignment, bool zeroed) {
+  /* align the address and not the offset, `mem` is only aligned to
+     YORU_DEFAULT_ALIGNMENT */
+  usize start = yoru_align_up((usize)arena->mem + arena->offset, alignment) - (usize)arena->mem;
+  if (start + size > arena->capacity) { return yoru_opt_none(); }
+  if (zeroed) {
+    __yoru_arena_clear_reused(arena->mem, &arena->high_water, start, start + size);
+  } else if (start + size > arena->high_water) {
+    arena->high_water = start + size;
+  }
 
-  anyptr ptr = arena->mem + arena->offset;
-  arena->offset += size;
+  anyptr ptr         = arena->mem + start;
+  arena->last_offset = start;
+  arena->offset      = start + size;
 
   return yoru_opt_some(ptr);
 }
 
+Yoru_Opt __yoru_arena_allocator_alloc(anyptr ctx, usize size) {
+  return __yoru_arena_allocator_alloc_aligned(ctx, size, YORU_DEFAULT_ALIGNMENT);
+}
+
+Yoru_Opt __yoru_arena_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_arena_bump(ctx, size, YORU_DEFAULT_ALIGNMENT, false);
+}
+
+Yoru_Opt __yoru_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_arena_bump(ctx, size, alignment, true);
+}
+
 void __yoru_arena_allocator_dealloc(anyptr ctx, anyptr ptr) {
   (void)ctx;
   (void)ptr;
@@ -338,20 +532,51 @@ void __yoru_arena_allocator_dealloc(anyptr ctx, anyptr ptr) {
 }
 
 Yoru_Opt __yoru_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
-  (void)ctx;
-  (void)old_size;
-  (void)old_ptr;
-  (void)new_size;
-  /* Reallocations are not supported on arena allocators because if you want to
-     grow something in the middle of the arena then we would also have to shift
-     every ptr to the right which might not work becuase the arena might not be
-     able to fit everything with the new ptr in the arena and we dont know in
-     the arena ctx where which ptr starts! otherwise we would have to keep track
-     of them here.
-     -> TODO: maybe we could handle reallocs like normal allocations instead and
-     just push to the arena?
-  */
-  return yoru_opt_none();
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_arena_allocator_alloc(ctx, new_size);
+  Yoru_ArenaAllocatorCtx *arena = (Yoru_ArenaAllocatorCtx *)ctx;
+
+  /* The most recent allocation sits at the end of the arena, so it can just
+     grow or shrink by moving the offset without copying anything. Memory it
+     grows into that was handed out before a restore is cleared like on alloc */
+  if ((byte *)old_ptr == arena->mem + arena->last_offset) {
+    if (arena->last_offset + new_size > arena->capacity) return yoru_opt_none();
+    arena->offset = arena->last_offset + new_size;
+    if (new_size > old_size) {
+      __yoru_arena_clear_reused(arena->mem, &arena->high_water, arena->last_offset + old_size, arena->offset);
+    }
+    return yoru_opt_some(old_ptr);
+  }
+
+  /* Everything else is pushed to the end of the arena as a new allocation. The
+     old block stays where it is until the arena is destroyed. */
+  Yoru_Opt maybe_new_ptr = __yoru_arena_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  return maybe_new_ptr;
+}
+
+Yoru_ArenaMarker yoru_arena_allocator_get_marker(Yoru_ArenaAllocator *allocator) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_arena_allocator_vtable && "not an arena allocator");
+  Yoru_ArenaAllocatorCtx *arena = allocator->ctx;
+  return (Yoru_ArenaMarker){.offset = arena->offset, .last_offset = arena->last_offset};
+}
+
+void yoru_arena_allocator_restore(Yoru_ArenaAllocator *allocator, Yoru_ArenaMarker marker) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_arena_allocator_vtable && "not an arena allocator");
+  Yoru_ArenaAllocatorCtx *arena = allocator->ctx;
+  assert(marker.offset <= arena->offset && "marker is newer than the arena position");
+
+  /* the allocation that was the most recent one when the marker was taken is
+     the most recent one again and can be resized in place */
+  arena->offset      = marker.offset;
+  arena->last_offset = marker.last_offset;
+}
+
+void yoru_arena_allocator_reset(Yoru_ArenaAllocator *allocator) {
+  yoru_arena_allocator_restore(allocator, (Yoru_ArenaMarker){0});
 }
 
 void __yoru_arena_allocator_destroy(anyptr ctx) {
@@ -364,6 +589,236 @@ void __yoru_arena_allocator_destroy(anyptr ctx) {
 }
 #endif // YORU_IMPL
 
+/* ============================================================
+   MODULE: ChainedArenaAllocator
+   provides an arena allocator that never runs out of space
+   while its parent allocator has memory left.
+
+   Allocations are bumped out of the current block. When it is
+   full, a new block is allocated from the parent and becomes the
+   current one. Blocks grow geometrically from the first block
+   size up to `YORU_CHAINED_ARENA_MAX_BLOCK_SIZE`. Allocations
+   bigger than the next block get a block of their own, which is
+   linked behind the current block so bumping goes on where it
+   was. Memory use follows the actual use without reserving
+   address space up front.
+   ============================================================ */
+
+#define YORU_CHAINED_ARENA_MIN_BLOCK_SIZE (YORU_KiB(4))
+#define YORU_CHAINED_ARENA_MAX_BLOCK_SIZE (YORU_MiB(64))
+
+typedef Yoru_Allocator Yoru_ChainedArenaAllocator;
+
+/// @brief Creates an arena that allocates its blocks from `parent`, starting
+/// with a block of `first_block_size` bytes. The parent is not owned and must
+/// outlive the arena
+Yoru_ChainedArenaAllocator *yoru_chained_arena_allocator_make(Yoru_Allocator *parent, usize first_block_size);
+
+/// @brief Rolls the arena back to the start. The current block, which is the
+/// biggest regular one, is kept for the next allocations, all other blocks are
+/// given back to the parent
+void yoru_chained_arena_allocator_reset(Yoru_ChainedArenaAllocator *allocator);
+
+/* the header sits at the start of every block, the memory that is handed out
+   follows it */
+typedef struct Yoru_ChainedArenaBlock {
+  struct Yoru_ChainedArenaBlock *prev;
+  usize                          capacity;
+} Yoru_ChainedArenaBlock;
+
+#define __YORU_CHAINED_ARENA_HEADER_SIZE                                                                               \
+  ((sizeof(Yoru_ChainedArenaBlock) + YORU_DEFAULT_ALIGNMENT - 1) & ~(usize)(YORU_DEFAULT_ALIGNMENT - 1))
+
+typedef struct Yoru_ChainedArenaAllocatorCtx {
+  Yoru_Allocator         *parent;
+  Yoru_ChainedArenaBlock *current;
+  usize                   offset;
+  usize                   last_offset; // start of the most recent allocation, which can be resized in place
+  usize                   next_block_size;
+  Yoru_ChainedArenaBlock *last_dedicated; // block of the most recent oversize allocation, resized in place
+
+  Yoru_ChainedArenaAllocator allocator;
+} Yoru_ChainedArenaAllocatorCtx;
+
+static inline byte *__yoru_chained_arena_data(Yoru_ChainedArenaBlock *block) {
+  return (byte *)block + __YORU_CHAINED_ARENA_HEADER_SIZE;
+}
+
+#ifdef YORU_IMPL
+Yoru_Opt __yoru_chained_arena_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_chained_arena_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_chained_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_chained_arena_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_chained_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_chained_arena_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_chained_arena_allocator_vtable = {
+    .alloc         = __yoru_chained_arena_allocator_alloc,
+    .alloc_uninit  = __yoru_chained_arena_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_chained_arena_allocator_alloc_aligned,
+    .dealloc       = __yoru_chained_arena_allocator_dealloc,
+    .realloc       = __yoru_chained_arena_allocator_realloc,
+    .destroy       = __yoru_chained_arena_allocator_destroy,
+};
+
+/// allocates a block that fits `size` bytes at `alignment`. A regular block
+/// becomes the current one and the next block grows. A request bigger than
+/// the next block gets a block of its own that is linked behind the current
+/// one, so the free tail of the current block is not thrown away
+static Yoru_ChainedArenaBlock *
+__yoru_chained_arena_push_block(Yoru_ChainedArenaAllocatorCtx *arena, usize size, usize alignment) {
+  usize needed = size + (alignment > YORU_DEFAULT_ALIGNMENT ? alignment : 0);
+  if (needed < size) return NULL;
+  bool  dedicated = arena->current && needed > arena->next_block_size;
+  usize capacity  = dedicated ? needed : arena->next_block_size;
+  if (capacity < needed) capacity = needed;
+
+  Yoru_Opt maybe_block = yoru_allocator_alloc_uninit(arena->parent, __YORU_CHAINED_ARENA_HEADER_SIZE + capacity);
+  if (!maybe_block.has_value) return NULL;
+
+  Yoru_ChainedArenaBlock *block = maybe_block.ptr;
+  block->capacity               = capacity;
+  if (dedicated) {
+    block->prev           = arena->current->prev;
+    arena->current->prev  = block;
+    arena->last_dedicated = block;
+    return block;
+  }
+
+  block->prev        = arena->current;
+  arena->current     = block;
+  arena->offset      = 0;
+  arena->last_offset = 0;
+  if (arena->next_block_size < YORU_CHAINED_ARENA_MAX_BLOCK_SIZE) arena->next_block_size *= 2;
+  return block;
+}
+
+Yoru_ChainedArenaAllocator *yoru_chained_arena_allocator_make(Yoru_Allocator *parent, usize first_block_size) {
+  assert(parent && "must not be null");
+  Yoru_ChainedArenaAllocatorCtx *ctx = calloc(1, sizeof(Yoru_ChainedArenaAllocatorCtx));
+  if (!ctx) return NULL;
+
+  if (first_block_size < YORU_CHAINED_ARENA_MIN_BLOCK_SIZE) first_block_size = YORU_CHAINED_ARENA_MIN_BLOCK_SIZE;
+  ctx->parent           = parent;
+  ctx->next_block_size  = first_block_size;
+  ctx->allocator.vtable = &__yoru_chained_arena_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  if (!__yoru_chained_arena_push_block(ctx, 0, YORU_DEFAULT_ALIGNMENT)) {
+    free(ctx);
+    return NULL;
+  }
+  return &ctx->allocator;
+}
+
+static inline Yoru_Opt __yoru_chained_arena_bump(
+    Yoru_ChainedArenaAllocatorCtx *arena,
+    usize                          size,
+    usize                          alignment,
+    bool                           zeroed) {
+  byte *data  = __yoru_chained_arena_data(arena->current);
+  usize start = yoru_align_up((usize)data + arena->offset, alignment) - (usize)data;
+  if (start + size > arena->current->capacity) {
+    Yoru_ChainedArenaBlock *block = __yoru_chained_arena_push_block(arena, size, alignment);
+    if (!block) return yoru_opt_none();
+    data  = __yoru_chained_arena_data(block);
+    start = yoru_align_up((usize)data, alignment) - (usize)data;
+
+    /* a block of its own, the current block keeps its position */
+    if (block != arena->current) {
+      if (zeroed) memset(data + start, 0, size);
+      return yoru_opt_some(data + start);
+    }
+  }
+
+  anyptr ptr         = data + start;
+  arena->last_offset = start;
+  arena->offset      = start + size;
+  if (zeroed) memset(ptr, 0, size);
+
+  return yoru_opt_some(ptr);
+}
+
+Yoru_Opt __yoru_chained_arena_allocator_alloc(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_chained_arena_bump(ctx, size, YORU_DEFAULT_ALIGNMENT, true);
+}
+
+Yoru_Opt __yoru_chained_arena_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_chained_arena_bump(ctx, size, YORU_DEFAULT_ALIGNMENT, false);
+}
+
+Yoru_Opt __yoru_chained_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_chained_arena_bump(ctx, size, alignment, true);
+}
+
+void __yoru_chained_arena_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  (void)ptr;
+  // like in the ArenaAllocator, everything is freed at once on reset or destroy
+}
+
+Yoru_Opt __yoru_chained_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_chained_arena_allocator_alloc(ctx, new_size);
+  Yoru_ChainedArenaAllocatorCtx *arena = ctx;
+
+  /* the most recent allocation is resized in place as long as it stays
+     inside the current block */
+  byte *data = __yoru_chained_arena_data(arena->current);
+  if ((byte *)old_ptr == data + arena->last_offset && arena->last_offset + new_size <= arena->current->capacity) {
+    arena->offset = arena->last_offset + new_size;
+    return yoru_opt_some(old_ptr);
+  }
+
+  /* so is the most recent oversize allocation, it is alone in its block */
+  if (arena->last_dedicated) {
+    usize start    = (usize)old_ptr - (usize)__yoru_chained_arena_data(arena->last_dedicated);
+    usize capacity = arena->last_dedicated->capacity;
+    if (start < capacity && new_size <= capacity - start) {
+      return yoru_opt_some(old_ptr);
+    }
+  }
+
+  Yoru_Opt maybe_new_ptr = __yoru_chained_arena_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  return maybe_new_ptr;
+}
+
+/// gives `block` and every block before it back to the parent
+static void __yoru_chained_arena_free_blocks(Yoru_Allocator *parent, Yoru_ChainedArenaBlock *block) {
+  while (block) {
+    Yoru_ChainedArenaBlock *prev = block->prev;
+    yoru_allocator_dealloc(parent, block);
+    block = prev;
+  }
+}
+
+void yoru_chained_arena_allocator_reset(Yoru_ChainedArenaAllocator *allocator) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_chained_arena_allocator_vtable && "not a chained arena allocator");
+  Yoru_ChainedArenaAllocatorCtx *arena = allocator->ctx;
+
+  /* the current block is the newest and biggest regular one, oversize blocks
+     never become current. Keeping it avoids going back to the parent on every
+     cycle */
+  __yoru_chained_arena_free_blocks(arena->parent, arena->current->prev);
+  arena->current->prev  = NULL;
+  arena->offset         = 0;
+  arena->last_offset    = 0;
+  arena->last_dedicated = NULL;
+}
+
+void __yoru_chained_arena_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  Yoru_ChainedArenaAllocatorCtx *arena = ctx;
+  __yoru_chained_arena_free_blocks(arena->parent, arena->current);
+  free(arena);
+}
+#endif // YORU_IMPL
+
 #if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32) || defined(_WIN32)
 /* ============================================================
    MODULE: VirtualMemory
@@ -375,62 +830,150 @@ void __yoru_arena_allocator_destroy(anyptr ctx) {
    request! :)
    ============================================================ */
 
+/// @brief size of a huge page on linux x86-64 and arm64 (with 4 KiB pages)
+#  define YORU_HUGE_PAGE_SIZE (YORU_MiB(2))
+
+typedef enum {
+  YORU_VMEM_NONE = 0,
+  /// asks the kernel to back the reservation with transparent huge pages
+  /// (madvise MADV_HUGEPAGE). linux only, ignored elsewhere
+  YORU_VMEM_TRANSPARENT_HUGE_PAGES = 1,
+  /// maps the reservation with MAP_HUGETLB, which needs huge pages to be set up
+  /// by the admin (vm.nr_hugepages). Falls back to transparent huge pages if
+  /// that fails. linux only, ignored elsewhere
+  YORU_VMEM_HUGE_PAGES = 2,
+} Yoru_Vmem_Flags;
+
+typedef enum {
+  /// the pages are released right away (MADV_DONTNEED) and read as zero once
+  /// they are committed again
+  YORU_VMEM_DECOMMIT_NONE = 0,
+  /// lets the kernel reclaim the pages whenever it needs memory (MADV_FREE).
+  /// Cheaper, but the contents are unspecified once committed again. linux and
+  /// macos only, ignored elsewhere
+  YORU_VMEM_DECOMMIT_LAZY = 1,
+  /// additionally protects the pages (PROT_NONE) so stray accesses fault
+  /// instead of silently faulting the pages back in
+  YORU_VMEM_DECOMMIT_PROTECT = 2,
+} Yoru_Vmem_DecommitFlags;
+
+typedef enum {
+  /// pages end up on the node of the thread that touches them first
+  YORU_VMEM_NUMA_DEFAULT = 0,
+  /// pages are only taken from the given node
+  YORU_VMEM_NUMA_BIND = 1,
+  /// pages are spread round-robin over all nodes. linux only, ignored elsewhere
+  YORU_VMEM_NUMA_INTERLEAVE = 2,
+} Yoru_Vmem_NumaMode;
+
 typedef struct Yoru_Vmem_Ctx {
   anyptr base;
   usize  commit_pos;
   usize  addr_space_size;
+  usize  page_size; // granularity of commits, the huge page size for YORU_VMEM_HUGE_PAGES
+#  if defined(_WIN32)
+  usize numa_node; // 1 + the node commits are placed on, 0 for none
+#  endif
 } Yoru_Vmem_Ctx;
 
-/// @brief aligns `x` to `alignment`
-usize yoru_align_up(usize x, usize alignment);
-
-/// @brief returns the page size on the current system
+/// @brief returns the page size on the current system. The value is queried
+/// once and cached afterwards
 usize yoru_get_page_size();
 
 /// @brief reserves an page-aligned `size` amount of bytes of reserved memory
 bool yoru_vmem_reserve(usize size, Yoru_Vmem_Ctx *out_ctx);
 
+/// @brief same as `yoru_vmem_reserve` but with `flags` (a bitmap of
+/// Yoru_Vmem_Flags) to request huge pages
+bool yoru_vmem_reserve_with_flags(usize size, Yoru_Vmem_Flags flags, Yoru_Vmem_Ctx *out_ctx);
+
 /// @brief commits a page-aligned size to a `ctx` increasing the commit
 /// position. returns true on success, else false
 bool yoru_vmem_commit(Yoru_Vmem_Ctx *ctx, usize size);
 
+/// @brief commits [`offset`, `offset` + `size`) of the reservation, both
+/// aligned to the page size, without touching the commit position. For
+/// allocators that commit scattered parts of the reservation and keep track of
+/// what is committed themselves
+bool yoru_vmem_commit_at(Yoru_Vmem_Ctx *ctx, usize offset, usize size);
+
+/// @brief returns the last `size` committed bytes (aligned down to the page
+/// size) to the OS, decreasing the commit position. The address space stays
+/// reserved, so the pages can be committed again with `yoru_vmem_commit`.
+/// `flags` is a bitmap of Yoru_Vmem_DecommitFlags
+bool yoru_vmem_decommit(Yoru_Vmem_Ctx *ctx, usize size, Yoru_Vmem_DecommitFlags flags);
+
 /// @brief frees the reserved address space
 bool yoru_vmem_free(Yoru_Vmem_Ctx *ctx);
 
-#  ifdef YORU_IMPL
-usize yoru_align_up(usize x, usize alignment) {
-  return (x + alignment - 1) & ~(alignment - 1);
-}
+/// @brief returns one past the highest NUMA node id (1 on machines without
+/// NUMA), i.e. the size of an array indexed by node. Node ids can have gaps,
+/// `yoru_numa_node_online` tells which ones exist. The online nodes are
+/// queried once and cached afterwards
+usize yoru_numa_node_count();
+
+/// @brief returns true if `node` is an online NUMA node
+bool yoru_numa_node_online(usize node);
 
+/// @brief returns the NUMA node of the cpu the calling thread runs on, 0 if it
+/// can not be determined
+usize yoru_numa_current_node();
+
+/// @brief places the pages of the whole reservation according to `mode`, with
+/// `node` being the node for YORU_VMEM_NUMA_BIND. Only pages committed (or
+/// touched for the first time) afterwards are affected, so call it right after
+/// reserving. Returns false for a node that is not online. On machines with a
+/// single node (or kernels without NUMA support) there is nothing to place and
+/// it always succeeds
+bool yoru_vmem_set_numa_policy(Yoru_Vmem_Ctx *ctx, Yoru_Vmem_NumaMode mode, usize node);
+
+#  ifdef YORU_IMPL
 #    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
-bool __yoru_vmem_reserve_linux(usize size, Yoru_Vmem_Ctx *ctx);
+bool __yoru_vmem_reserve_linux(usize size, Yoru_Vmem_Flags flags, Yoru_Vmem_Ctx *ctx);
 bool __yoru_vmem_commit_linux(Yoru_Vmem_Ctx *ctx, usize size);
+bool __yoru_vmem_commit_at_linux(Yoru_Vmem_Ctx *ctx, usize offset, usize size);
+bool __yoru_vmem_decommit_linux(Yoru_Vmem_Ctx *ctx, usize size, Yoru_Vmem_DecommitFlags flags);
 bool __yoru_vmem_free_linux(Yoru_Vmem_Ctx *ctx);
+bool __yoru_vmem_set_numa_policy_linux(Yoru_Vmem_Ctx *ctx, Yoru_Vmem_NumaMode mode, usize node);
 #    elif defined(_WIN32)
 bool __yoru_vmem_reserve_windows(usize size, Yoru_Vmem_Ctx *ctx);
 bool __yoru_vmem_commit_windows(Yoru_Vmem_Ctx *ctx, usize size);
+bool __yoru_vmem_commit_at_windows(Yoru_Vmem_Ctx *ctx, usize offset, usize size);
+bool __yoru_vmem_decommit_windows(Yoru_Vmem_Ctx *ctx, usize size);
 bool __yoru_vmem_free_windows(Yoru_Vmem_Ctx *ctx);
+bool __yoru_vmem_set_numa_policy_windows(Yoru_Vmem_Ctx *ctx, Yoru_Vmem_NumaMode mode, usize node);
 #    else
 #      error "platform not supported"
 #    endif
 
 usize yoru_get_page_size() {
+  static _Atomic usize page_size = 0;
+  usize                cached    = atomic_load_explicit(&page_size, memory_order_relaxed);
+  if (cached) return cached;
+
 #    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
-  return (usize)sysconf(_SC_PAGE_SIZE);
+  cached = (usize)sysconf(_SC_PAGE_SIZE);
 #    elif defined(_WIN32)
   SYSTEM_INFO sysinfo = {0};
   GetSystemInfo(&sysinfo);
-  return (usize)sysinfo.dwPageSize;
+  cached = (usize)sysinfo.dwPageSize;
 #    else
 #      error "platform not supported yet"
 #    endif
+  atomic_store_explicit(&page_size, cached, memory_order_relaxed);
+  return cached;
 }
 
 bool yoru_vmem_reserve(usize size, Yoru_Vmem_Ctx *out_ctx) {
+  return yoru_vmem_reserve_with_flags(size, YORU_VMEM_NONE, out_ctx);
+}
+
+bool yoru_vmem_reserve_with_flags(usize size, Yoru_Vmem_Flags flags, Yoru_Vmem_Ctx *out_ctx) {
   assert(out_ctx && "must not be null");
 #    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
-  return __yoru_vmem_reserve_linux(size, out_ctx);
+  return __yoru_vmem_reserve_linux(size, flags, out_ctx);
 #    elif defined(_WIN32)
+  (void)flags;
   return __yoru_vmem_reserve_windows(size, out_ctx);
 #    else
 #      error "platform not supported yet"
@@ -449,6 +992,39 @@ bool yoru_vmem_commit(Yoru_Vmem_Ctx *ctx, usize size) {
 #    endif
 }
 
+bool yoru_vmem_commit_at(Yoru_Vmem_Ctx *ctx, usize offset, usize size) {
+  assert(ctx && "must not be null");
+  assert(ctx->base && "must not be null");
+  usize page_size = ctx->page_size ? ctx->page_size : yoru_get_page_size();
+  usize end       = yoru_align_up(offset + size, page_size);
+  offset -= offset % page_size;
+  if (end > ctx->addr_space_size) return false;
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  return __yoru_vmem_commit_at_linux(ctx, offset, end - offset);
+#    elif defined(_WIN32)
+  return __yoru_vmem_commit_at_windows(ctx, offset, end - offset);
+#    else
+#      error "platform not supported yet"
+#    endif
+}
+
+bool yoru_vmem_decommit(Yoru_Vmem_Ctx *ctx, usize size, Yoru_Vmem_DecommitFlags flags) {
+  assert(ctx && "must not be null");
+  assert(ctx->base && "must not be null");
+  usize page_size = ctx->page_size ? ctx->page_size : yoru_get_page_size();
+  if (size > ctx->commit_pos) size = ctx->commit_pos;
+  size -= size % page_size;
+  if (size == 0) return true;
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  return __yoru_vmem_decommit_linux(ctx, size, flags);
+#    elif defined(_WIN32)
+  (void)flags;
+  return __yoru_vmem_decommit_windows(ctx, size);
+#    else
+#      error "platform not supported yet"
+#    endif
+}
+
 bool yoru_vmem_free(Yoru_Vmem_Ctx *ctx) {
   assert(ctx && "must not be null");
   assert(ctx->base && "must not be null");
@@ -461,38 +1037,237 @@ bool yoru_vmem_free(Yoru_Vmem_Ctx *ctx) {
 #    endif
 }
 
+#    define __YORU_NUMA_MAX_NODES (1024)
+#    define __YORU_NUMA_MASK_BITS (8 * sizeof(unsigned long))
+
+/// sets the bits of the nodes in `list` in `mask`, the list being formatted
+/// like /sys/devices/system/node/online, e.g. "0-1,3". Returns one past the
+/// highest node id, 0 if the list is empty
+static usize __yoru_numa_parse_node_list(const char *list, unsigned long *mask) {
+  usize       count  = 0;
+  const char *cursor = list;
+  while (isdigit((unsigned char)*cursor)) {
+    char *end   = NULL;
+    usize first = (usize)strtoul(cursor, &end, 10);
+    usize last  = first;
+    if (*end == '-') last = (usize)strtoul(end + 1, &end, 10);
+    if (last >= __YORU_NUMA_MAX_NODES) last = __YORU_NUMA_MAX_NODES - 1;
+    for (usize node = first; node <= last; ++node) {
+      mask[node / __YORU_NUMA_MASK_BITS] |= 1ul << (node % __YORU_NUMA_MASK_BITS);
+    }
+    if (first <= last && last + 1 > count) count = last + 1;
+    cursor = *end == ',' ? end + 1 : end;
+  }
+  return count;
+}
+
+static _Atomic unsigned long __yoru_numa_online_mask[__YORU_NUMA_MAX_NODES / __YORU_NUMA_MASK_BITS];
+
+usize yoru_numa_node_count() {
+  static _Atomic usize node_count = 0;
+  usize                cached     = atomic_load_explicit(&node_count, memory_order_acquire);
+  if (cached) return cached;
+
+  unsigned long mask[__YORU_NUMA_MAX_NODES / __YORU_NUMA_MASK_BITS] = {0};
+#    if defined(__linux__)
+  char buf[4096] = {0};
+  int  fd        = open("/sys/devices/system/node/online", O_RDONLY);
+  if (fd >= 0) {
+    ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len > 0) cached = __yoru_numa_parse_node_list(buf, mask);
+  }
+#    elif defined(_WIN32)
+  /* windows numbers its nodes without gaps */
+  ULONG highest = 0;
+  if (GetNumaHighestNodeNumber(&highest) && highest < __YORU_NUMA_MAX_NODES) {
+    for (usize node = 0; node <= highest; ++node) {
+      mask[node / __YORU_NUMA_MASK_BITS] |= 1ul << (node % __YORU_NUMA_MASK_BITS);
+    }
+    cached = (usize)highest + 1;
+  }
+#    endif
+  if (!cached) {
+    mask[0] = 1;
+    cached  = 1;
+  }
+  for (usize i = 0; i < __YORU_NUMA_MAX_NODES / __YORU_NUMA_MASK_BITS; ++i) {
+    atomic_store_explicit(&__yoru_numa_online_mask[i], mask[i], memory_order_relaxed);
+  }
+  atomic_store_explicit(&node_count, cached, memory_order_release);
+  return cached;
+}
+
+bool yoru_numa_node_online(usize node) {
+  if (node >= yoru_numa_node_count()) return false;
+  unsigned long word =
+      atomic_load_explicit(&__yoru_numa_online_mask[node / __YORU_NUMA_MASK_BITS], memory_order_relaxed);
+  return (word >> (node % __YORU_NUMA_MASK_BITS)) & 1;
+}
+
+usize yoru_numa_current_node() {
+#    if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu  = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) return (usize)node;
+#    elif defined(_WIN32)
+  PROCESSOR_NUMBER processor = {0};
+  USHORT           node      = 0;
+  GetCurrentProcessorNumberEx(&processor);
+  if (GetNumaProcessorNodeEx(&processor, &node)) return (usize)node;
+#    endif
+  return 0;
+}
+
+bool yoru_vmem_set_numa_policy(Yoru_Vmem_Ctx *ctx, Yoru_Vmem_NumaMode mode, usize node) {
+  assert(ctx && "must not be null");
+  assert(ctx->base && "must not be null");
+  if (mode == YORU_VMEM_NUMA_BIND && !yoru_numa_node_online(node)) return false;
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  return __yoru_vmem_set_numa_policy_linux(ctx, mode, node);
+#    elif defined(_WIN32)
+  return __yoru_vmem_set_numa_policy_windows(ctx, mode, node);
+#    else
+#      error "platform not supported yet"
+#    endif
+}
+
 #    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
-bool __yoru_vmem_reserve_linux(usize size, Yoru_Vmem_Ctx *ctx) {
-  anyptr ptr = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, 0, 0);
+bool __yoru_vmem_reserve_linux(usize size, Yoru_Vmem_Flags flags, Yoru_Vmem_Ctx *ctx) {
+  anyptr ptr       = MAP_FAILED;
+  usize  page_size = yoru_get_page_size();
+
+#      if defined(__linux__) && defined(MAP_HUGETLB)
+  if (flags & YORU_VMEM_HUGE_PAGES) {
+    usize huge_size = yoru_align_up(size, YORU_HUGE_PAGE_SIZE);
+    ptr             = mmap(NULL, huge_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) {
+      size      = huge_size;
+      page_size = YORU_HUGE_PAGE_SIZE;
+    } else {
+      flags |= YORU_VMEM_TRANSPARENT_HUGE_PAGES;
+    }
+  }
+#      endif
+
+#      if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (ptr == MAP_FAILED && (flags & YORU_VMEM_TRANSPARENT_HUGE_PAGES)) {
+    /* the kernel can only use huge pages for 2 MiB aligned ranges, so reserve
+       a bit more and trim the unaligned head and tail */
+    size              = yoru_align_up(size, YORU_HUGE_PAGE_SIZE);
+    usize padded_size = size + YORU_HUGE_PAGE_SIZE;
+    u8   *raw         = mmap(NULL, padded_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw != MAP_FAILED) {
+      u8   *aligned = (u8 *)yoru_align_up((usize)raw, YORU_HUGE_PAGE_SIZE);
+      usize head    = (usize)(aligned - raw);
+      if (head > 0) munmap(raw, head);
+      if (padded_size - head - size > 0) munmap(aligned + size, padded_size - head - size);
+      madvise(aligned, size, MADV_HUGEPAGE);
+      ptr = aligned;
+    }
+  }
+#      endif
+
+  if (ptr == MAP_FAILED) ptr = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
   if (ptr == MAP_FAILED) {
     ctx->base            = NULL;
     ctx->commit_pos      = 0;
     ctx->addr_space_size = 0;
+    ctx->page_size       = 0;
     return false;
   }
 
   ctx->base            = ptr;
   ctx->commit_pos      = 0;
   ctx->addr_space_size = size;
+  ctx->page_size       = page_size;
   return true;
 }
 
 bool __yoru_vmem_commit_linux(Yoru_Vmem_Ctx *ctx, usize size) {
-  usize size_aligned = yoru_align_up(size, yoru_get_page_size());
+  usize size_aligned = yoru_align_up(size, ctx->page_size ? ctx->page_size : yoru_get_page_size());
   int   err          = mprotect((u8 *)ctx->base + ctx->commit_pos, size_aligned, PROT_READ | PROT_WRITE);
   if (err != 0) return false;
   ctx->commit_pos += size_aligned;
   return true;
 }
 
+bool __yoru_vmem_commit_at_linux(Yoru_Vmem_Ctx *ctx, usize offset, usize size) {
+  return mprotect((u8 *)ctx->base + offset, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+bool __yoru_vmem_decommit_linux(Yoru_Vmem_Ctx *ctx, usize size, Yoru_Vmem_DecommitFlags flags) {
+  u8  *start = (u8 *)ctx->base + ctx->commit_pos - size;
+  bool freed = false;
+
+#      ifdef MADV_FREE
+  /* MADV_FREE is not supported by every kernel and mapping (e.g. MAP_HUGETLB),
+     fall back to releasing the pages right away */
+  if (flags & YORU_VMEM_DECOMMIT_LAZY) freed = madvise(start, size, MADV_FREE) == 0;
+#      endif
+#      if defined(__linux__)
+  if (!freed && madvise(start, size, MADV_DONTNEED) != 0) return false;
+#      else
+  /* MADV_DONTNEED on macos does not guarantee zeroed pages, so map fresh ones
+     over the range instead. They start out as PROT_NONE like after reserving */
+  if (!freed) {
+    anyptr ptr = mmap(start, size, PROT_NONE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return false;
+  }
+#      endif
+  if ((flags & YORU_VMEM_DECOMMIT_PROTECT) && mprotect(start, size, PROT_NONE) != 0) return false;
+
+  ctx->commit_pos -= size;
+  return true;
+}
+
 bool __yoru_vmem_free_linux(Yoru_Vmem_Ctx *ctx) {
   int err = munmap(ctx->base, ctx->addr_space_size);
   if (err != 0) return false;
   ctx->base            = NULL;
   ctx->commit_pos      = 0;
   ctx->addr_space_size = 0;
+  ctx->page_size       = 0;
   return true;
 }
+
+/* values of the mbind modes from <linux/mempolicy.h>, which is not always
+   installed */
+#      define __YORU_MPOL_DEFAULT (0)
+#      define __YORU_MPOL_BIND (2)
+#      define __YORU_MPOL_INTERLEAVE (3)
+
+bool __yoru_vmem_set_numa_policy_linux(Yoru_Vmem_Ctx *ctx, Yoru_Vmem_NumaMode mode, usize node) {
+#      if defined(__linux__) && defined(SYS_mbind)
+  unsigned long mask[__YORU_NUMA_MAX_NODES / __YORU_NUMA_MASK_BITS] = {0};
+
+  usize node_count = yoru_numa_node_count();
+  int   mpol       = __YORU_MPOL_DEFAULT;
+  if (mode == YORU_VMEM_NUMA_BIND) {
+    mpol = __YORU_MPOL_BIND;
+    mask[node / __YORU_NUMA_MASK_BITS] |= 1ul << (node % __YORU_NUMA_MASK_BITS);
+  } else if (mode == YORU_VMEM_NUMA_INTERLEAVE) {
+    mpol = __YORU_MPOL_INTERLEAVE;
+    for (usize i = 0; i < node_count; ++i) {
+      if (yoru_numa_node_online(i)) mask[i / __YORU_NUMA_MASK_BITS] |= 1ul << (i % __YORU_NUMA_MASK_BITS);
+    }
+  }
+
+  /* the kernel reads one bit less than max_node says */
+  anyptr        node_mask = mpol == __YORU_MPOL_DEFAULT ? NULL : mask;
+  unsigned long max_node  = mpol == __YORU_MPOL_DEFAULT ? 0 : __YORU_NUMA_MAX_NODES + 1;
+  if (syscall(SYS_mbind, ctx->base, ctx->addr_space_size, mpol, node_mask, max_node, 0) == 0) return true;
+
+  /* kernels without NUMA support reject the syscall, which only matters if
+     there actually is more than one node */
+  return node_count <= 1;
+#      else
+  (void)ctx;
+  (void)mode;
+  (void)node;
+  return yoru_numa_node_count() <= 1;
+#      endif
+}
 #    endif
 #    if defined(_WIN32)
 bool __yoru_vmem_reserve_windows(usize size, Yoru_Vmem_Ctx *ctx) {
@@ -501,28 +1276,60 @@ bool __yoru_vmem_reserve_windows(usize size, Yoru_Vmem_Ctx *ctx) {
     ctx->base            = NULL;
     ctx->commit_pos      = 0;
     ctx->addr_space_size = 0;
+    ctx->page_size       = 0;
+    ctx->numa_node       = 0;
     return false;
   }
 
   ctx->base            = ptr;
   ctx->commit_pos      = 0;
   ctx->addr_space_size = size;
+  ctx->page_size       = yoru_get_page_size();
+  ctx->numa_node       = 0;
   return true;
 }
 
+/// commits [ptr, ptr + size) on the node set by `yoru_vmem_set_numa_policy`
+static inline bool __yoru_vmem_commit_range_windows(Yoru_Vmem_Ctx *ctx, anyptr ptr, usize size) {
+  if (ctx->numa_node) {
+    DWORD node = (DWORD)(ctx->numa_node - 1);
+    return VirtualAllocExNuma(GetCurrentProcess(), ptr, size, MEM_COMMIT, PAGE_READWRITE, node) != NULL;
+  }
+  return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+
 bool __yoru_vmem_commit_windows(Yoru_Vmem_Ctx *ctx, usize size) {
-  usize  size_aligned = yoru_align_up(size, yoru_get_page_size());
-  anyptr ptr          = VirtualAlloc((u8 *)ctx->base + ctx->commit_pos, size_aligned, MEM_COMMIT, PAGE_READWRITE);
-  if (!ptr) return false;
+  usize size_aligned = yoru_align_up(size, ctx->page_size ? ctx->page_size : yoru_get_page_size());
+  if (!__yoru_vmem_commit_range_windows(ctx, (u8 *)ctx->base + ctx->commit_pos, size_aligned)) return false;
   ctx->commit_pos += size_aligned;
   return true;
 }
 
+bool __yoru_vmem_commit_at_windows(Yoru_Vmem_Ctx *ctx, usize offset, usize size) {
+  return __yoru_vmem_commit_range_windows(ctx, (u8 *)ctx->base + offset, size);
+}
+
+bool __yoru_vmem_set_numa_policy_windows(Yoru_Vmem_Ctx *ctx, Yoru_Vmem_NumaMode mode, usize node) {
+  /* windows places memory when committing, so remember the node for later.
+     There is no interleaving, those reservations keep the default placement */
+  ctx->numa_node = mode == YORU_VMEM_NUMA_BIND ? node + 1 : 0;
+  return true;
+}
+
+bool __yoru_vmem_decommit_windows(Yoru_Vmem_Ctx *ctx, usize size) {
+  u8 *start = (u8 *)ctx->base + ctx->commit_pos - size;
+  if (!VirtualFree(start, size, MEM_DECOMMIT)) return false;
+  ctx->commit_pos -= size;
+  return true;
+}
+
 bool __yoru_vmem_free_windows(Yoru_Vmem_Ctx *ctx) {
-  if (!VirtualFree(ctx->base, ctx->addr_space_size, MEM_RELEASE)) return false;
+  if (!VirtualFree(ctx->base, 0, MEM_RELEASE)) return false;
   ctx->base            = NULL;
   ctx->commit_pos      = 0;
   ctx->addr_space_size = 0;
+  ctx->page_size       = 0;
+  ctx->numa_node       = 0;
   return true;
 }
 #    endif // Platform Check
@@ -546,247 +1353,4773 @@ bool __yoru_vmem_free_windows(Yoru_Vmem_Ctx *ctx) {
 
 typedef Yoru_Allocator Yoru_VirtualArenaAllocator;
 
-/// @brief Creates an instance of a `VirtualArenaAllocator` with one committed
-/// page.
+/// @brief Controls how a `VirtualArenaAllocator` commits its reservation.
+/// Fields that are 0 use the defaults below.
+typedef struct Yoru_VirtualArenaOptions {
+  /// size of the first commit, every following commit doubles in size
+  usize min_commit_size;
+  /// upper bound for the size of a single commit
+  usize max_commit_size;
+  /// passed to `yoru_vmem_reserve_with_flags`, e.g. to request huge pages
+  Yoru_Vmem_Flags vmem_flags;
+  /// when non-zero, `restore` and `reset` hand committed pages above this many
+  /// bytes (or above the arena position if that is higher) back to the OS
+  usize decommit_above;
+  /// passed to `yoru_vmem_decommit` by the decommit policy
+  Yoru_Vmem_DecommitFlags decommit_flags;
+  /// passed to `yoru_vmem_set_numa_policy` right after reserving, e.g. to keep
+  /// the memory of a worker on its own node
+  Yoru_Vmem_NumaMode numa_mode;
+  /// the node for YORU_VMEM_NUMA_BIND
+  usize numa_node;
+} Yoru_VirtualArenaOptions;
+
+#  define YORU_VIRTUAL_ARENA_MIN_COMMIT_SIZE (YORU_KiB(64))
+#  define YORU_VIRTUAL_ARENA_MAX_COMMIT_SIZE (YORU_MiB(64))
+
+/// @brief Creates an instance of a `VirtualArenaAllocator` using the default
+/// options. Nothing is committed until the first allocation.
 Yoru_VirtualArenaAllocator *yoru_virtual_arena_allocator_make(usize capacity);
 
-#  ifdef YORU_IMPL
-Yoru_Opt __yoru_virtual_arena_allocator_alloc(anyptr ctx, usize size);
-void     __yoru_virtual_arena_allocator_dealloc(anyptr ctx, anyptr ptr);
-Yoru_Opt __yoru_virtual_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
-void     __yoru_virtual_arena_allocator_destroy(anyptr ctx);
+/// @brief Creates an instance of a `VirtualArenaAllocator` using `options`
+Yoru_VirtualArenaAllocator *
+yoru_virtual_arena_allocator_make_with_options(usize capacity, Yoru_VirtualArenaOptions options);
+
+/// @brief Creates one `VirtualArenaAllocator` per NUMA node, the one at index
+/// `i` being bound to node `i`, so workers can allocate from
+/// `out_arenas[yoru_numa_current_node()]`. `out_arenas` needs room for
+/// `yoru_numa_node_count()` arenas, the slots of node ids that are not online
+/// are set to NULL. The options' NUMA fields are ignored. Returns false
+/// (without leaving any arena behind) if one can not be created
+bool yoru_virtual_arena_allocator_make_per_node(
+    usize                        capacity,
+    Yoru_VirtualArenaOptions     options,
+    Yoru_VirtualArenaAllocator **out_arenas);
+
+/// @brief Returns a marker to the current position of the arena
+Yoru_ArenaMarker yoru_virtual_arena_allocator_get_marker(Yoru_VirtualArenaAllocator *allocator);
+
+/// @brief Rolls the arena back to `marker`. Everything allocated after the
+/// marker was taken must not be used anymore. Committed pages stay committed
+/// unless the arena was created with `decommit_above`.
+void yoru_virtual_arena_allocator_restore(Yoru_VirtualArenaAllocator *allocator, Yoru_ArenaMarker marker);
+
+/// @brief Rolls the arena back to the start. Committed pages stay committed
+/// and are reused by the next allocations, except for the ones above
+/// `decommit_above` if the arena was created with that option.
+void yoru_virtual_arena_allocator_reset(Yoru_VirtualArenaAllocator *allocator);
+
+typedef struct Yoru_VirtualArenaAllocatorCtx {
+  usize          offset;
+  usize          last_offset; // start of the most recent allocation, which can be resized in place
+  usize          high_water;  // everything above was never handed out and is still zeroed
+  usize          next_commit_size;
+  usize          max_commit_size;
+  usize          decommit_above;
+  Yoru_Vmem_Ctx *vmem_ctx;
+
+  Yoru_Vmem_DecommitFlags decommit_flags;
+} Yoru_VirtualArenaAllocatorCtx;
+
+#  ifdef YORU_IMPL
+Yoru_Opt __yoru_virtual_arena_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_virtual_arena_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_virtual_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_virtual_arena_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_virtual_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_virtual_arena_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_virtual_arena_allocator_vtable = {
+    .alloc         = __yoru_virtual_arena_allocator_alloc,
+    .alloc_uninit  = __yoru_virtual_arena_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_virtual_arena_allocator_alloc_aligned,
+    .dealloc       = __yoru_virtual_arena_allocator_dealloc,
+    .realloc       = __yoru_virtual_arena_allocator_realloc,
+    .destroy       = __yoru_virtual_arena_allocator_destroy,
+};
+
+Yoru_VirtualArenaAllocator *yoru_virtual_arena_allocator_make(usize capacity) {
+  return yoru_virtual_arena_allocator_make_with_options(capacity, (Yoru_VirtualArenaOptions){0});
+}
+
+Yoru_VirtualArenaAllocator *
+yoru_virtual_arena_allocator_make_with_options(usize capacity, Yoru_VirtualArenaOptions options) {
+  Yoru_VirtualArenaAllocatorCtx *ctx      = NULL;
+  Yoru_Vmem_Ctx                 *vmem_ctx = NULL;
+
+  Yoru_VirtualArenaAllocator *a = calloc(1, sizeof(Yoru_VirtualArenaAllocator));
+  if (!a) return NULL;
+
+  ctx = calloc(1, sizeof(Yoru_VirtualArenaAllocatorCtx));
+  if (!ctx) goto err;
+
+  vmem_ctx = calloc(1, sizeof *vmem_ctx);
+  if (!vmem_ctx) goto err;
+
+  capacity = yoru_align_up(capacity, yoru_get_page_size());
+  if (!yoru_vmem_reserve_with_flags(capacity, options.vmem_flags, vmem_ctx)) goto err;
+  if (options.numa_mode != YORU_VMEM_NUMA_DEFAULT &&
+      !yoru_vmem_set_numa_policy(vmem_ctx, options.numa_mode, options.numa_node)) {
+    goto err;
+  }
+
+  if (!options.min_commit_size) options.min_commit_size = YORU_VIRTUAL_ARENA_MIN_COMMIT_SIZE;
+  if (!options.max_commit_size) options.max_commit_size = YORU_VIRTUAL_ARENA_MAX_COMMIT_SIZE;
+  if (options.max_commit_size < options.min_commit_size) options.max_commit_size = options.min_commit_size;
+
+  ctx->offset           = 0;
+  ctx->last_offset      = 0;
+  ctx->high_water       = 0;
+  ctx->next_commit_size = options.min_commit_size;
+  ctx->max_commit_size  = options.max_commit_size;
+  ctx->decommit_above   = options.decommit_above;
+  ctx->decommit_flags   = options.decommit_flags;
+  ctx->vmem_ctx         = vmem_ctx;
+
+  a->vtable = &__yoru_virtual_arena_allocator_vtable;
+  a->ctx    = ctx;
+  return a;
+
+err:
+  if (vmem_ctx) {
+    if (vmem_ctx->base) yoru_vmem_free(vmem_ctx);
+    free(vmem_ctx);
+  }
+  free(ctx);
+  free(a);
+  return NULL;
+}
+
+bool yoru_virtual_arena_allocator_make_per_node(
+    usize                        capacity,
+    Yoru_VirtualArenaOptions     options,
+    Yoru_VirtualArenaAllocator **out_arenas) {
+  assert(out_arenas && "must not be null");
+  usize node_count  = yoru_numa_node_count();
+  options.numa_mode = node_count > 1 ? YORU_VMEM_NUMA_BIND : YORU_VMEM_NUMA_DEFAULT;
+
+  for (usize node = 0; node < node_count; ++node) {
+    out_arenas[node] = NULL;
+    if (!yoru_numa_node_online(node)) continue;
+    options.numa_node = node;
+    out_arenas[node]  = yoru_virtual_arena_allocator_make_with_options(capacity, options);
+    if (!out_arenas[node]) {
+      while (node > 0) {
+        if (out_arenas[--node]) yoru_allocator_destroy(out_arenas[node]);
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+/// makes sure that at least `needed` bytes of the reservation are usable.
+/// Commits happen in geometrically growing steps, so filling the arena only
+/// takes a logarithmic amount of syscalls
+static inline bool __yoru_virtual_arena_commit_to(Yoru_VirtualArenaAllocatorCtx *arena, usize needed) {
+  Yoru_Vmem_Ctx *vm = arena->vmem_ctx;
+  if (needed <= vm->commit_pos) return true;
+  if (needed > vm->addr_space_size) return false;
+
+  usize step      = needed - vm->commit_pos;
+  usize remaining = vm->addr_space_size - vm->commit_pos;
+  if (step < arena->next_commit_size) step = arena->next_commit_size;
+  if (step > remaining) step = remaining;
+  if (!yoru_vmem_commit(vm, step)) return false;
+
+  arena->next_commit_size *= 2;
+  if (arena->next_commit_size > arena->max_commit_size) arena->next_commit_size = arena->max_commit_size;
+  return true;
+}
+
+/// returns the committed pages above the `decommit_above` mark to the OS while
+/// keeping the reservation, so peak usage does not stick around after a reset
+static inline void __yoru_virtual_arena_decommit_tail(Yoru_VirtualArenaAllocatorCtx *arena) {
+  Yoru_Vmem_Ctx *vm   = arena->vmem_ctx;
+  usize          keep = arena->offset > arena->decommit_above ? arena->offset : arena->decommit_above;
+  keep                = yoru_align_up(keep, vm->page_size);
+  if (vm->commit_pos <= keep) return;
+
+  /* not being able to decommit is not an error, the pages just stay around */
+  if (!yoru_vmem_decommit(vm, vm->commit_pos - keep, arena->decommit_flags)) return;
+
+  /* pages that were released right away come back zeroed, lazily freed ones
+     might still hold old data and have to be cleared on reuse */
+  if (!(arena->decommit_flags & YORU_VMEM_DECOMMIT_LAZY) && arena->high_water > vm->commit_pos) {
+    arena->high_water = vm->commit_pos;
+  }
+}
+
+static inline Yoru_Opt
+__yoru_virtual_arena_bump(Yoru_VirtualArenaAllocatorCtx *arena, usize size, usize alignment, bool zeroed) {
+  Yoru_Vmem_Ctx *vm = arena->vmem_ctx;
+
+  /* align the address and not the offset so alignments above the page size
+     work as well */
+  usize start = yoru_align_up((usize)vm->base + arena->offset, alignment) - (usize)vm->base;
+  if (!__yoru_virtual_arena_commit_to(arena, start + size)) return yoru_opt_none();
+  if (zeroed) {
+    __yoru_arena_clear_reused(vm->base, &arena->high_water, start, start + size);
+  } else if (start + size > arena->high_water) {
+    arena->high_water = start + size;
+  }
+
+  anyptr ptr         = (char *)vm->base + start;
+  arena->last_offset = start;
+  arena->offset      = start + size;
+
+  return yoru_opt_some(ptr);
+}
+
+Yoru_Opt __yoru_virtual_arena_allocator_alloc(anyptr ctx, usize size) {
+  return __yoru_virtual_arena_allocator_alloc_aligned(ctx, size, YORU_DEFAULT_ALIGNMENT);
+}
+
+Yoru_Opt __yoru_virtual_arena_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_virtual_arena_bump(ctx, size, YORU_DEFAULT_ALIGNMENT, false);
+}
+
+Yoru_Opt __yoru_virtual_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_virtual_arena_bump(ctx, size, alignment, true);
+}
+
+void __yoru_virtual_arena_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  (void)ptr;
+  /* Freeing in an arena is a no-op because the idea is that you free the entire
+     arena once. For that you would call the yoru_allocator_destroy func on the
+     arena allocator */
+}
+
+Yoru_Opt __yoru_virtual_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_virtual_arena_allocator_alloc(ctx, new_size);
+
+  Yoru_VirtualArenaAllocatorCtx *arena = ctx;
+  Yoru_Vmem_Ctx                 *vm    = arena->vmem_ctx;
+
+  /* The most recent allocation sits at the end of the arena, so it can just
+     grow or shrink by moving the offset (and committing more pages) without
+     copying anything. Memory it grows into that was handed out before a
+     restore is cleared like on alloc */
+  if ((char *)old_ptr == (char *)vm->base + arena->last_offset) {
+    if (!__yoru_virtual_arena_commit_to(arena, arena->last_offset + new_size)) return yoru_opt_none();
+    arena->offset = arena->last_offset + new_size;
+    if (new_size > old_size) {
+      __yoru_arena_clear_reused(vm->base, &arena->high_water, arena->last_offset + old_size, arena->offset);
+    }
+    return yoru_opt_some(old_ptr);
+  }
+
+  /* Everything else is pushed to the end of the arena as a new allocation. The
+     old block stays where it is until the arena is destroyed. */
+  Yoru_Opt maybe_new_ptr = __yoru_virtual_arena_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  return maybe_new_ptr;
+}
+
+Yoru_ArenaMarker yoru_virtual_arena_allocator_get_marker(Yoru_VirtualArenaAllocator *allocator) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_virtual_arena_allocator_vtable && "not a virtual arena allocator");
+  Yoru_VirtualArenaAllocatorCtx *arena = allocator->ctx;
+  return (Yoru_ArenaMarker){.offset = arena->offset, .last_offset = arena->last_offset};
+}
+
+void yoru_virtual_arena_allocator_restore(Yoru_VirtualArenaAllocator *allocator, Yoru_ArenaMarker marker) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_virtual_arena_allocator_vtable && "not a virtual arena allocator");
+  Yoru_VirtualArenaAllocatorCtx *arena = allocator->ctx;
+  assert(marker.offset <= arena->offset && "marker is newer than the arena position");
+
+  arena->offset      = marker.offset;
+  arena->last_offset = marker.last_offset;
+  if (arena->decommit_above) __yoru_virtual_arena_decommit_tail(arena);
+}
+
+void yoru_virtual_arena_allocator_reset(Yoru_VirtualArenaAllocator *allocator) {
+  yoru_virtual_arena_allocator_restore(allocator, (Yoru_ArenaMarker){0});
+}
+
+void __yoru_virtual_arena_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  Yoru_VirtualArenaAllocatorCtx *c = (Yoru_VirtualArenaAllocatorCtx *)ctx;
+  assert(c->vmem_ctx && "must not be null");
+
+  yoru_vmem_free(c->vmem_ctx);
+  free(c->vmem_ctx);
+  free(c);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: PersistentArenaAllocator
+   provides an arena that lives in a memory-mapped file, so the
+   data structures built in it can be mapped back by a later
+   process without parsing or rebuilding anything.
+
+   The first page of the file holds a header with the arena
+   position and a root offset, the rest is handed out like in a
+   `VirtualArenaAllocator`. Pages are only written to the file
+   once they are touched.
+
+   Plain pointers into the arena only stay valid if it is mapped
+   at the same address again. Pass a `base` address when the
+   file is created to get that (it is stored in the header and
+   used on every open), or store offsets instead of pointers:
+   ```c
+   Yoru_PersistentArenaAllocator *arena =
+       yoru_persistent_arena_allocator_open("table.bin", YORU_PERSISTENT_ARENA_DEFAULT_BASE, YORU_GiB(1));
+   Table *table = yoru_persistent_arena_allocator_get_root(arena);
+   if (!table) {
+     table = build_table(arena); // everything allocated from `arena`
+     yoru_persistent_arena_allocator_set_root(arena, table);
+   }
+   ```
+   Structures that keep a `Yoru_Allocator *` (ArrayList, HashMap)
+   must not be used across processes without re-attaching the
+   allocator, and HashMap keys live on the heap.
+   ============================================================ */
+
+/// @brief a base address that is far away from where the OS usually maps
+/// things, meant for a single persistent arena per process
+#  define YORU_PERSISTENT_ARENA_DEFAULT_BASE ((anyptr)(uintptr_t)0x200000000000ull)
+
+typedef Yoru_Allocator Yoru_PersistentArenaAllocator;
+
+/// @brief Opens the arena in the file at `path` or creates it with room for
+/// `capacity` bytes. An existing file keeps its capacity and base. With a NULL
+/// `base` the OS picks the address and only offsets stay valid across runs.
+/// Returns NULL if the file is not an arena or its base is not available
+Yoru_PersistentArenaAllocator *yoru_persistent_arena_allocator_open(cstr path, anyptr base, usize capacity);
+
+/// @brief Flushes the arena to its file. Happens on destroy as well
+bool yoru_persistent_arena_allocator_sync(Yoru_PersistentArenaAllocator *allocator);
+
+/// @brief Stores `root` (memory from the arena or NULL) as the entry point
+/// for the next process that opens the arena
+void yoru_persistent_arena_allocator_set_root(Yoru_PersistentArenaAllocator *allocator, anyptr root);
+
+/// @brief Returns the root that was stored last, or NULL for a fresh arena
+anyptr yoru_persistent_arena_allocator_get_root(Yoru_PersistentArenaAllocator *allocator);
+
+/// @brief Converts a pointer into the arena to an offset that stays valid
+/// wherever the arena is mapped. NULL becomes 0
+usize yoru_persistent_arena_allocator_to_offset(Yoru_PersistentArenaAllocator *allocator, anyptr ptr);
+
+/// @brief Converts an offset back to a pointer. 0 becomes NULL
+anyptr yoru_persistent_arena_allocator_from_offset(Yoru_PersistentArenaAllocator *allocator, usize offset);
+
+/// @brief Rolls the arena back to the start and clears the root
+void yoru_persistent_arena_allocator_reset(Yoru_PersistentArenaAllocator *allocator);
+
+#  ifdef YORU_IMPL
+Yoru_Opt __yoru_persistent_arena_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_persistent_arena_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_persistent_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_persistent_arena_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_persistent_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_persistent_arena_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_persistent_arena_allocator_vtable = {
+    .alloc         = __yoru_persistent_arena_allocator_alloc,
+    .alloc_uninit  = __yoru_persistent_arena_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_persistent_arena_allocator_alloc_aligned,
+    .dealloc       = __yoru_persistent_arena_allocator_dealloc,
+    .realloc       = __yoru_persistent_arena_allocator_realloc,
+    .destroy       = __yoru_persistent_arena_allocator_destroy,
+};
+
+#    define __YORU_PERSISTENT_ARENA_MAGIC (0x4e4552414f524f59ull) // "YOROAREN"
+#    define __YORU_PERSISTENT_ARENA_VERSION (1)
+
+/* sits at the start of the file, offsets are relative to it */
+typedef struct Yoru_PersistentArenaHeader {
+  u64 magic;
+  u64 version;
+  u64 base; // address the arena was created at, 0 if it can be mapped anywhere
+  u64 capacity;
+  u64 data_start;
+  u64 offset;
+  u64 high_water; // everything above was never handed out and is still zeroed
+  u64 root;
+} Yoru_PersistentArenaHeader;
+
+typedef struct Yoru_PersistentArenaAllocatorCtx {
+  Yoru_PersistentArenaHeader *header;
+  usize                       last_offset; // start of the most recent allocation, which can be resized in place
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  int fd;
+#    elif defined(_WIN32)
+  HANDLE file;
+  HANDLE mapping;
+#    endif
+
+  Yoru_PersistentArenaAllocator allocator;
+} Yoru_PersistentArenaAllocatorCtx;
+
+static bool __yoru_persistent_arena_header_valid(Yoru_PersistentArenaHeader *header, usize file_size) {
+  return header->magic == __YORU_PERSISTENT_ARENA_MAGIC && header->version == __YORU_PERSISTENT_ARENA_VERSION &&
+         header->capacity == file_size && header->data_start <= header->offset && header->offset <= header->capacity &&
+         header->high_water <= header->capacity && header->root < header->capacity;
+}
+
+static void __yoru_persistent_arena_header_init(Yoru_PersistentArenaHeader *header, anyptr base, usize capacity) {
+  usize data_start   = yoru_align_up(sizeof(Yoru_PersistentArenaHeader), yoru_get_page_size());
+  header->magic      = __YORU_PERSISTENT_ARENA_MAGIC;
+  header->version    = __YORU_PERSISTENT_ARENA_VERSION;
+  header->base       = (u64)(uintptr_t)base;
+  header->capacity   = capacity;
+  header->data_start = data_start;
+  header->offset     = data_start;
+  header->high_water = data_start;
+  header->root       = 0;
+}
+
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+/// maps `size` bytes of `fd` at `base`, or anywhere for a NULL base. A base
+/// that is already in use is not replaced
+static anyptr __yoru_persistent_arena_map(int fd, anyptr base, usize size) {
+  anyptr ptr = mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) return NULL;
+  if (base && ptr != base) {
+    munmap(ptr, size);
+    return NULL;
+  }
+  return ptr;
+}
+
+static bool
+__yoru_persistent_arena_open_posix(Yoru_PersistentArenaAllocatorCtx *ctx, cstr path, anyptr base, usize capacity) {
+  int fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return false;
+
+  Yoru_PersistentArenaHeader header = {0};
+  bool                       fresh  = false;
+  struct stat                st     = {0};
+  if (fstat(fd, &st) != 0) goto err;
+  fresh = st.st_size == 0;
+  if (fresh) {
+    if (capacity <= yoru_align_up(sizeof(Yoru_PersistentArenaHeader), yoru_get_page_size())) goto err;
+    if (ftruncate(fd, (off_t)capacity) != 0) goto err;
+  } else {
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) goto err;
+    if (!__yoru_persistent_arena_header_valid(&header, (usize)st.st_size)) goto err;
+    base     = (anyptr)(uintptr_t)header.base;
+    capacity = header.capacity;
+  }
+
+  ctx->header = __yoru_persistent_arena_map(fd, base, capacity);
+  if (!ctx->header) goto err;
+  if (fresh) __yoru_persistent_arena_header_init(ctx->header, base, capacity);
+  ctx->fd = fd;
+  return true;
+
+err:
+  // a fresh file without a valid header would be rejected from now on
+  if (fresh && ftruncate(fd, 0) != 0) remove(path);
+  close(fd);
+  return false;
+}
+#    elif defined(_WIN32)
+static bool
+__yoru_persistent_arena_open_windows(Yoru_PersistentArenaAllocatorCtx *ctx, cstr path, anyptr base, usize capacity) {
+  HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) return false;
+  HANDLE mapping = NULL;
+
+  Yoru_PersistentArenaHeader header    = {0};
+  bool                       fresh     = false;
+  LARGE_INTEGER              file_size = {0};
+  if (!GetFileSizeEx(file, &file_size)) goto err;
+  fresh = file_size.QuadPart == 0;
+  if (fresh && capacity <= yoru_align_up(sizeof(Yoru_PersistentArenaHeader), yoru_get_page_size())) goto err;
+  if (!fresh) {
+    DWORD read = 0;
+    if (!ReadFile(file, &header, sizeof(header), &read, NULL) || read != sizeof(header)) goto err;
+    if (!__yoru_persistent_arena_header_valid(&header, (usize)file_size.QuadPart)) goto err;
+    base     = (anyptr)(uintptr_t)header.base;
+    capacity = header.capacity;
+  }
+
+  // creating the mapping grows a fresh file to `capacity`
+  DWORD high = (DWORD)((u64)capacity >> 32);
+  DWORD low  = (DWORD)((u64)capacity & 0xFFFFFFFF);
+  mapping    = CreateFileMappingA(file, NULL, PAGE_READWRITE, high, low, NULL);
+  if (!mapping) goto err;
+  ctx->header = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity, base);
+  if (!ctx->header) goto err;
+  if (fresh) __yoru_persistent_arena_header_init(ctx->header, base, capacity);
+  ctx->file    = file;
+  ctx->mapping = mapping;
+  return true;
+
+err:
+  if (mapping) CloseHandle(mapping);
+  // a fresh file without a valid header would be rejected from now on
+  if (fresh) SetEndOfFile(file);
+  CloseHandle(file);
+  return false;
+}
+#    endif
+
+Yoru_PersistentArenaAllocator *yoru_persistent_arena_allocator_open(cstr path, anyptr base, usize capacity) {
+  assert(path && "must not be null");
+  capacity = yoru_align_up(capacity, yoru_get_page_size());
+
+  Yoru_PersistentArenaAllocatorCtx *ctx = calloc(1, sizeof(Yoru_PersistentArenaAllocatorCtx));
+  if (!ctx) return NULL;
+
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  bool ok = __yoru_persistent_arena_open_posix(ctx, path, base, capacity);
+#    elif defined(_WIN32)
+  bool ok = __yoru_persistent_arena_open_windows(ctx, path, base, capacity);
+#    endif
+  if (!ok) {
+    free(ctx);
+    return NULL;
+  }
+
+  ctx->last_offset      = ctx->header->offset;
+  ctx->allocator.vtable = &__yoru_persistent_arena_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  return &ctx->allocator;
+}
+
+static inline Yoru_Opt
+__yoru_persistent_arena_bump(Yoru_PersistentArenaAllocatorCtx *arena, usize size, usize alignment, bool zeroed) {
+  Yoru_PersistentArenaHeader *header = arena->header;
+  byte                       *mem    = (byte *)header;
+
+  usize start = yoru_align_up((usize)mem + header->offset, alignment) - (usize)mem;
+  if (start > header->capacity || size > header->capacity - start) return yoru_opt_none();
+  if (zeroed) {
+    usize high_water = header->high_water;
+    __yoru_arena_clear_reused(mem, &high_water, start, start + size);
+    header->high_water = high_water;
+  } else if (start + size > header->high_water) {
+    header->high_water = start + size;
+  }
+
+  arena->last_offset = start;
+  header->offset     = start + size;
+  return yoru_opt_some(mem + start);
+}
+
+Yoru_Opt __yoru_persistent_arena_allocator_alloc(anyptr ctx, usize size) {
+  return __yoru_persistent_arena_allocator_alloc_aligned(ctx, size, YORU_DEFAULT_ALIGNMENT);
+}
+
+Yoru_Opt __yoru_persistent_arena_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_persistent_arena_bump(ctx, size, YORU_DEFAULT_ALIGNMENT, false);
+}
+
+Yoru_Opt __yoru_persistent_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_persistent_arena_bump(ctx, size, alignment, true);
+}
+
+void __yoru_persistent_arena_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  (void)ptr;
+  // like in the ArenaAllocator, everything is freed at once on reset
+}
+
+Yoru_Opt __yoru_persistent_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_persistent_arena_allocator_alloc(ctx, new_size);
+  Yoru_PersistentArenaAllocatorCtx *arena  = ctx;
+  Yoru_PersistentArenaHeader       *header = arena->header;
+
+  // the most recent allocation of this process is resized in place
+  if ((byte *)old_ptr == (byte *)header + arena->last_offset) {
+    if (new_size > header->capacity - arena->last_offset) return yoru_opt_none();
+    header->offset = arena->last_offset + new_size;
+    if (new_size > old_size) {
+      usize high_water = header->high_water;
+      __yoru_arena_clear_reused((byte *)header, &high_water, arena->last_offset + old_size, header->offset);
+      header->high_water = high_water;
+    }
+    return yoru_opt_some(old_ptr);
+  }
+
+  Yoru_Opt maybe_new_ptr = __yoru_persistent_arena_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  return maybe_new_ptr;
+}
+
+static inline Yoru_PersistentArenaAllocatorCtx *__yoru_persistent_arena_ctx(Yoru_PersistentArenaAllocator *allocator) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_persistent_arena_allocator_vtable && "not a persistent arena allocator");
+  return allocator->ctx;
+}
+
+bool yoru_persistent_arena_allocator_sync(Yoru_PersistentArenaAllocator *allocator) {
+  Yoru_PersistentArenaAllocatorCtx *arena = __yoru_persistent_arena_ctx(allocator);
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  return msync(arena->header, arena->header->capacity, MS_SYNC) == 0;
+#    elif defined(_WIN32)
+  return FlushViewOfFile(arena->header, 0) && FlushFileBuffers(arena->file);
+#    endif
+}
+
+void yoru_persistent_arena_allocator_set_root(Yoru_PersistentArenaAllocator *allocator, anyptr root) {
+  __yoru_persistent_arena_ctx(allocator)->header->root = yoru_persistent_arena_allocator_to_offset(allocator, root);
+}
+
+anyptr yoru_persistent_arena_allocator_get_root(Yoru_PersistentArenaAllocator *allocator) {
+  usize root = __yoru_persistent_arena_ctx(allocator)->header->root;
+  return yoru_persistent_arena_allocator_from_offset(allocator, root);
+}
+
+usize yoru_persistent_arena_allocator_to_offset(Yoru_PersistentArenaAllocator *allocator, anyptr ptr) {
+  Yoru_PersistentArenaHeader *header = __yoru_persistent_arena_ctx(allocator)->header;
+  if (!ptr) return 0;
+  assert((byte *)ptr >= (byte *)header + header->data_start && "not memory of this arena");
+  assert((byte *)ptr < (byte *)header + header->capacity && "not memory of this arena");
+  return (usize)((byte *)ptr - (byte *)header);
+}
+
+anyptr yoru_persistent_arena_allocator_from_offset(Yoru_PersistentArenaAllocator *allocator, usize offset) {
+  Yoru_PersistentArenaHeader *header = __yoru_persistent_arena_ctx(allocator)->header;
+  if (offset == 0) return NULL;
+  assert(offset >= header->data_start && offset < header->capacity && "offset out of bounds");
+  return (byte *)header + offset;
+}
+
+void yoru_persistent_arena_allocator_reset(Yoru_PersistentArenaAllocator *allocator) {
+  Yoru_PersistentArenaAllocatorCtx *arena = __yoru_persistent_arena_ctx(allocator);
+  arena->header->offset                   = arena->header->data_start;
+  arena->header->root                     = 0;
+  arena->last_offset                      = arena->header->data_start;
+}
+
+void __yoru_persistent_arena_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  Yoru_PersistentArenaAllocatorCtx *arena = ctx;
+  yoru_persistent_arena_allocator_sync(&arena->allocator);
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  munmap(arena->header, arena->header->capacity);
+  close(arena->fd);
+#    elif defined(_WIN32)
+  UnmapViewOfFile(arena->header);
+  CloseHandle(arena->mapping);
+  CloseHandle(arena->file);
+#    endif
+  free(arena);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: ArenaScratch
+   provides scoped temporary allocations on top of an
+   `ArenaAllocator` or a `VirtualArenaAllocator`.
+
+   A scratch remembers the position of the arena when it begins
+   and rolls the arena back to it when it ends, so everything
+   allocated in between is released at once. Scratches can be
+   nested as long as they end in reverse order:
+   ```c
+   Yoru_ArenaScratch scratch = yoru_arena_scratch_begin(arena);
+   // ... temporary allocations with scratch.arena
+   yoru_arena_scratch_end(&scratch);
+
+   // ... or the same thing as a scope. Leaving the scope with
+   // `break`, `return` or `goto` skips the rollback!
+   yoru_arena_scratch_scope(scratch, arena) {
+     // ... temporary allocations with scratch.arena
+   }
+   ```
+   ============================================================ */
+
+typedef struct Yoru_ArenaScratch {
+  Yoru_Allocator  *arena;
+  Yoru_ArenaMarker marker;
+} Yoru_ArenaScratch;
+
+/// @brief Begins a scratch on an `ArenaAllocator` or `VirtualArenaAllocator`
+Yoru_ArenaScratch yoru_arena_scratch_begin(Yoru_Allocator *arena);
+
+/// @brief Ends a scratch, releasing everything allocated since it began
+void yoru_arena_scratch_end(Yoru_ArenaScratch *scratch);
+
+#  define yoru_arena_scratch_scope(__scratch, __arena_ptr)                                                             \
+    for (Yoru_ArenaScratch __scratch = yoru_arena_scratch_begin((__arena_ptr)), *__yoru_scratch_once = &__scratch;     \
+         __yoru_scratch_once;                                                                                          \
+         yoru_arena_scratch_end(&__scratch), __yoru_scratch_once = NULL)
+
+#  ifdef YORU_IMPL
+Yoru_ArenaScratch yoru_arena_scratch_begin(Yoru_Allocator *arena) {
+  assert(arena && "must not be null");
+  Yoru_ArenaScratch scratch = {.arena = arena};
+  if (arena->vtable == &__yoru_arena_allocator_vtable) {
+    scratch.marker = yoru_arena_allocator_get_marker(arena);
+  } else {
+    scratch.marker = yoru_virtual_arena_allocator_get_marker(arena);
+  }
+  return scratch;
+}
+
+void yoru_arena_scratch_end(Yoru_ArenaScratch *scratch) {
+  assert(scratch && "must not be null");
+  assert(scratch->arena && "scratch already ended");
+  if (scratch->arena->vtable == &__yoru_arena_allocator_vtable) {
+    yoru_arena_allocator_restore(scratch->arena, scratch->marker);
+  } else {
+    yoru_virtual_arena_allocator_restore(scratch->arena, scratch->marker);
+  }
+  scratch->arena = NULL;
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+/* ============================================================
+   MODULE: StaticDispatch
+   provides allocator calls that are resolved at compile time for
+   a known kind of allocator instead of going through the vtable.
+
+   The common case of the arenas (bumping inside memory that is
+   already there) is inlined at the call site, everything else
+   falls back to the vtable. The `_with` variants of the
+   ArrayList and HashMap macros take the same kind:
+   ```c
+   Yoru_ArenaAllocator *arena = yoru_arena_allocator_make(YORU_MiB(1));
+   Yoru_Opt maybe_ptr = yoru_allocator_alloc_with(arena, arena, 64);
+
+   Yoru_ArrayList_T(i32) xs = {0};
+   yoru_arraylist_init_with(arena, &xs, arena, 0);
+   yoru_arraylist_append_with(arena, &xs, 42);
+   ```
+
+   Kinds: `dynamic` (any allocator, always uses the vtable),
+   `arena`, `virtual_arena` and `chained_arena`. Passing an
+   allocator of another kind than the one named is undefined.
+   ============================================================ */
+
+#define yoru_allocator_alloc_with(__kind, __allocator_ptr, __size)                                                     \
+  yoru_##__kind##_allocator_alloc_inline((__allocator_ptr), (__size))
+
+#define yoru_allocator_alloc_uninit_with(__kind, __allocator_ptr, __size)                                              \
+  yoru_##__kind##_allocator_alloc_uninit_inline((__allocator_ptr), (__size))
+
+#define yoru_allocator_dealloc_with(__kind, __allocator_ptr, __ptr)                                                    \
+  yoru_##__kind##_allocator_dealloc_inline((__allocator_ptr), (__ptr))
+
+#define yoru_allocator_realloc_with(__kind, __allocator_ptr, __old_size, __old_ptr, __new_size)                        \
+  yoru_##__kind##_allocator_realloc_inline((__allocator_ptr), (__old_size), (__old_ptr), (__new_size))
+
+// the `dynamic` kind is the regular interface
+#define yoru_dynamic_allocator_alloc_inline yoru_allocator_alloc
+#define yoru_dynamic_allocator_alloc_uninit_inline yoru_allocator_alloc_uninit
+#define yoru_dynamic_allocator_dealloc_inline yoru_allocator_dealloc
+#define yoru_dynamic_allocator_realloc_inline yoru_allocator_realloc
+
+/// bumps `size` bytes at the default alignment out of [base, base + limit) and
+/// returns NULL if they do not fit. Every arena base is aligned to at least
+/// YORU_DEFAULT_ALIGNMENT. Without a `high_water` zeroed memory is always
+/// cleared
+static inline anyptr __yoru_bump_inline(
+    byte  *base,
+    usize  limit,
+    usize *offset,
+    usize *last_offset,
+    usize *high_water,
+    usize  size,
+    bool   zeroed) {
+  usize start = (*offset + YORU_DEFAULT_ALIGNMENT - 1) & ~(usize)(YORU_DEFAULT_ALIGNMENT - 1);
+  if (start > limit || size > limit - start) return NULL;
+
+  usize end = start + size;
+  if (!high_water) {
+    if (zeroed) memset(base + start, 0, size);
+  } else {
+    if (zeroed && start < *high_water) memset(base + start, 0, (end < *high_water ? end : *high_water) - start);
+    if (end > *high_water) *high_water = end;
+  }
+  *last_offset = start;
+  *offset      = end;
+  return base + start;
+}
+
+/// resizes the most recent allocation in place if it stays below `limit`,
+/// clearing what it grows into below `high_water`
+static inline bool __yoru_bump_resize_inline(
+    byte  *base,
+    usize  limit,
+    usize *offset,
+    usize  last_offset,
+    usize *high_water,
+    anyptr ptr,
+    usize  old_size,
+    usize  new_size) {
+  if (!ptr || (byte *)ptr != base + last_offset || new_size > limit - last_offset) return false;
+  *offset = last_offset + new_size;
+  if (!high_water) return true;
+
+  usize grown_start = last_offset + old_size;
+  if (new_size > old_size && grown_start < *high_water) {
+    memset(base + grown_start, 0, (*offset < *high_water ? *offset : *high_water) - grown_start);
+  }
+  if (*offset > *high_water) *high_water = *offset;
+  return true;
+}
+
+static inline Yoru_Opt __yoru_arena_alloc_inline(Yoru_ArenaAllocator *allocator, usize size, bool zeroed) {
+  Yoru_ArenaAllocatorCtx *a = allocator->ctx;
+  anyptr ptr = __yoru_bump_inline(a->mem, a->capacity, &a->offset, &a->last_offset, &a->high_water, size, zeroed);
+  return (Yoru_Opt){.ptr = ptr, .has_value = ptr != NULL};
+}
+
+static inline Yoru_Opt yoru_arena_allocator_alloc_inline(Yoru_ArenaAllocator *allocator, usize size) {
+  return __yoru_arena_alloc_inline(allocator, size, true);
+}
+
+static inline Yoru_Opt yoru_arena_allocator_alloc_uninit_inline(Yoru_ArenaAllocator *allocator, usize size) {
+  return __yoru_arena_alloc_inline(allocator, size, false);
+}
+
+static inline void yoru_arena_allocator_dealloc_inline(Yoru_ArenaAllocator *allocator, anyptr ptr) {
+  (void)allocator;
+  (void)ptr;
+}
+
+static inline Yoru_Opt
+yoru_arena_allocator_realloc_inline(Yoru_ArenaAllocator *allocator, usize old_size, anyptr old_ptr, usize new_size) {
+  Yoru_ArenaAllocatorCtx *a = allocator->ctx;
+  if (__yoru_bump_resize_inline(
+          a->mem, a->capacity, &a->offset, a->last_offset, &a->high_water, old_ptr, old_size, new_size))
+    return (Yoru_Opt){.ptr = old_ptr, .has_value = true};
+  return yoru_allocator_realloc(allocator, old_size, old_ptr, new_size);
+}
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/// only bumps inside the committed memory, committing more goes through the
+/// vtable
+static inline Yoru_Opt
+__yoru_virtual_arena_alloc_inline(Yoru_VirtualArenaAllocator *allocator, usize size, bool zeroed) {
+  Yoru_VirtualArenaAllocatorCtx *a  = allocator->ctx;
+  Yoru_Vmem_Ctx                 *vm = a->vmem_ctx;
+  anyptr ptr = __yoru_bump_inline(vm->base, vm->commit_pos, &a->offset, &a->last_offset, &a->high_water, size, zeroed);
+  if (ptr) return (Yoru_Opt){.ptr = ptr, .has_value = true};
+  return zeroed ? yoru_allocator_alloc(allocator, size) : yoru_allocator_alloc_uninit(allocator, size);
+}
+
+static inline Yoru_Opt yoru_virtual_arena_allocator_alloc_inline(Yoru_VirtualArenaAllocator *allocator, usize size) {
+  return __yoru_virtual_arena_alloc_inline(allocator, size, true);
+}
+
+static inline Yoru_Opt
+yoru_virtual_arena_allocator_alloc_uninit_inline(Yoru_VirtualArenaAllocator *allocator, usize size) {
+  return __yoru_virtual_arena_alloc_inline(allocator, size, false);
+}
+
+static inline void yoru_virtual_arena_allocator_dealloc_inline(Yoru_VirtualArenaAllocator *allocator, anyptr ptr) {
+  (void)allocator;
+  (void)ptr;
+}
+
+static inline Yoru_Opt yoru_virtual_arena_allocator_realloc_inline(
+    Yoru_VirtualArenaAllocator *allocator,
+    usize                       old_size,
+    anyptr                      old_ptr,
+    usize                       new_size) {
+  Yoru_VirtualArenaAllocatorCtx *a     = allocator->ctx;
+  usize                          limit = a->vmem_ctx->commit_pos;
+  byte                          *base  = a->vmem_ctx->base;
+  if (__yoru_bump_resize_inline(base, limit, &a->offset, a->last_offset, &a->high_water, old_ptr, old_size, new_size))
+    return (Yoru_Opt){.ptr = old_ptr, .has_value = true};
+  return yoru_allocator_realloc(allocator, old_size, old_ptr, new_size);
+}
+#endif // Platform Check
+
+/// only bumps inside the current block, chaining a new one goes through the
+/// vtable
+static inline Yoru_Opt
+__yoru_chained_arena_alloc_inline(Yoru_ChainedArenaAllocator *allocator, usize size, bool zeroed) {
+  Yoru_ChainedArenaAllocatorCtx *a    = allocator->ctx;
+  byte                          *data = __yoru_chained_arena_data(a->current);
+  anyptr ptr = __yoru_bump_inline(data, a->current->capacity, &a->offset, &a->last_offset, NULL, size, zeroed);
+  if (ptr) return (Yoru_Opt){.ptr = ptr, .has_value = true};
+  return zeroed ? yoru_allocator_alloc(allocator, size) : yoru_allocator_alloc_uninit(allocator, size);
+}
+
+static inline Yoru_Opt yoru_chained_arena_allocator_alloc_inline(Yoru_ChainedArenaAllocator *allocator, usize size) {
+  return __yoru_chained_arena_alloc_inline(allocator, size, true);
+}
+
+static inline Yoru_Opt
+yoru_chained_arena_allocator_alloc_uninit_inline(Yoru_ChainedArenaAllocator *allocator, usize size) {
+  return __yoru_chained_arena_alloc_inline(allocator, size, false);
+}
+
+static inline void yoru_chained_arena_allocator_dealloc_inline(Yoru_ChainedArenaAllocator *allocator, anyptr ptr) {
+  (void)allocator;
+  (void)ptr;
+}
+
+static inline Yoru_Opt yoru_chained_arena_allocator_realloc_inline(
+    Yoru_ChainedArenaAllocator *allocator,
+    usize                       old_size,
+    anyptr                      old_ptr,
+    usize                       new_size) {
+  Yoru_ChainedArenaAllocatorCtx *a    = allocator->ctx;
+  byte                          *data = __yoru_chained_arena_data(a->current);
+  if (__yoru_bump_resize_inline(
+          data, a->current->capacity, &a->offset, a->last_offset, NULL, old_ptr, old_size, new_size))
+    return (Yoru_Opt){.ptr = old_ptr, .has_value = true};
+  return yoru_allocator_realloc(allocator, old_size, old_ptr, new_size);
+}
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: SlabAllocator
+   provides a size-class allocator for small objects that are
+   allocated and freed individually (unlike in an arena).
+
+   Every size class owns a slice of one reserved address space
+   which is committed in chunks of `YORU_SLAB_COMMIT_SIZE` and
+   carved into blocks of the same size. Freed blocks are pushed
+   onto the free list of their class and handed out again by the
+   next allocation of that class, so alloc and dealloc are O(1)
+   and only talk to the OS when a class needs a new chunk.
+
+   Blocks are aligned to their size class, so aligned
+   allocations just pick a class that is at least as big as the
+   alignment. Allocations larger than `YORU_SLAB_MAX_BLOCK_SIZE`
+   are forwarded to the `GlobalAllocator`.
+   ============================================================ */
+
+#  define YORU_SLAB_MIN_BLOCK_SIZE (16)
+#  define YORU_SLAB_MAX_BLOCK_SIZE (2048)
+#  define YORU_SLAB_CLASS_COUNT (8) // 16, 32, 64, ..., 2048
+#  define YORU_SLAB_COMMIT_SIZE (YORU_KiB(64))
+
+typedef Yoru_Allocator Yoru_SlabAllocator;
+
+/// @brief Creates a slab allocator which reserves `class_capacity` bytes of
+/// address space for every size class. Nothing is committed until the first
+/// allocation of a class.
+Yoru_SlabAllocator *yoru_slab_allocator_make(usize class_capacity);
+
+#  ifdef YORU_IMPL
+Yoru_Opt __yoru_slab_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_slab_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_slab_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_slab_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_slab_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_slab_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_slab_allocator_vtable = {
+    .alloc         = __yoru_slab_allocator_alloc,
+    .alloc_uninit  = __yoru_slab_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_slab_allocator_alloc_aligned,
+    .dealloc       = __yoru_slab_allocator_dealloc,
+    .realloc       = __yoru_slab_allocator_realloc,
+    .destroy       = __yoru_slab_allocator_destroy,
+};
+
+typedef struct Yoru_SlabFreeBlock {
+  struct Yoru_SlabFreeBlock *next;
+} Yoru_SlabFreeBlock;
+
+typedef struct Yoru_SlabClass {
+  Yoru_SlabFreeBlock *free_list;
+  usize               block_size;
+  usize               bump; // offset of the first block that was never handed out
+  Yoru_Vmem_Ctx       vmem; // view into the part of the reservation owned by this class
+} Yoru_SlabClass;
+
+typedef struct Yoru_SlabAllocatorCtx {
+  Yoru_Vmem_Ctx      vmem_ctx; // the whole reservation, shared by all classes
+  usize              class_capacity;
+  Yoru_SlabClass     classes[YORU_SLAB_CLASS_COUNT];
+  Yoru_SlabAllocator allocator;
+} Yoru_SlabAllocatorCtx;
+
+Yoru_SlabAllocator *yoru_slab_allocator_make(usize class_capacity) {
+  Yoru_SlabAllocatorCtx *ctx = calloc(1, sizeof(Yoru_SlabAllocatorCtx));
+  if (!ctx) return NULL;
+
+  class_capacity = yoru_align_up(class_capacity, YORU_SLAB_COMMIT_SIZE);
+  if (!yoru_vmem_reserve(class_capacity * YORU_SLAB_CLASS_COUNT, &ctx->vmem_ctx)) {
+    free(ctx);
+    return NULL;
+  }
+
+  ctx->class_capacity = class_capacity;
+  for (usize i = 0; i < YORU_SLAB_CLASS_COUNT; ++i) {
+    Yoru_SlabClass *c       = &ctx->classes[i];
+    c->free_list            = NULL;
+    c->block_size           = (usize)YORU_SLAB_MIN_BLOCK_SIZE << i;
+    c->bump                 = 0;
+    c->vmem.base            = (u8 *)ctx->vmem_ctx.base + i * class_capacity;
+    c->vmem.commit_pos      = 0;
+    c->vmem.addr_space_size = class_capacity;
+    c->vmem.page_size       = ctx->vmem_ctx.page_size;
+  }
+
+  ctx->allocator.vtable = &__yoru_slab_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  return &ctx->allocator;
+}
+
+/// returns the index of the smallest class that fits `size`
+static inline usize __yoru_slab_class_index(usize size) {
+  usize index      = 0;
+  usize block_size = YORU_SLAB_MIN_BLOCK_SIZE;
+  while (block_size < size) {
+    block_size <<= 1;
+    ++index;
+  }
+  return index;
+}
+
+/// returns the class that `ptr` was carved from or NULL if it does not belong
+/// to the reservation of the slab allocator
+static inline Yoru_SlabClass *__yoru_slab_class_of(Yoru_SlabAllocatorCtx *slab, anyptr ptr) {
+  u8 *base = slab->vmem_ctx.base;
+  if ((u8 *)ptr < base || (u8 *)ptr >= base + slab->vmem_ctx.addr_space_size) return NULL;
+  return &slab->classes[(usize)((u8 *)ptr - base) / slab->class_capacity];
+}
+
+/// pops a block of the class, the block is NOT zeroed if it was reused
+static inline anyptr __yoru_slab_class_pop(Yoru_SlabClass *c, bool *out_reused) {
+  Yoru_SlabFreeBlock *block = c->free_list;
+  if (block) {
+    c->free_list = block->next;
+    *out_reused  = true;
+    return block;
+  }
+
+  if (c->bump + c->block_size > c->vmem.commit_pos) {
+    usize remaining = c->vmem.addr_space_size - c->vmem.commit_pos;
+    if (remaining < c->block_size) return NULL;
+    usize commit_size = remaining < YORU_SLAB_COMMIT_SIZE ? remaining : YORU_SLAB_COMMIT_SIZE;
+    if (!yoru_vmem_commit(&c->vmem, commit_size)) return NULL;
+  }
+
+  anyptr ptr = (u8 *)c->vmem.base + c->bump;
+  c->bump += c->block_size;
+
+  *out_reused = false;
+  return ptr;
+}
+
+static inline void __yoru_slab_class_push(Yoru_SlabClass *c, anyptr ptr) {
+  Yoru_SlabFreeBlock *block = ptr;
+  block->next               = c->free_list;
+  c->free_list              = block;
+}
+
+static inline Yoru_Opt __yoru_slab_alloc(Yoru_SlabAllocatorCtx *slab, usize size, bool zeroed) {
+  if (size > YORU_SLAB_MAX_BLOCK_SIZE) {
+    return zeroed ? __yoru_global_allocator_alloc(NULL, size) : __yoru_global_allocator_alloc_uninit(NULL, size);
+  }
+
+  Yoru_SlabClass *c      = &slab->classes[__yoru_slab_class_index(size)];
+  bool            reused = false;
+  anyptr          ptr    = __yoru_slab_class_pop(c, &reused);
+  if (!ptr) return yoru_opt_none();
+
+  /* freshly committed pages are already zeroed by the OS */
+  if (zeroed && reused) memset(ptr, 0, c->block_size);
+  return yoru_opt_some(ptr);
+}
+
+Yoru_Opt __yoru_slab_allocator_alloc(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_slab_alloc(ctx, size, true);
+}
+
+Yoru_Opt __yoru_slab_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_slab_alloc(ctx, size, false);
+}
+
+Yoru_Opt __yoru_slab_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  /* blocks that do not fit a size class come from the global allocator,
+     which only aligns them if asked to */
+  if (size > YORU_SLAB_MAX_BLOCK_SIZE || alignment > YORU_SLAB_MAX_BLOCK_SIZE) {
+    return __yoru_global_allocator_alloc_aligned(NULL, size, alignment);
+  }
+  return __yoru_slab_allocator_alloc(ctx, size < alignment ? alignment : size);
+}
+
+void __yoru_slab_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  if (!ctx || !ptr) return;
+  Yoru_SlabClass *c = __yoru_slab_class_of(ctx, ptr);
+  if (!c) {
+    __yoru_global_allocator_dealloc(NULL, ptr);
+    return;
+  }
+  __yoru_slab_class_push(c, ptr);
+}
+
+Yoru_Opt __yoru_slab_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_slab_allocator_alloc(ctx, new_size);
+
+  /* the block is still big enough, nothing to do */
+  Yoru_SlabClass *c = __yoru_slab_class_of(ctx, old_ptr);
+  if (c && new_size <= c->block_size) return yoru_opt_some(old_ptr);
+
+  /* big blocks stay with the global allocator which can grow them in place */
+  if (!c && new_size > YORU_SLAB_MAX_BLOCK_SIZE) {
+    return __yoru_global_allocator_realloc(NULL, old_size, old_ptr, new_size);
+  }
+
+  Yoru_Opt maybe_new_ptr = __yoru_slab_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  __yoru_slab_allocator_dealloc(ctx, old_ptr);
+  return maybe_new_ptr;
+}
+
+void __yoru_slab_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  Yoru_SlabAllocatorCtx *c = ctx;
+  yoru_vmem_free(&c->vmem_ctx);
+  free(c);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: BuddyAllocator
+   provides an allocator for medium to large blocks (4 KiB up
+   to 64 MiB) that can be freed and reused, e.g. as the backing
+   of big arraylist buffers.
+
+   Blocks are powers of two. Allocating splits a bigger free
+   block into halves until it fits, freeing merges a block with
+   its buddy (the other half of the block it was split from) as
+   long as the buddy is free as well. Both are O(log n).
+
+   The heap lives in a reserved address range and pages are
+   only committed once a block that covers them is handed out.
+   All bookkeeping lives in side tables outside of the heap, so
+   free blocks are never touched. Reallocating grows a block
+   into its free buddies without copying whenever possible.
+
+   Requests bigger than `YORU_BUDDY_MAX_BLOCK_SIZE` are
+   forwarded to the global allocator. Not thread-safe.
+   ============================================================ */
+
+#  define YORU_BUDDY_MIN_BLOCK_SIZE (YORU_KiB(4)) // raised to the page size if that is bigger
+#  define YORU_BUDDY_MAX_BLOCK_SIZE (YORU_MiB(64))
+
+typedef Yoru_Allocator Yoru_BuddyAllocator;
+
+/// @brief Creates a buddy allocator that reserves `capacity` bytes of address
+/// space, rounded up to a multiple of `YORU_BUDDY_MAX_BLOCK_SIZE`. Nothing is
+/// committed until the first allocation.
+Yoru_BuddyAllocator *yoru_buddy_allocator_make(usize capacity);
+
+#  ifdef YORU_IMPL
+Yoru_Opt __yoru_buddy_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_buddy_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_buddy_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_buddy_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_buddy_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_buddy_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_buddy_allocator_vtable = {
+    .alloc         = __yoru_buddy_allocator_alloc,
+    .alloc_uninit  = __yoru_buddy_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_buddy_allocator_alloc_aligned,
+    .dealloc       = __yoru_buddy_allocator_dealloc,
+    .realloc       = __yoru_buddy_allocator_realloc,
+    .destroy       = __yoru_buddy_allocator_destroy,
+};
+
+/* the heap is split into granules of the smallest block size. Every table is
+   indexed by granule */
+enum {
+  __YORU_BUDDY_MAX_ORDERS = 32,
+  __YORU_BUDDY_FREE       = 0x80, // `heads`: the block is on a free list
+  __YORU_BUDDY_NOT_A_HEAD = 0xFF, // `heads`: the granule is not the start of a block
+  __YORU_BUDDY_COMMITTED  = 1,    // `pages`: the granule is committed
+  __YORU_BUDDY_DIRTY      = 2,    // `pages`: the granule was handed out before
+};
+
+#  define __YORU_BUDDY_NO_BLOCK (U32_MAX)
+
+typedef struct Yoru_BuddyAllocatorCtx {
+  Yoru_Vmem_Ctx vmem_ctx;
+  u8           *heap;      // aligned to YORU_BUDDY_MAX_BLOCK_SIZE, so every block is aligned to its size
+  usize         min_shift; // log2 of the smallest block size
+  usize         order_count;
+  usize         granule_count;
+  u8           *heads; // order of the block starting at the granule, | FREE if it is free
+  u8           *pages;
+  u32          *next; // doubly linked free lists
+  u32          *prev;
+  u32           free_lists[__YORU_BUDDY_MAX_ORDERS];
+
+  Yoru_BuddyAllocator allocator;
+} Yoru_BuddyAllocatorCtx;
+
+static inline void __yoru_buddy_push(Yoru_BuddyAllocatorCtx *b, usize g, usize order) {
+  u32 head    = b->free_lists[order];
+  b->heads[g] = (u8)(__YORU_BUDDY_FREE | order);
+  b->prev[g]  = __YORU_BUDDY_NO_BLOCK;
+  b->next[g]  = head;
+  if (head != __YORU_BUDDY_NO_BLOCK) b->prev[head] = (u32)g;
+  b->free_lists[order] = (u32)g;
+}
+
+static inline void __yoru_buddy_remove(Yoru_BuddyAllocatorCtx *b, usize g, usize order) {
+  if (b->prev[g] != __YORU_BUDDY_NO_BLOCK) {
+    b->next[b->prev[g]] = b->next[g];
+  } else {
+    b->free_lists[order] = b->next[g];
+  }
+  if (b->next[g] != __YORU_BUDDY_NO_BLOCK) b->prev[b->next[g]] = b->prev[g];
+  b->heads[g] = __YORU_BUDDY_NOT_A_HEAD;
+}
+
+static inline bool __yoru_buddy_is_free(Yoru_BuddyAllocatorCtx *b, usize g, usize order) {
+  return b->heads[g] == (__YORU_BUDDY_FREE | order);
+}
+
+/// returns the order of the smallest block that fits `size`
+static inline usize __yoru_buddy_order_of(Yoru_BuddyAllocatorCtx *b, usize size) {
+  usize order = 0;
+  while (order + 1 < b->order_count && ((usize)1 << (b->min_shift + order)) < size)
+    ++order;
+  return order;
+}
+
+static inline usize __yoru_buddy_granules_of(Yoru_BuddyAllocatorCtx *b, usize size) {
+  return ((size ? size : 1) + ((usize)1 << b->min_shift) - 1) >> b->min_shift;
+}
+
+/// returns true and the granule of `ptr` if it belongs to the heap
+static inline bool __yoru_buddy_granule_of(Yoru_BuddyAllocatorCtx *b, anyptr ptr, usize *out_granule) {
+  if ((u8 *)ptr < b->heap || (u8 *)ptr >= b->heap + (b->granule_count << b->min_shift)) return false;
+  *out_granule = (usize)((u8 *)ptr - b->heap) >> b->min_shift;
+  return true;
+}
+
+/// commits the granules of [g, g + count) that were never committed before and,
+/// if `zeroed`, clears the ones that were handed out before
+static bool __yoru_buddy_prepare(Yoru_BuddyAllocatorCtx *b, usize g, usize count, bool zeroed) {
+  usize granule_size = (usize)1 << b->min_shift;
+  usize heap_offset  = (usize)(b->heap - (u8 *)b->vmem_ctx.base);
+  usize end          = g + count;
+
+  for (usize i = g; i < end;) {
+    if (b->pages[i] & __YORU_BUDDY_COMMITTED) {
+      if (zeroed && (b->pages[i] & __YORU_BUDDY_DIRTY)) memset(b->heap + (i << b->min_shift), 0, granule_size);
+      b->pages[i++] |= __YORU_BUDDY_DIRTY;
+      continue;
+    }
+
+    /* commit the whole run of uncommitted granules at once, fresh pages are
+       zeroed by the OS */
+    usize run_end = i;
+    while (run_end < end && !(b->pages[run_end] & __YORU_BUDDY_COMMITTED))
+      ++run_end;
+    if (!yoru_vmem_commit_at(&b->vmem_ctx, heap_offset + (i << b->min_shift), (run_end - i) << b->min_shift)) {
+      return false;
+    }
+    for (; i < run_end; ++i)
+      b->pages[i] = __YORU_BUDDY_COMMITTED | __YORU_BUDDY_DIRTY;
+  }
+  return true;
+}
+
+static void __yoru_buddy_free_block(Yoru_BuddyAllocatorCtx *b, usize g) {
+  usize order = b->heads[g];
+  assert(!(order & __YORU_BUDDY_FREE) && order < b->order_count && "not an allocated block");
+
+  /* merge with the buddy as long as it is free and was not split any further */
+  while (order + 1 < b->order_count) {
+    usize buddy = g ^ ((usize)1 << order);
+    if (!__yoru_buddy_is_free(b, buddy, order)) break;
+    __yoru_buddy_remove(b, buddy, order);
+    b->heads[g] = __YORU_BUDDY_NOT_A_HEAD;
+    g           = g < buddy ? g : buddy;
+    ++order;
+  }
+  __yoru_buddy_push(b, g, order);
+}
+
+Yoru_BuddyAllocator *yoru_buddy_allocator_make(usize capacity) {
+  Yoru_BuddyAllocatorCtx *ctx = calloc(1, sizeof(Yoru_BuddyAllocatorCtx));
+  if (!ctx) return NULL;
+
+  /* reserve one more max block so the heap can be aligned to it */
+  capacity = yoru_align_up(capacity ? capacity : 1, YORU_BUDDY_MAX_BLOCK_SIZE);
+  if (!yoru_vmem_reserve(capacity + YORU_BUDDY_MAX_BLOCK_SIZE, &ctx->vmem_ctx)) goto err;
+  ctx->heap = (u8 *)yoru_align_up((usize)ctx->vmem_ctx.base, YORU_BUDDY_MAX_BLOCK_SIZE);
+
+  usize min_block_size = ctx->vmem_ctx.page_size > YORU_BUDDY_MIN_BLOCK_SIZE ? ctx->vmem_ctx.page_size
+                                                                              : YORU_BUDDY_MIN_BLOCK_SIZE;
+  usize max_shift      = 0;
+  while (((usize)1 << ctx->min_shift) < min_block_size)
+    ++ctx->min_shift;
+  while (((usize)1 << max_shift) < YORU_BUDDY_MAX_BLOCK_SIZE)
+    ++max_shift;
+  ctx->order_count   = max_shift - ctx->min_shift + 1;
+  ctx->granule_count = capacity >> ctx->min_shift;
+  if (ctx->granule_count >= __YORU_BUDDY_NO_BLOCK) goto err;
+
+  ctx->heads = malloc(ctx->granule_count);
+  ctx->pages = calloc(ctx->granule_count, sizeof(u8));
+  ctx->next  = malloc(ctx->granule_count * sizeof(u32));
+  ctx->prev  = malloc(ctx->granule_count * sizeof(u32));
+  if (!ctx->heads || !ctx->pages || !ctx->next || !ctx->prev) goto err;
+  memset(ctx->heads, __YORU_BUDDY_NOT_A_HEAD, ctx->granule_count);
+
+  /* the heap starts out as a row of max blocks, pushed backwards so the lowest
+     one is used first */
+  usize max_order = ctx->order_count - 1;
+  for (usize i = 0; i < __YORU_BUDDY_MAX_ORDERS; ++i)
+    ctx->free_lists[i] = __YORU_BUDDY_NO_BLOCK;
+  for (usize g = ctx->granule_count; g > 0;) {
+    g -= (usize)1 << max_order;
+    __yoru_buddy_push(ctx, g, max_order);
+  }
+
+  ctx->allocator.vtable = &__yoru_buddy_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  return &ctx->allocator;
+
+err:
+  if (ctx->vmem_ctx.base) yoru_vmem_free(&ctx->vmem_ctx);
+  free(ctx->heads);
+  free(ctx->pages);
+  free(ctx->next);
+  free(ctx->prev);
+  free(ctx);
+  return NULL;
+}
+
+static inline Yoru_Opt __yoru_buddy_alloc(Yoru_BuddyAllocatorCtx *b, usize size, bool zeroed) {
+  if (size > YORU_BUDDY_MAX_BLOCK_SIZE) {
+    return zeroed ? __yoru_global_allocator_alloc(NULL, size) : __yoru_global_allocator_alloc_uninit(NULL, size);
+  }
+
+  usize order = __yoru_buddy_order_of(b, size);
+  usize found = order;
+  while (found < b->order_count && b->free_lists[found] == __YORU_BUDDY_NO_BLOCK)
+    ++found;
+  if (found == b->order_count) return yoru_opt_none();
+
+  /* split the block until it has the right size, the upper halves go back to
+     the free lists */
+  usize g = b->free_lists[found];
+  __yoru_buddy_remove(b, g, found);
+  while (found > order) {
+    --found;
+    __yoru_buddy_push(b, g + ((usize)1 << found), found);
+  }
+  b->heads[g] = (u8)order;
+
+  if (!__yoru_buddy_prepare(b, g, __yoru_buddy_granules_of(b, size), zeroed)) {
+    __yoru_buddy_free_block(b, g);
+    return yoru_opt_none();
+  }
+  return yoru_opt_some(b->heap + (g << b->min_shift));
+}
+
+Yoru_Opt __yoru_buddy_allocator_alloc(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_buddy_alloc(ctx, size, true);
+}
+
+Yoru_Opt __yoru_buddy_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_buddy_alloc(ctx, size, false);
+}
+
+Yoru_Opt __yoru_buddy_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  /* blocks are aligned to their size. Bigger blocks come from the global
+     allocator, which only aligns them if asked to */
+  if (size > YORU_BUDDY_MAX_BLOCK_SIZE || alignment > YORU_BUDDY_MAX_BLOCK_SIZE) {
+    return __yoru_global_allocator_alloc_aligned(NULL, size, alignment);
+  }
+  return __yoru_buddy_alloc(ctx, size < alignment ? alignment : size, true);
+}
+
+void __yoru_buddy_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  if (!ctx || !ptr) return;
+  usize g = 0;
+  if (!__yoru_buddy_granule_of(ctx, ptr, &g)) {
+    __yoru_global_allocator_dealloc(NULL, ptr);
+    return;
+  }
+  __yoru_buddy_free_block(ctx, g);
+}
+
+/// returns true if the block at `g` can grow to `new_order` by merging with
+/// the free buddies above it
+static inline bool __yoru_buddy_can_grow(Yoru_BuddyAllocatorCtx *b, usize g, usize order, usize new_order) {
+  for (usize o = order; o < new_order; ++o) {
+    if (g & ((usize)1 << o)) return false; // upper half, the buddy lies below the block
+    if (!__yoru_buddy_is_free(b, g + ((usize)1 << o), o)) return false;
+  }
+  return true;
+}
+
+Yoru_Opt __yoru_buddy_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_buddy_allocator_alloc(ctx, new_size);
+
+  Yoru_BuddyAllocatorCtx *b = ctx;
+  usize                   g = 0;
+  if (!__yoru_buddy_granule_of(b, old_ptr, &g)) {
+    if (new_size > YORU_BUDDY_MAX_BLOCK_SIZE) return __yoru_global_allocator_realloc(NULL, old_size, old_ptr, new_size);
+  } else if (new_size <= YORU_BUDDY_MAX_BLOCK_SIZE) {
+    usize order     = b->heads[g];
+    usize new_order = __yoru_buddy_order_of(b, new_size);
+
+    /* grow into the free buddies without copying anything */
+    if (new_order > order && __yoru_buddy_can_grow(b, g, order, new_order)) {
+      for (; order < new_order; ++order)
+        __yoru_buddy_remove(b, g + ((usize)1 << order), order);
+      b->heads[g] = (u8)order;
+    }
+
+    /* shrinking gives the upper halves back */
+    while (order > new_order) {
+      --order;
+      __yoru_buddy_push(b, g + ((usize)1 << order), order);
+      b->heads[g] = (u8)order;
+    }
+
+    if (order == new_order) {
+      if (!__yoru_buddy_prepare(b, g, __yoru_buddy_granules_of(b, new_size), false)) return yoru_opt_none();
+      return yoru_opt_some(old_ptr);
+    }
+  }
+
+  Yoru_Opt maybe_new_ptr = __yoru_buddy_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  __yoru_buddy_allocator_dealloc(ctx, old_ptr);
+  return maybe_new_ptr;
+}
+
+void __yoru_buddy_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  Yoru_BuddyAllocatorCtx *c = ctx;
+  yoru_vmem_free(&c->vmem_ctx);
+  free(c->heads);
+  free(c->pages);
+  free(c->next);
+  free(c->prev);
+  free(c);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: TlsfAllocator
+   provides a Two-Level Segregated Fit allocator with O(1)
+   worst-case alloc, free and realloc for latency sensitive
+   code paths.
+
+   Free blocks are kept in size classes that are indexed by two
+   bitmaps (power of two ranges, each split into
+   `YORU_TLSF_SL_COUNT` linear steps), so finding a block that
+   fits is a couple of bit scans. Freed blocks are merged with
+   their free neighbours right away.
+
+   The allocator either manages a caller-provided region or a
+   reservation made with `yoru_vmem_reserve`. The latter is
+   committed in steps when the allocator runs out of memory,
+   which is a syscall. Commit the whole reservation up front
+   for strictly bounded latency. Only the first 128 GiB of a
+   region or reservation are used, the size of the biggest
+   block the size classes can hold.
+
+   Zeroed allocations still clear the returned memory, use
+   `yoru_allocator_alloc_uninit` if that is not needed.
+   Not thread-safe.
+   ============================================================ */
+
+#  define YORU_TLSF_SL_COUNT_LOG2 (5)
+#  define YORU_TLSF_SL_COUNT (1 << YORU_TLSF_SL_COUNT_LOG2)
+#  define YORU_TLSF_COMMIT_SIZE (YORU_MiB(1))
+
+typedef Yoru_Allocator Yoru_TlsfAllocator;
+
+/// @brief Creates a TLSF allocator that hands out memory from `memory`. The
+/// region must stay valid until the allocator is destroyed and is not freed by
+/// it
+Yoru_TlsfAllocator *yoru_tlsf_allocator_make(anyptr memory, usize size);
+
+/// @brief Creates a TLSF allocator on top of a reservation. Already committed
+/// memory is used first, more is committed when needed. The reservation is not
+/// freed when the allocator is destroyed
+Yoru_TlsfAllocator *yoru_tlsf_allocator_make_from_vmem(Yoru_Vmem_Ctx *vmem_ctx);
+
+#  ifdef YORU_IMPL
+Yoru_Opt __yoru_tlsf_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_tlsf_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_tlsf_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_tlsf_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_tlsf_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_tlsf_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_tlsf_allocator_vtable = {
+    .alloc         = __yoru_tlsf_allocator_alloc,
+    .alloc_uninit  = __yoru_tlsf_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_tlsf_allocator_alloc_aligned,
+    .dealloc       = __yoru_tlsf_allocator_dealloc,
+    .realloc       = __yoru_tlsf_allocator_realloc,
+    .destroy       = __yoru_tlsf_allocator_destroy,
+};
+
+/* sizes below YORU_TLSF_SMALL_SIZE all go into the first level, linearly
+   split into second level steps of YORU_DEFAULT_ALIGNMENT bytes */
+enum {
+  __YORU_TLSF_ALIGN_LOG2     = 4, // log2 of YORU_DEFAULT_ALIGNMENT
+  __YORU_TLSF_FL_SHIFT       = YORU_TLSF_SL_COUNT_LOG2 + __YORU_TLSF_ALIGN_LOG2,
+  __YORU_TLSF_FL_MAX         = 38, // blocks up to 128 GiB
+  __YORU_TLSF_FL_COUNT       = __YORU_TLSF_FL_MAX - __YORU_TLSF_FL_SHIFT + 1,
+  __YORU_TLSF_SMALL_SIZE     = 1 << __YORU_TLSF_FL_SHIFT,
+  __YORU_TLSF_FREE_BIT       = 1,
+  __YORU_TLSF_PREV_FREE_BIT  = 2,
+  __YORU_TLSF_FLAG_BITS      = __YORU_TLSF_FREE_BIT | __YORU_TLSF_PREV_FREE_BIT,
+};
+
+/* every block starts with a header, the payload starts at `next_free`. The
+   free list links are only valid while the block is free and `prev_phys` is
+   only valid while the previous block is free */
+typedef struct Yoru_TlsfBlock {
+  struct Yoru_TlsfBlock *prev_phys;
+  usize                  size; // size of the payload | flags
+  struct Yoru_TlsfBlock *next_free;
+  struct Yoru_TlsfBlock *prev_free;
+} Yoru_TlsfBlock;
+
+#    define __YORU_TLSF_HEADER_SIZE (offsetof(Yoru_TlsfBlock, next_free))
+#    define __YORU_TLSF_MIN_PAYLOAD (sizeof(Yoru_TlsfBlock) - __YORU_TLSF_HEADER_SIZE)
+#    define __YORU_TLSF_MAX_PAYLOAD ((usize)1 << (__YORU_TLSF_FL_MAX - 1))
+
+static_assert(__YORU_TLSF_HEADER_SIZE % YORU_DEFAULT_ALIGNMENT == 0, "payloads must stay aligned");
+static_assert((1 << __YORU_TLSF_ALIGN_LOG2) == YORU_DEFAULT_ALIGNMENT, "alignment and its log2 must match");
+
+typedef struct Yoru_TlsfAllocatorCtx {
+  u32             fl_bitmap;
+  u32             sl_bitmap[__YORU_TLSF_FL_COUNT];
+  Yoru_TlsfBlock *blocks[__YORU_TLSF_FL_COUNT][YORU_TLSF_SL_COUNT];
+  Yoru_Vmem_Ctx  *vmem_ctx; // NULL for caller-provided memory
+  Yoru_TlsfBlock *sentinel; // zero sized used block at the end of the pool
+
+  Yoru_TlsfAllocator allocator;
+} Yoru_TlsfAllocatorCtx;
+
+/// index of the highest set bit, `x` must not be 0
+static inline usize __yoru_tlsf_fls(usize x) {
+#    if defined(__GNUC__) || defined(__clang__)
+  return (usize)(63 - __builtin_clzll((unsigned long long)x));
+#    else
+  usize bit = 0;
+  while (x >>= 1)
+    ++bit;
+  return bit;
+#    endif
+}
+
+/// index of the lowest set bit, `x` must not be 0
+static inline usize __yoru_tlsf_ffs(u32 x) {
+#    if defined(__GNUC__) || defined(__clang__)
+  return (usize)__builtin_ctz(x);
+#    else
+  usize bit = 0;
+  while (!(x & 1)) {
+    x >>= 1;
+    ++bit;
+  }
+  return bit;
+#    endif
+}
+
+static inline usize __yoru_tlsf_size(Yoru_TlsfBlock *b) {
+  return b->size & ~(usize)__YORU_TLSF_FLAG_BITS;
+}
+
+static inline u8 *__yoru_tlsf_payload(Yoru_TlsfBlock *b) {
+  return (u8 *)b + __YORU_TLSF_HEADER_SIZE;
+}
+
+static inline Yoru_TlsfBlock *__yoru_tlsf_block_of(anyptr payload) {
+  return (Yoru_TlsfBlock *)((u8 *)payload - __YORU_TLSF_HEADER_SIZE);
+}
+
+static inline Yoru_TlsfBlock *__yoru_tlsf_next_phys(Yoru_TlsfBlock *b) {
+  return (Yoru_TlsfBlock *)(__yoru_tlsf_payload(b) + __yoru_tlsf_size(b));
+}
+
+static inline void __yoru_tlsf_mapping_insert(usize size, usize *fl, usize *sl) {
+  if (size < __YORU_TLSF_SMALL_SIZE) {
+    *fl = 0;
+    *sl = size >> __YORU_TLSF_ALIGN_LOG2;
+    return;
+  }
+  usize bit = __yoru_tlsf_fls(size);
+  *sl       = (size >> (bit - YORU_TLSF_SL_COUNT_LOG2)) ^ ((usize)1 << YORU_TLSF_SL_COUNT_LOG2);
+  *fl       = bit - (__YORU_TLSF_FL_SHIFT - 1);
+}
+
+/// like the insert mapping, but rounds up to the next class so that every block
+/// in the class is big enough
+static inline void __yoru_tlsf_mapping_search(usize size, usize *fl, usize *sl) {
+  if (size >= __YORU_TLSF_SMALL_SIZE) size += ((usize)1 << (__yoru_tlsf_fls(size) - YORU_TLSF_SL_COUNT_LOG2)) - 1;
+  __yoru_tlsf_mapping_insert(size, fl, sl);
+}
+
+static inline void __yoru_tlsf_remove(Yoru_TlsfAllocatorCtx *t, Yoru_TlsfBlock *b) {
+  usize fl = 0;
+  usize sl = 0;
+  __yoru_tlsf_mapping_insert(__yoru_tlsf_size(b), &fl, &sl);
+
+  if (b->prev_free) b->prev_free->next_free = b->next_free;
+  if (b->next_free) b->next_free->prev_free = b->prev_free;
+  if (t->blocks[fl][sl] == b) {
+    t->blocks[fl][sl] = b->next_free;
+    if (!b->next_free) {
+      t->sl_bitmap[fl] &= ~((u32)1 << sl);
+      if (!t->sl_bitmap[fl]) t->fl_bitmap &= ~((u32)1 << fl);
+    }
+  }
+}
+
+static inline void __yoru_tlsf_insert(Yoru_TlsfAllocatorCtx *t, Yoru_TlsfBlock *b) {
+  usize fl = 0;
+  usize sl = 0;
+  __yoru_tlsf_mapping_insert(__yoru_tlsf_size(b), &fl, &sl);
+
+  b->prev_free = NULL;
+  b->next_free = t->blocks[fl][sl];
+  if (b->next_free) b->next_free->prev_free = b;
+  t->blocks[fl][sl] = b;
+  t->sl_bitmap[fl] |= (u32)1 << sl;
+  t->fl_bitmap |= (u32)1 << fl;
+}
+
+/// returns a free block of at least `size` bytes and removes it from its list
+static inline Yoru_TlsfBlock *__yoru_tlsf_find(Yoru_TlsfAllocatorCtx *t, usize size) {
+  usize fl = 0;
+  usize sl = 0;
+  __yoru_tlsf_mapping_search(size, &fl, &sl);
+  if (fl >= __YORU_TLSF_FL_COUNT) return NULL;
+
+  u32 sl_map = t->sl_bitmap[fl] & (~(u32)0 << sl);
+  if (!sl_map) {
+    u32 fl_map = fl + 1 < 32 ? t->fl_bitmap & (~(u32)0 << (fl + 1)) : 0;
+    if (!fl_map) return NULL;
+    fl     = __yoru_tlsf_ffs(fl_map);
+    sl_map = t->sl_bitmap[fl];
+  }
+  sl = __yoru_tlsf_ffs(sl_map);
+
+  Yoru_TlsfBlock *b = t->blocks[fl][sl];
+  __yoru_tlsf_remove(t, b);
+  return b;
+}
+
+static inline void __yoru_tlsf_mark_free(Yoru_TlsfBlock *b) {
+  Yoru_TlsfBlock *next = __yoru_tlsf_next_phys(b);
+  b->size |= __YORU_TLSF_FREE_BIT;
+  next->prev_phys = b;
+  next->size |= __YORU_TLSF_PREV_FREE_BIT;
+}
+
+static inline void __yoru_tlsf_mark_used(Yoru_TlsfBlock *b) {
+  b->size &= ~(usize)__YORU_TLSF_FREE_BIT;
+  __yoru_tlsf_next_phys(b)->size &= ~(usize)__YORU_TLSF_PREV_FREE_BIT;
+}
+
+/// merges a block that is not on a free list with its free neighbours and puts
+/// the result on its free list
+static void __yoru_tlsf_release(Yoru_TlsfAllocatorCtx *t, Yoru_TlsfBlock *b) {
+  if (b->size & __YORU_TLSF_PREV_FREE_BIT) {
+    Yoru_TlsfBlock *prev = b->prev_phys;
+    __yoru_tlsf_remove(t, prev);
+    prev->size += __YORU_TLSF_HEADER_SIZE + __yoru_tlsf_size(b);
+    b = prev;
+  }
+
+  Yoru_TlsfBlock *next = __yoru_tlsf_next_phys(b);
+  if (next->size & __YORU_TLSF_FREE_BIT) {
+    __yoru_tlsf_remove(t, next);
+    b->size += __YORU_TLSF_HEADER_SIZE + __yoru_tlsf_size(next);
+  }
+
+  __yoru_tlsf_mark_free(b);
+  __yoru_tlsf_insert(t, b);
+}
+
+/// cuts a used block down to `size` bytes and releases the rest if it is big
+/// enough to be a block of its own
+static inline void __yoru_tlsf_trim(Yoru_TlsfAllocatorCtx *t, Yoru_TlsfBlock *b, usize size) {
+  usize block_size = __yoru_tlsf_size(b);
+  if (block_size < size + sizeof(Yoru_TlsfBlock)) return;
+
+  Yoru_TlsfBlock *rest = (Yoru_TlsfBlock *)(__yoru_tlsf_payload(b) + size);
+  rest->size           = block_size - size - __YORU_TLSF_HEADER_SIZE; // b is used, so PREV_FREE stays cleared
+  b->size              = size | (b->size & __YORU_TLSF_FLAG_BITS);
+  __yoru_tlsf_release(t, rest);
+}
+
+static inline usize __yoru_tlsf_adjust(usize size) {
+  if (size < __YORU_TLSF_MIN_PAYLOAD) return __YORU_TLSF_MIN_PAYLOAD;
+  return yoru_align_up(size, YORU_DEFAULT_ALIGNMENT);
+}
+
+/// sets up [start, end) as the pool: one free block followed by the sentinel
+static bool __yoru_tlsf_init_pool(Yoru_TlsfAllocatorCtx *t, u8 *start, u8 *end) {
+  start = (u8 *)yoru_align_up((usize)start, YORU_DEFAULT_ALIGNMENT);
+  end   = (u8 *)((usize)end & ~(usize)(YORU_DEFAULT_ALIGNMENT - 1));
+  if (end <= start || (usize)(end - start) < sizeof(Yoru_TlsfBlock) + __YORU_TLSF_HEADER_SIZE) return false;
+
+  usize payload = (usize)(end - start) - 2 * __YORU_TLSF_HEADER_SIZE;
+  if (payload > __YORU_TLSF_MAX_PAYLOAD) payload = __YORU_TLSF_MAX_PAYLOAD;
+
+  Yoru_TlsfBlock *b = (Yoru_TlsfBlock *)start;
+  b->prev_phys      = NULL;
+  b->size           = payload;
+  t->sentinel       = __yoru_tlsf_next_phys(b);
+  t->sentinel->size = 0;
+  __yoru_tlsf_mark_free(b);
+  __yoru_tlsf_insert(t, b);
+  return true;
+}
+
+/// commits more of the reservation so that a block of `size` bytes fits and
+/// turns the old sentinel into a free block
+static bool __yoru_tlsf_grow(Yoru_TlsfAllocatorCtx *t, usize size) {
+  Yoru_Vmem_Ctx *vm = t->vmem_ctx;
+  if (!vm) return false;
+
+  /* the pool stops growing at the biggest block, otherwise merging its free
+     blocks could make one that has no size class */
+  usize limit = vm->addr_space_size;
+  if (limit > __YORU_TLSF_MAX_PAYLOAD) limit = __YORU_TLSF_MAX_PAYLOAD;
+  if (vm->commit_pos >= limit) return false;
+
+  /* twice the size, so the merged block also fits the rounded up size class */
+  usize step      = yoru_align_up(2 * size + 2 * __YORU_TLSF_HEADER_SIZE, yoru_get_page_size());
+  usize remaining = limit - vm->commit_pos;
+  if (step < YORU_TLSF_COMMIT_SIZE) step = YORU_TLSF_COMMIT_SIZE;
+  if (step > remaining) step = remaining;
+  if (step == 0) return false;
+
+  u8 *old_end = (u8 *)vm->base + vm->commit_pos;
+  if (!yoru_vmem_commit(vm, step)) return false;
+  u8 *new_end = (u8 *)vm->base + vm->commit_pos;
+  if (!t->sentinel) return __yoru_tlsf_init_pool(t, old_end, new_end);
+
+  Yoru_TlsfBlock *b       = t->sentinel;
+  usize           payload = (usize)(new_end - __yoru_tlsf_payload(b)) - __YORU_TLSF_HEADER_SIZE;
+  b->size                 = payload | (b->size & __YORU_TLSF_FLAG_BITS);
+  t->sentinel             = __yoru_tlsf_next_phys(b);
+  t->sentinel->size       = 0;
+  __yoru_tlsf_release(t, b);
+  return true;
+}
+
+static Yoru_TlsfAllocatorCtx *__yoru_tlsf_ctx_make() {
+  Yoru_TlsfAllocatorCtx *ctx = calloc(1, sizeof(Yoru_TlsfAllocatorCtx));
+  if (!ctx) return NULL;
+  ctx->allocator.vtable = &__yoru_tlsf_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  return ctx;
+}
+
+Yoru_TlsfAllocator *yoru_tlsf_allocator_make(anyptr memory, usize size) {
+  assert(memory && "must not be null");
+  Yoru_TlsfAllocatorCtx *ctx = __yoru_tlsf_ctx_make();
+  if (!ctx) return NULL;
+  if (!__yoru_tlsf_init_pool(ctx, memory, (u8 *)memory + size)) {
+    free(ctx);
+    return NULL;
+  }
+  return &ctx->allocator;
+}
+
+Yoru_TlsfAllocator *yoru_tlsf_allocator_make_from_vmem(Yoru_Vmem_Ctx *vmem_ctx) {
+  assert(vmem_ctx && "must not be null");
+  assert(vmem_ctx->base && "must be reserved");
+  Yoru_TlsfAllocatorCtx *ctx = __yoru_tlsf_ctx_make();
+  if (!ctx) return NULL;
+
+  ctx->vmem_ctx = vmem_ctx;
+  u8 *base      = vmem_ctx->base;
+  if (!__yoru_tlsf_init_pool(ctx, base, base + vmem_ctx->commit_pos) && !__yoru_tlsf_grow(ctx, 0)) {
+    free(ctx);
+    return NULL;
+  }
+  return &ctx->allocator;
+}
+
+static inline Yoru_TlsfBlock *__yoru_tlsf_find_or_grow(Yoru_TlsfAllocatorCtx *t, usize size) {
+  Yoru_TlsfBlock *b = __yoru_tlsf_find(t, size);
+  if (!b && __yoru_tlsf_grow(t, size)) b = __yoru_tlsf_find(t, size);
+  return b;
+}
+
+static inline Yoru_Opt __yoru_tlsf_alloc(Yoru_TlsfAllocatorCtx *t, usize size, bool zeroed) {
+  usize adjusted = __yoru_tlsf_adjust(size);
+  if (adjusted > __YORU_TLSF_MAX_PAYLOAD) return yoru_opt_none();
+
+  Yoru_TlsfBlock *b = __yoru_tlsf_find_or_grow(t, adjusted);
+  if (!b) return yoru_opt_none();
+  __yoru_tlsf_mark_used(b);
+  __yoru_tlsf_trim(t, b, adjusted);
+
+  if (zeroed) memset(__yoru_tlsf_payload(b), 0, size);
+  return yoru_opt_some(__yoru_tlsf_payload(b));
+}
+
+Yoru_Opt __yoru_tlsf_allocator_alloc(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_tlsf_alloc(ctx, size, true);
+}
+
+Yoru_Opt __yoru_tlsf_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_tlsf_alloc(ctx, size, false);
+}
+
+Yoru_Opt __yoru_tlsf_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  if (alignment <= YORU_DEFAULT_ALIGNMENT) return __yoru_tlsf_alloc(ctx, size, true);
+
+  /* take a block with enough slack to cut off a free block in front of the
+     aligned payload */
+  Yoru_TlsfAllocatorCtx *t        = ctx;
+  usize                  adjusted = __yoru_tlsf_adjust(size);
+  usize                  gap_min  = sizeof(Yoru_TlsfBlock);
+  if (adjusted + alignment + gap_min > __YORU_TLSF_MAX_PAYLOAD) return yoru_opt_none();
+
+  Yoru_TlsfBlock *b = __yoru_tlsf_find_or_grow(t, adjusted + alignment + gap_min);
+  if (!b) return yoru_opt_none();
+  __yoru_tlsf_mark_used(b);
+
+  u8   *payload = __yoru_tlsf_payload(b);
+  usize gap     = yoru_align_up((usize)payload, alignment) - (usize)payload;
+  if (gap > 0 && gap < gap_min) gap = yoru_align_up((usize)payload + gap_min, alignment) - (usize)payload;
+  if (gap > 0) {
+    Yoru_TlsfBlock *aligned = (Yoru_TlsfBlock *)(payload + gap - __YORU_TLSF_HEADER_SIZE);
+    aligned->size           = __yoru_tlsf_size(b) - gap;
+    b->size                 = (gap - __YORU_TLSF_HEADER_SIZE) | (b->size & __YORU_TLSF_FLAG_BITS);
+    __yoru_tlsf_release(t, b);
+    b = aligned;
+  }
+  __yoru_tlsf_trim(t, b, adjusted);
+
+  memset(__yoru_tlsf_payload(b), 0, size);
+  return yoru_opt_some(__yoru_tlsf_payload(b));
+}
+
+void __yoru_tlsf_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  if (!ctx || !ptr) return;
+  Yoru_TlsfBlock *b = __yoru_tlsf_block_of(ptr);
+  assert(!(b->size & __YORU_TLSF_FREE_BIT) && "double free");
+  __yoru_tlsf_release(ctx, b);
+}
+
+Yoru_Opt __yoru_tlsf_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_tlsf_allocator_alloc(ctx, new_size);
+
+  Yoru_TlsfAllocatorCtx *t        = ctx;
+  Yoru_TlsfBlock        *b        = __yoru_tlsf_block_of(old_ptr);
+  usize                  adjusted = __yoru_tlsf_adjust(new_size);
+  if (adjusted > __YORU_TLSF_MAX_PAYLOAD) return yoru_opt_none();
+
+  /* grow into the next block if it is free and big enough */
+  Yoru_TlsfBlock *next = __yoru_tlsf_next_phys(b);
+  usize           size = __yoru_tlsf_size(b);
+  if (adjusted > size && (next->size & __YORU_TLSF_FREE_BIT) &&
+      size + __YORU_TLSF_HEADER_SIZE + __yoru_tlsf_size(next) >= adjusted) {
+    __yoru_tlsf_remove(t, next);
+    b->size += __YORU_TLSF_HEADER_SIZE + __yoru_tlsf_size(next);
+    __yoru_tlsf_mark_used(b);
+    size = __yoru_tlsf_size(b);
+  }
+
+  if (adjusted <= size) {
+    __yoru_tlsf_trim(t, b, adjusted);
+    return yoru_opt_some(old_ptr);
+  }
+
+  Yoru_Opt maybe_new_ptr = __yoru_tlsf_alloc(t, new_size, false);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  __yoru_tlsf_release(t, b);
+  return maybe_new_ptr;
+}
+
+void __yoru_tlsf_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  free(ctx);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: Threads
+   provides a thin platform layer for threads, mutexes,
+   condition variables and thread-local storage on
+     - linux
+     - macos
+     - windows
+   ============================================================ */
+
+#  if defined(_WIN32) && !defined(__GNUC__)
+#    define YORU_THREAD_LOCAL __declspec(thread)
+#  else
+#    define YORU_THREAD_LOCAL _Thread_local
+#  endif
+
+typedef void (*Yoru_ThreadFunc)(anyptr arg);
+
+typedef struct Yoru_Thread {
+#  if defined(_WIN32)
+  HANDLE handle;
+#  else
+  pthread_t handle;
+#  endif
+} Yoru_Thread;
+
+typedef struct Yoru_Mutex {
+#  if defined(_WIN32)
+  CRITICAL_SECTION handle;
+#  else
+  pthread_mutex_t handle;
+#  endif
+} Yoru_Mutex;
+
+typedef struct Yoru_CondVar {
+#  if defined(_WIN32)
+  CONDITION_VARIABLE handle;
+#  else
+  pthread_cond_t handle;
+#  endif
+} Yoru_CondVar;
+
+/// @brief starts a new thread running `func(arg)`. returns true on success,
+/// else false
+bool yoru_thread_spawn(Yoru_Thread *out_thread, Yoru_ThreadFunc func, anyptr arg);
+
+/// @brief waits for the thread to finish. returns true on success, else false
+bool yoru_thread_join(Yoru_Thread *thread);
+
+/// @brief returns the number of online cpus on the current system
+usize yoru_get_cpu_count();
+
+/// @brief gives up the rest of the time slice of the calling thread
+void yoru_thread_yield();
+
+/// @brief initializes a mutex. returns true on success, else false
+bool yoru_mutex_init(Yoru_Mutex *mutex);
+
+/// @brief locks the mutex, blocking until it is available
+void yoru_mutex_lock(Yoru_Mutex *mutex);
+
+/// @brief unlocks a mutex that is held by the calling thread
+void yoru_mutex_unlock(Yoru_Mutex *mutex);
+
+/// @brief destroys an unlocked mutex
+void yoru_mutex_destroy(Yoru_Mutex *mutex);
+
+/// @brief initializes a condition variable. returns true on success, else
+/// false
+bool yoru_condvar_init(Yoru_CondVar *condvar);
+
+/// @brief unlocks `mutex`, waits until the condition variable is signaled and
+/// locks `mutex` again. can wake up spuriously, so check the condition in a
+/// loop
+void yoru_condvar_wait(Yoru_CondVar *condvar, Yoru_Mutex *mutex);
+
+/// @brief wakes up one thread waiting on the condition variable
+void yoru_condvar_signal(Yoru_CondVar *condvar);
+
+/// @brief wakes up all threads waiting on the condition variable
+void yoru_condvar_broadcast(Yoru_CondVar *condvar);
+
+/// @brief destroys a condition variable no thread is waiting on
+void yoru_condvar_destroy(Yoru_CondVar *condvar);
+
+#  ifdef YORU_IMPL
+typedef struct Yoru_ThreadStart {
+  Yoru_ThreadFunc func;
+  anyptr          arg;
+} Yoru_ThreadStart;
+
+#    if defined(_WIN32)
+static DWORD WINAPI __yoru_thread_trampoline(LPVOID param) {
+  Yoru_ThreadStart start = *(Yoru_ThreadStart *)param;
+  free(param);
+  start.func(start.arg);
+  return 0;
+}
+#    else
+static anyptr __yoru_thread_trampoline(anyptr param) {
+  Yoru_ThreadStart start = *(Yoru_ThreadStart *)param;
+  free(param);
+  start.func(start.arg);
+  return NULL;
+}
+#    endif
+
+bool yoru_thread_spawn(Yoru_Thread *out_thread, Yoru_ThreadFunc func, anyptr arg) {
+  assert(out_thread && "must not be null");
+  assert(func && "must not be null");
+
+  Yoru_ThreadStart *start = malloc(sizeof(Yoru_ThreadStart));
+  if (!start) return false;
+  start->func = func;
+  start->arg  = arg;
+
+#    if defined(_WIN32)
+  out_thread->handle = CreateThread(NULL, 0, __yoru_thread_trampoline, start, 0, NULL);
+  if (!out_thread->handle) {
+    free(start);
+    return false;
+  }
+#    else
+  if (pthread_create(&out_thread->handle, NULL, __yoru_thread_trampoline, start) != 0) {
+    free(start);
+    return false;
+  }
+#    endif
+  return true;
+}
+
+bool yoru_thread_join(Yoru_Thread *thread) {
+  assert(thread && "must not be null");
+#    if defined(_WIN32)
+  if (WaitForSingleObject(thread->handle, INFINITE) != WAIT_OBJECT_0) return false;
+  return CloseHandle(thread->handle);
+#    else
+  return pthread_join(thread->handle, NULL) == 0;
+#    endif
+}
+
+usize yoru_get_cpu_count() {
+#    if defined(_WIN32)
+  SYSTEM_INFO sysinfo = {0};
+  GetSystemInfo(&sysinfo);
+  return (usize)sysinfo.dwNumberOfProcessors;
+#    else
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (usize)count : 1;
+#    endif
+}
+
+void yoru_thread_yield() {
+#    if defined(_WIN32)
+  SwitchToThread();
+#    else
+  sched_yield();
+#    endif
+}
+
+bool yoru_mutex_init(Yoru_Mutex *mutex) {
+  assert(mutex && "must not be null");
+#    if defined(_WIN32)
+  InitializeCriticalSection(&mutex->handle);
+  return true;
+#    else
+  return pthread_mutex_init(&mutex->handle, NULL) == 0;
+#    endif
+}
+
+void yoru_mutex_lock(Yoru_Mutex *mutex) {
+#    if defined(_WIN32)
+  EnterCriticalSection(&mutex->handle);
+#    else
+  pthread_mutex_lock(&mutex->handle);
+#    endif
+}
+
+void yoru_mutex_unlock(Yoru_Mutex *mutex) {
+#    if defined(_WIN32)
+  LeaveCriticalSection(&mutex->handle);
+#    else
+  pthread_mutex_unlock(&mutex->handle);
+#    endif
+}
+
+void yoru_mutex_destroy(Yoru_Mutex *mutex) {
+  assert(mutex && "must not be null");
+#    if defined(_WIN32)
+  DeleteCriticalSection(&mutex->handle);
+#    else
+  pthread_mutex_destroy(&mutex->handle);
+#    endif
+}
+
+bool yoru_condvar_init(Yoru_CondVar *condvar) {
+  assert(condvar && "must not be null");
+#    if defined(_WIN32)
+  InitializeConditionVariable(&condvar->handle);
+  return true;
+#    else
+  return pthread_cond_init(&condvar->handle, NULL) == 0;
+#    endif
+}
+
+void yoru_condvar_wait(Yoru_CondVar *condvar, Yoru_Mutex *mutex) {
+#    if defined(_WIN32)
+  SleepConditionVariableCS(&condvar->handle, &mutex->handle, INFINITE);
+#    else
+  pthread_cond_wait(&condvar->handle, &mutex->handle);
+#    endif
+}
+
+void yoru_condvar_signal(Yoru_CondVar *condvar) {
+#    if defined(_WIN32)
+  WakeConditionVariable(&condvar->handle);
+#    else
+  pthread_cond_signal(&condvar->handle);
+#    endif
+}
+
+void yoru_condvar_broadcast(Yoru_CondVar *condvar) {
+#    if defined(_WIN32)
+  WakeAllConditionVariable(&condvar->handle);
+#    else
+  pthread_cond_broadcast(&condvar->handle);
+#    endif
+}
+
+void yoru_condvar_destroy(Yoru_CondVar *condvar) {
+  assert(condvar && "must not be null");
+#    if defined(_WIN32)
+  (void)condvar;
+#    else
+  pthread_cond_destroy(&condvar->handle);
+#    endif
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: ThreadCachingAllocator
+   provides an allocator that can be shared between threads.
+
+   Every thread keeps a small magazine of free blocks per size
+   class in thread-local storage, so most allocations and frees
+   never touch shared state. Empty magazines are refilled and
+   full magazines are drained in batches of
+   `YORU_TCACHE_BATCH_SIZE` blocks from/to a central
+   `SlabAllocator` that is protected by a mutex.
+
+   Blocks may be freed by a different thread than the one that
+   allocated them. Blocks that sit in the magazine of a thread
+   that exits are only reclaimed by `yoru_allocator_destroy`, so
+   call `yoru_thread_caching_allocator_flush` before a worker
+   thread exits if the allocator outlives it.
+
+   At most `YORU_TCACHE_MAX_INSTANCES` thread-caching allocators
+   can exist at the same time.
+   ============================================================ */
+
+#  define YORU_TCACHE_MAGAZINE_SIZE (64)
+#  define YORU_TCACHE_BATCH_SIZE (YORU_TCACHE_MAGAZINE_SIZE / 2)
+#  define YORU_TCACHE_MAX_INSTANCES (32) // one bit per instance in a u32
+
+typedef Yoru_Allocator Yoru_ThreadCachingAllocator;
+
+/// @brief Creates a thread-caching allocator whose central heap reserves
+/// `class_capacity` bytes of address space for every size class (see
+/// `yoru_slab_allocator_make`)
+Yoru_ThreadCachingAllocator *yoru_thread_caching_allocator_make(usize class_capacity);
+
+/// @brief Returns all blocks cached by the calling thread to the central heap
+void yoru_thread_caching_allocator_flush(Yoru_ThreadCachingAllocator *allocator);
+
+#  ifdef YORU_IMPL
+Yoru_Opt __yoru_thread_caching_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_thread_caching_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_thread_caching_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_thread_caching_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_thread_caching_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_thread_caching_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_thread_caching_allocator_vtable = {
+    .alloc         = __yoru_thread_caching_allocator_alloc,
+    .alloc_uninit  = __yoru_thread_caching_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_thread_caching_allocator_alloc_aligned,
+    .dealloc       = __yoru_thread_caching_allocator_dealloc,
+    .realloc       = __yoru_thread_caching_allocator_realloc,
+    .destroy       = __yoru_thread_caching_allocator_destroy,
+};
+
+typedef struct Yoru_TCacheMagazine {
+  usize  count;
+  anyptr blocks[YORU_TCACHE_MAGAZINE_SIZE];
+} Yoru_TCacheMagazine;
+
+typedef struct Yoru_TCache {
+  Yoru_TCacheMagazine magazines[YORU_SLAB_CLASS_COUNT];
+  struct Yoru_TCache *next; // all caches of one allocator, freed on destroy
+} Yoru_TCache;
+
+typedef struct Yoru_ThreadCachingAllocatorCtx {
+  Yoru_SlabAllocator         *central;
+  Yoru_Mutex                  mutex; // guards `central` and `caches`
+  Yoru_TCache                *caches;
+  usize                       slot;
+  u64                         generation;
+  Yoru_ThreadCachingAllocator allocator;
+} Yoru_ThreadCachingAllocatorCtx;
+
+/* every live allocator owns one slot. A thread's cache in a slot is only
+   valid if its generation matches the generation of the current owner, so
+   a slot can be reused after its previous owner got destroyed */
+typedef struct Yoru_TCacheSlot {
+  u64          generation;
+  Yoru_TCache *cache;
+} Yoru_TCacheSlot;
+
+static YORU_THREAD_LOCAL Yoru_TCacheSlot __yoru_tcache_slots[YORU_TCACHE_MAX_INSTANCES];
+static _Atomic u32                       __yoru_tcache_used_slots  = 0;
+static _Atomic u64                       __yoru_tcache_generations = 0;
+
+Yoru_ThreadCachingAllocator *yoru_thread_caching_allocator_make(usize class_capacity) {
+  Yoru_ThreadCachingAllocatorCtx *ctx = calloc(1, sizeof(Yoru_ThreadCachingAllocatorCtx));
+  if (!ctx) return NULL;
+
+  u32 used = atomic_load(&__yoru_tcache_used_slots);
+  do {
+    if (used == U32_MAX) goto err;
+    ctx->slot = 0;
+    while (used & ((u32)1 << ctx->slot))
+      ++ctx->slot;
+  } while (!atomic_compare_exchange_weak(&__yoru_tcache_used_slots, &used, used | ((u32)1 << ctx->slot)));
+  ctx->generation = atomic_fetch_add(&__yoru_tcache_generations, 1) + 1;
+
+  ctx->central = yoru_slab_allocator_make(class_capacity);
+  if (!ctx->central) goto err_slot;
+  if (!yoru_mutex_init(&ctx->mutex)) goto err_slab;
+
+  ctx->allocator.vtable = &__yoru_thread_caching_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  return &ctx->allocator;
+
+err_slab:
+  yoru_allocator_destroy(ctx->central);
+err_slot:
+  atomic_fetch_and(&__yoru_tcache_used_slots, ~((u32)1 << ctx->slot));
+err:
+  free(ctx);
+  return NULL;
+}
+
+/// returns the cache of the calling thread, creating it on first use
+static inline Yoru_TCache *__yoru_tcache_get(Yoru_ThreadCachingAllocatorCtx *tc) {
+  Yoru_TCacheSlot *slot = &__yoru_tcache_slots[tc->slot];
+  if (slot->generation == tc->generation) return slot->cache;
+
+  Yoru_TCache *cache = calloc(1, sizeof(Yoru_TCache));
+  if (!cache) return NULL;
+
+  yoru_mutex_lock(&tc->mutex);
+  cache->next = tc->caches;
+  tc->caches  = cache;
+  yoru_mutex_unlock(&tc->mutex);
+
+  slot->generation = tc->generation;
+  slot->cache      = cache;
+  return cache;
+}
+
+static inline Yoru_SlabAllocatorCtx *__yoru_tcache_central(Yoru_ThreadCachingAllocatorCtx *tc) {
+  return tc->central->ctx;
+}
+
+static void __yoru_tcache_refill(Yoru_ThreadCachingAllocatorCtx *tc, Yoru_TCacheMagazine *mag, usize class_index) {
+  Yoru_SlabClass *c = &__yoru_tcache_central(tc)->classes[class_index];
+
+  yoru_mutex_lock(&tc->mutex);
+  while (mag->count < YORU_TCACHE_BATCH_SIZE) {
+    bool   reused = false;
+    anyptr ptr    = __yoru_slab_class_pop(c, &reused);
+    if (!ptr) break;
+    mag->blocks[mag->count++] = ptr;
+  }
+  yoru_mutex_unlock(&tc->mutex);
+}
+
+static void
+__yoru_tcache_drain(Yoru_ThreadCachingAllocatorCtx *tc, Yoru_TCacheMagazine *mag, usize class_index, usize count) {
+  Yoru_SlabClass *c = &__yoru_tcache_central(tc)->classes[class_index];
+
+  yoru_mutex_lock(&tc->mutex);
+  while (count-- > 0 && mag->count > 0)
+    __yoru_slab_class_push(c, mag->blocks[--mag->count]);
+  yoru_mutex_unlock(&tc->mutex);
+}
+
+static inline Yoru_Opt __yoru_tcache_alloc(Yoru_ThreadCachingAllocatorCtx *tc, usize size, bool zeroed) {
+  if (size > YORU_SLAB_MAX_BLOCK_SIZE) {
+    return zeroed ? __yoru_global_allocator_alloc(NULL, size) : __yoru_global_allocator_alloc_uninit(NULL, size);
+  }
+
+  Yoru_TCache *cache = __yoru_tcache_get(tc);
+  if (!cache) return yoru_opt_none();
+
+  usize                class_index = __yoru_slab_class_index(size);
+  Yoru_TCacheMagazine *mag         = &cache->magazines[class_index];
+  if (mag->count == 0) {
+    __yoru_tcache_refill(tc, mag, class_index);
+    if (mag->count == 0) return yoru_opt_none();
+  }
+
+  anyptr ptr = mag->blocks[--mag->count];
+  if (zeroed) memset(ptr, 0, (usize)YORU_SLAB_MIN_BLOCK_SIZE << class_index);
+  return yoru_opt_some(ptr);
+}
+
+Yoru_Opt __yoru_thread_caching_allocator_alloc(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_tcache_alloc(ctx, size, true);
+}
+
+Yoru_Opt __yoru_thread_caching_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_tcache_alloc(ctx, size, false);
+}
+
+Yoru_Opt __yoru_thread_caching_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  /* blocks are aligned to their size class, see `SlabAllocator`. Bigger
+     blocks come from the global allocator, which only aligns them if asked to */
+  if (size > YORU_SLAB_MAX_BLOCK_SIZE || alignment > YORU_SLAB_MAX_BLOCK_SIZE) {
+    return __yoru_global_allocator_alloc_aligned(NULL, size, alignment);
+  }
+  return __yoru_thread_caching_allocator_alloc(ctx, size < alignment ? alignment : size);
+}
+
+void __yoru_thread_caching_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  if (!ctx || !ptr) return;
+  Yoru_ThreadCachingAllocatorCtx *tc      = ctx;
+  Yoru_SlabAllocatorCtx          *central = __yoru_tcache_central(tc);
+
+  Yoru_SlabClass *c = __yoru_slab_class_of(central, ptr);
+  if (!c) {
+    __yoru_global_allocator_dealloc(NULL, ptr);
+    return;
+  }
+
+  Yoru_TCache *cache       = __yoru_tcache_get(tc);
+  usize        class_index = (usize)(c - central->classes);
+  if (!cache) {
+    yoru_mutex_lock(&tc->mutex);
+    __yoru_slab_class_push(c, ptr);
+    yoru_mutex_unlock(&tc->mutex);
+    return;
+  }
+
+  Yoru_TCacheMagazine *mag = &cache->magazines[class_index];
+  if (mag->count == YORU_TCACHE_MAGAZINE_SIZE) __yoru_tcache_drain(tc, mag, class_index, YORU_TCACHE_BATCH_SIZE);
+  mag->blocks[mag->count++] = ptr;
+}
+
+Yoru_Opt __yoru_thread_caching_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_thread_caching_allocator_alloc(ctx, new_size);
+
+  /* the block is still big enough, nothing to do */
+  Yoru_SlabClass *c = __yoru_slab_class_of(__yoru_tcache_central(ctx), old_ptr);
+  if (c && new_size <= c->block_size) return yoru_opt_some(old_ptr);
+
+  /* big blocks stay with the global allocator which can grow them in place */
+  if (!c && new_size > YORU_SLAB_MAX_BLOCK_SIZE) {
+    return __yoru_global_allocator_realloc(NULL, old_size, old_ptr, new_size);
+  }
+
+  Yoru_Opt maybe_new_ptr = __yoru_thread_caching_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  __yoru_thread_caching_allocator_dealloc(ctx, old_ptr);
+  return maybe_new_ptr;
+}
+
+void yoru_thread_caching_allocator_flush(Yoru_ThreadCachingAllocator *allocator) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_thread_caching_allocator_vtable && "not a thread-caching allocator");
+  Yoru_ThreadCachingAllocatorCtx *tc   = allocator->ctx;
+  Yoru_TCacheSlot                *slot = &__yoru_tcache_slots[tc->slot];
+  if (slot->generation != tc->generation) return;
+
+  for (usize i = 0; i < YORU_SLAB_CLASS_COUNT; ++i) {
+    Yoru_TCacheMagazine *mag = &slot->cache->magazines[i];
+    __yoru_tcache_drain(tc, mag, i, mag->count);
+  }
+}
+
+void __yoru_thread_caching_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  Yoru_ThreadCachingAllocatorCtx *c = ctx;
+
+  /* cached blocks live inside the central heap and go away with it */
+  Yoru_TCache *cache = c->caches;
+  while (cache) {
+    Yoru_TCache *next = cache->next;
+    free(cache);
+    cache = next;
+  }
+
+  yoru_allocator_destroy(c->central);
+  yoru_mutex_destroy(&c->mutex);
+  atomic_fetch_and(&__yoru_tcache_used_slots, ~((u32)1 << c->slot));
+  free(c);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: ConcurrentArenaAllocator
+   provides a virtual-memory backed arena that many threads can
+   allocate from at the same time, e.g. parallel parsers that
+   all put their nodes into one region which is freed at once.
+
+   An allocation is a single atomic fetch-add on the offset.
+   Only the thread that runs past the committed range takes the
+   slow path: committing is serialized through a CAS on a flag
+   and grows geometrically like the `VirtualArenaAllocator`. A
+   block that runs past the capacity hands its range back, so a
+   request that is too big fails without using up the arena.
+
+   Allocations with an alignment above `YORU_DEFAULT_ALIGNMENT`
+   use a CAS loop instead of the fetch-add. Only the most recent
+   allocation can be resized in place.
+   ============================================================ */
+
+typedef Yoru_Allocator Yoru_ConcurrentArenaAllocator;
+
+/// @brief Creates a concurrent arena that reserves `capacity` bytes of
+/// address space. Nothing is committed until the first allocation.
+Yoru_ConcurrentArenaAllocator *yoru_concurrent_arena_allocator_make(usize capacity);
+
+/// @brief Rolls the arena back to the start, keeping committed pages.
+/// @note Not thread-safe, no other thread may use the arena at the same time
+void yoru_concurrent_arena_allocator_reset(Yoru_ConcurrentArenaAllocator *allocator);
+
+#  ifdef YORU_IMPL
+Yoru_Opt __yoru_concurrent_arena_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_concurrent_arena_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_concurrent_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_concurrent_arena_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_concurrent_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_concurrent_arena_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_concurrent_arena_allocator_vtable = {
+    .alloc         = __yoru_concurrent_arena_allocator_alloc,
+    .alloc_uninit  = __yoru_concurrent_arena_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_concurrent_arena_allocator_alloc_aligned,
+    .dealloc       = __yoru_concurrent_arena_allocator_dealloc,
+    .realloc       = __yoru_concurrent_arena_allocator_realloc,
+    .destroy       = __yoru_concurrent_arena_allocator_destroy,
+};
+
+typedef struct Yoru_ConcurrentArenaAllocatorCtx {
+  /* `offset` is hammered by every allocating thread, keep it away from the
+     fields that are only read on the fast path */
+  _Atomic usize offset;
+  u8            offset_padding[YORU_CACHE_LINE_SIZE - sizeof(usize)];
+  _Atomic usize committed; // bytes of the reservation that are safe to use
+  _Atomic bool  committing;
+  usize         dirty_end;        // everything below was handed out before the last reset
+  usize         next_commit_size; // only touched while holding `committing`
+  Yoru_Vmem_Ctx vmem_ctx;         // commit_pos only touched while holding `committing`
+
+  Yoru_ConcurrentArenaAllocator allocator;
+} Yoru_ConcurrentArenaAllocatorCtx;
+
+Yoru_ConcurrentArenaAllocator *yoru_concurrent_arena_allocator_make(usize capacity) {
+  Yoru_ConcurrentArenaAllocatorCtx *ctx = calloc(1, sizeof(Yoru_ConcurrentArenaAllocatorCtx));
+  if (!ctx) return NULL;
+
+  if (!yoru_vmem_reserve(yoru_align_up(capacity, yoru_get_page_size()), &ctx->vmem_ctx)) {
+    free(ctx);
+    return NULL;
+  }
+
+  atomic_init(&ctx->offset, 0);
+  atomic_init(&ctx->committed, 0);
+  atomic_init(&ctx->committing, false);
+  ctx->dirty_end        = 0;
+  ctx->next_commit_size = YORU_VIRTUAL_ARENA_MIN_COMMIT_SIZE;
+  ctx->allocator.vtable = &__yoru_concurrent_arena_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  return &ctx->allocator;
+}
+
+/// makes sure that at least `needed` bytes are committed. The thread that wins
+/// the CAS on `committing` commits for everyone, the others wait for it
+static bool __yoru_concurrent_arena_commit_to(Yoru_ConcurrentArenaAllocatorCtx *arena, usize needed) {
+  Yoru_Vmem_Ctx *vm = &arena->vmem_ctx;
+  if (needed > vm->addr_space_size) return false;
+
+  while (atomic_load_explicit(&arena->committed, memory_order_acquire) < needed) {
+    bool expected = false;
+    if (!atomic_compare_exchange_weak_explicit(
+            &arena->committing, &expected, true, memory_order_acquire, memory_order_relaxed)) {
+      yoru_thread_yield();
+      continue;
+    }
+
+    bool ok = true;
+    if (vm->commit_pos < needed) {
+      usize step      = needed - vm->commit_pos;
+      usize remaining = vm->addr_space_size - vm->commit_pos;
+      if (step < arena->next_commit_size) step = arena->next_commit_size;
+      if (step > remaining) step = remaining;
+      ok = yoru_vmem_commit(vm, step);
+      if (ok && arena->next_commit_size < YORU_VIRTUAL_ARENA_MAX_COMMIT_SIZE) arena->next_commit_size *= 2;
+      if (ok) atomic_store_explicit(&arena->committed, vm->commit_pos, memory_order_release);
+    }
+    atomic_store_explicit(&arena->committing, false, memory_order_release);
+    if (!ok) return false;
+  }
+  return true;
+}
+
+/// hands out [start, end) after making sure it is committed and, if `zeroed`,
+/// clearing the part that was used before the last reset
+static inline Yoru_Opt
+__yoru_concurrent_arena_finish(Yoru_ConcurrentArenaAllocatorCtx *arena, usize start, usize end, bool zeroed) {
+  if (end > arena->vmem_ctx.addr_space_size) return yoru_opt_none();
+  if (!__yoru_concurrent_arena_commit_to(arena, end)) return yoru_opt_none();
+
+  u8 *ptr = (u8 *)arena->vmem_ctx.base + start;
+  if (zeroed && start < arena->dirty_end) memset(ptr, 0, (end < arena->dirty_end ? end : arena->dirty_end) - start);
+  return yoru_opt_some(ptr);
+}
+
+/// hands [start, end) back after a bump that did not fit. Every bump after it
+/// started past the capacity as well and hands its range back first, so this
+/// waits until the offset is back at `end`
+static inline void __yoru_concurrent_arena_unbump(Yoru_ConcurrentArenaAllocatorCtx *arena, usize start, usize end) {
+  usize expected = end;
+  while (!atomic_compare_exchange_weak_explicit(
+      &arena->offset, &expected, start, memory_order_relaxed, memory_order_relaxed)) {
+    expected = end;
+    yoru_thread_yield();
+  }
+}
+
+static inline Yoru_Opt __yoru_concurrent_arena_bump(Yoru_ConcurrentArenaAllocatorCtx *arena, usize size, bool zeroed) {
+  /* every allocation is a multiple of the default alignment, so every offset
+     is aligned without having to look at it */
+  size = yoru_align_up(size ? size : 1, YORU_DEFAULT_ALIGNMENT);
+  if (size > arena->vmem_ctx.addr_space_size) return yoru_opt_none();
+
+  usize start = atomic_fetch_add_explicit(&arena->offset, size, memory_order_relaxed);
+  if (start + size > arena->vmem_ctx.addr_space_size) {
+    __yoru_concurrent_arena_unbump(arena, start, start + size);
+    return yoru_opt_none();
+  }
+
+  Yoru_Opt maybe_ptr = __yoru_concurrent_arena_finish(arena, start, start + size, zeroed);
+  if (!maybe_ptr.has_value) {
+    /* could not commit, give the range back unless another block is behind it */
+    usize end = start + size;
+    atomic_compare_exchange_strong_explicit(&arena->offset, &end, start, memory_order_relaxed, memory_order_relaxed);
+  }
+  return maybe_ptr;
+}
+
+Yoru_Opt __yoru_concurrent_arena_allocator_alloc(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_concurrent_arena_bump(ctx, size, true);
+}
+
+Yoru_Opt __yoru_concurrent_arena_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_concurrent_arena_bump(ctx, size, false);
+}
+
+Yoru_Opt __yoru_concurrent_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  if (alignment <= YORU_DEFAULT_ALIGNMENT) return __yoru_concurrent_arena_bump(ctx, size, true);
+
+  /* the CAS only publishes the new offset if the block fits */
+  Yoru_ConcurrentArenaAllocatorCtx *arena    = ctx;
+  usize                             base     = (usize)arena->vmem_ctx.base;
+  usize                             capacity = arena->vmem_ctx.addr_space_size;
+  usize                             start    = 0;
+  usize                             end      = 0;
+  usize                             old      = atomic_load_explicit(&arena->offset, memory_order_relaxed);
+  do {
+    start = yoru_align_up(base + old, alignment) - base;
+    end   = start + yoru_align_up(size ? size : 1, YORU_DEFAULT_ALIGNMENT);
+    if (start > capacity || end > capacity || end < start) return yoru_opt_none();
+  } while (!atomic_compare_exchange_weak_explicit(
+      &arena->offset, &old, end, memory_order_relaxed, memory_order_relaxed));
+  return __yoru_concurrent_arena_finish(arena, start, end, true);
+}
+
+void __yoru_concurrent_arena_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  (void)ptr;
+  /* same as for the other arenas, everything is freed at once */
+}
+
+Yoru_Opt __yoru_concurrent_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_concurrent_arena_allocator_alloc(ctx, new_size);
+
+  /* if no other thread allocated since, the block is still at the end of the
+     arena and can be resized by moving the offset. The new end is committed
+     first, so once the CAS moved the offset nothing can fail anymore */
+  Yoru_ConcurrentArenaAllocatorCtx *arena   = ctx;
+  usize                             start   = (usize)((u8 *)old_ptr - (u8 *)arena->vmem_ctx.base);
+  usize                             old_end = start + yoru_align_up(old_size ? old_size : 1, YORU_DEFAULT_ALIGNMENT);
+  usize                             new_end = start + yoru_align_up(new_size ? new_size : 1, YORU_DEFAULT_ALIGNMENT);
+  if (atomic_load_explicit(&arena->offset, memory_order_relaxed) == old_end &&
+      __yoru_concurrent_arena_commit_to(arena, new_end) &&
+      atomic_compare_exchange_strong_explicit(
+          &arena->offset, &old_end, new_end, memory_order_relaxed, memory_order_relaxed)) {
+    return yoru_opt_some(old_ptr);
+  }
+
+  Yoru_Opt maybe_new_ptr = __yoru_concurrent_arena_allocator_alloc_uninit(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size < new_size ? old_size : new_size);
+  return maybe_new_ptr;
+}
+
+void yoru_concurrent_arena_allocator_reset(Yoru_ConcurrentArenaAllocator *allocator) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_concurrent_arena_allocator_vtable && "not a concurrent arena allocator");
+  Yoru_ConcurrentArenaAllocatorCtx *arena = allocator->ctx;
+
+  usize offset = atomic_load_explicit(&arena->offset, memory_order_relaxed);
+  if (offset > arena->dirty_end) arena->dirty_end = offset;
+  atomic_store_explicit(&arena->offset, 0, memory_order_relaxed);
+}
+
+void __yoru_concurrent_arena_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  Yoru_ConcurrentArenaAllocatorCtx *c = ctx;
+  yoru_vmem_free(&c->vmem_ctx);
+  free(c);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: SharedArenaAllocator
+   provides an arena in shared memory, so one process can build
+   data that other processes attach to and read without copying
+   or loading it themselves.
+
+   The arena lives in a named shared memory object (shm_open,
+   or a named file mapping on Windows). Without a name the
+   memory is anonymous and shared with the children forked
+   after creating it. The position of the arena is an atomic in
+   the shared header, so processes with a writable attachment
+   can allocate at the same time.
+
+   Every process maps the memory at another address, so data in
+   the arena must link through offsets (see `_to_offset` and
+   `_from_offset`) instead of pointers. Memory is never reused,
+   so there is no reset.
+   ============================================================ */
+
+typedef Yoru_Allocator Yoru_SharedArenaAllocator;
+
+/// @brief Creates a shared arena of `capacity` bytes under `name` (e.g.
+/// "/dataset", fails if it already exists) or an anonymous one for a NULL
+/// `name`
+Yoru_SharedArenaAllocator *yoru_shared_arena_allocator_create(cstr name, usize capacity);
+
+/// @brief Attaches to the shared arena `name`. A read-only attachment can not
+/// allocate, its allocations always fail
+Yoru_SharedArenaAllocator *yoru_shared_arena_allocator_attach(cstr name, bool read_only);
+
+/// @brief Removes the name of a shared arena. Attached processes keep their
+/// mapping, the memory is freed once the last one is destroyed. A no-op on
+/// Windows where the memory goes away with the last handle anyway
+bool yoru_shared_arena_allocator_unlink(cstr name);
+
+/// @brief Publishes `root` (memory from the arena or NULL) to every attached
+/// process. Everything written before is visible to a process that gets it
+void yoru_shared_arena_allocator_set_root(Yoru_SharedArenaAllocator *allocator, anyptr root);
+
+/// @brief Returns the published root in this process, or NULL if there is none
+anyptr yoru_shared_arena_allocator_get_root(Yoru_SharedArenaAllocator *allocator);
+
+/// @brief Converts a pointer into the arena to an offset that is valid in every
+/// process. NULL becomes 0
+usize yoru_shared_arena_allocator_to_offset(Yoru_SharedArenaAllocator *allocator, anyptr ptr);
+
+/// @brief Converts an offset back to a pointer for this process. 0 becomes NULL
+anyptr yoru_shared_arena_allocator_from_offset(Yoru_SharedArenaAllocator *allocator, usize offset);
+
+#  ifdef YORU_IMPL
+Yoru_Opt __yoru_shared_arena_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_shared_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_shared_arena_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_shared_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_shared_arena_allocator_destroy(anyptr ctx);
+
+/* memory is never handed out twice, so it is always still zeroed */
+static const Yoru_AllocatorVTable __yoru_shared_arena_allocator_vtable = {
+    .alloc         = __yoru_shared_arena_allocator_alloc,
+    .alloc_uninit  = __yoru_shared_arena_allocator_alloc,
+    .alloc_aligned = __yoru_shared_arena_allocator_alloc_aligned,
+    .dealloc       = __yoru_shared_arena_allocator_dealloc,
+    .realloc       = __yoru_shared_arena_allocator_realloc,
+    .destroy       = __yoru_shared_arena_allocator_destroy,
+};
+
+#    define __YORU_SHARED_ARENA_MAGIC (0x4552414853524f59ull) // "YORSHARE"
+
+/* sits at the start of the shared memory, offsets are relative to it */
+typedef struct Yoru_SharedArenaHeader {
+  _Atomic u64 magic; // stored last, attaching fails until the header is ready
+  u64         capacity;
+  u64         data_start;
+  _Atomic u64 root;
+  u8          padding[YORU_CACHE_LINE_SIZE - 4 * sizeof(u64)];
+  _Atomic u64 offset; // allocating processes fight over it, keep it on its own cache line
+} Yoru_SharedArenaHeader;
+
+typedef struct Yoru_SharedArenaAllocatorCtx {
+  Yoru_SharedArenaHeader *header;
+  usize                   size;
+  bool                    read_only;
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  int fd; // -1 for anonymous memory
+#    elif defined(_WIN32)
+  HANDLE mapping;
+#    endif
+
+  Yoru_SharedArenaAllocator allocator;
+} Yoru_SharedArenaAllocatorCtx;
+
+static Yoru_SharedArenaAllocator *__yoru_shared_arena_finish(Yoru_SharedArenaAllocatorCtx *ctx, bool read_only) {
+  ctx->read_only        = read_only;
+  ctx->allocator.vtable = &__yoru_shared_arena_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  return &ctx->allocator;
+}
+
+Yoru_SharedArenaAllocator *yoru_shared_arena_allocator_create(cstr name, usize capacity) {
+  usize data_start = yoru_align_up(sizeof(Yoru_SharedArenaHeader), YORU_CACHE_LINE_SIZE);
+  capacity         = yoru_align_up(capacity, yoru_get_page_size());
+  if (capacity <= data_start) return NULL;
+
+  Yoru_SharedArenaAllocatorCtx *ctx = calloc(1, sizeof(Yoru_SharedArenaAllocatorCtx));
+  if (!ctx) return NULL;
+  ctx->size = capacity;
+
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  anyptr ptr = MAP_FAILED;
+  ctx->fd    = -1;
+  if (!name) {
+    ptr = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  } else {
+    ctx->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (ctx->fd < 0) goto err;
+    if (ftruncate(ctx->fd, (off_t)capacity) != 0) goto err;
+    ptr = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, ctx->fd, 0);
+  }
+  if (ptr == MAP_FAILED) goto err;
+  ctx->header = ptr;
+#    elif defined(_WIN32)
+  DWORD high   = (DWORD)((u64)capacity >> 32);
+  DWORD low    = (DWORD)((u64)capacity & 0xFFFFFFFF);
+  ctx->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, high, low, name);
+  if (!ctx->mapping || GetLastError() == ERROR_ALREADY_EXISTS) goto err;
+  ctx->header = MapViewOfFile(ctx->mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity);
+  if (!ctx->header) goto err;
+#    endif
+
+  Yoru_SharedArenaHeader *header = ctx->header;
+  assert(atomic_is_lock_free(&header->offset) && "the offset has to be lock-free to work across processes");
+  header->capacity   = capacity;
+  header->data_start = data_start;
+  atomic_store_explicit(&header->root, 0, memory_order_relaxed);
+  atomic_store_explicit(&header->offset, data_start, memory_order_relaxed);
+  atomic_store_explicit(&header->magic, __YORU_SHARED_ARENA_MAGIC, memory_order_release);
+  return __yoru_shared_arena_finish(ctx, false);
+
+err:
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  if (ctx->fd >= 0) {
+    close(ctx->fd);
+    shm_unlink(name);
+  }
+#    elif defined(_WIN32)
+  if (ctx->mapping) CloseHandle(ctx->mapping);
+#    endif
+  free(ctx);
+  return NULL;
+}
+
+Yoru_SharedArenaAllocator *yoru_shared_arena_allocator_attach(cstr name, bool read_only) {
+  assert(name && "anonymous arenas are shared by forking");
+  Yoru_SharedArenaAllocatorCtx *ctx = calloc(1, sizeof(Yoru_SharedArenaAllocatorCtx));
+  if (!ctx) return NULL;
+
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  struct stat st = {0};
+  ctx->fd        = shm_open(name, read_only ? O_RDONLY : O_RDWR, 0);
+  if (ctx->fd < 0) goto err;
+  if (fstat(ctx->fd, &st) != 0 || (usize)st.st_size < sizeof(Yoru_SharedArenaHeader)) goto err;
+  ctx->size  = (usize)st.st_size;
+  anyptr ptr = mmap(NULL, ctx->size, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, ctx->fd, 0);
+  if (ptr == MAP_FAILED) goto err;
+  ctx->header = ptr;
+#    elif defined(_WIN32)
+  DWORD access = read_only ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS;
+  ctx->mapping = OpenFileMappingA(access, FALSE, name);
+  if (!ctx->mapping) goto err;
+  ctx->header = MapViewOfFile(ctx->mapping, access, 0, 0, 0);
+  if (!ctx->header) goto err;
+  MEMORY_BASIC_INFORMATION info = {0};
+  VirtualQuery(ctx->header, &info, sizeof(info));
+  ctx->size = info.RegionSize;
+#    endif
+
+  // the creator may still be setting up the header
+  if (atomic_load_explicit(&ctx->header->magic, memory_order_acquire) != __YORU_SHARED_ARENA_MAGIC ||
+      ctx->header->capacity > ctx->size) {
+    __yoru_shared_arena_allocator_destroy(ctx);
+    return NULL;
+  }
+  return __yoru_shared_arena_finish(ctx, read_only);
+
+err:
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  if (ctx->fd >= 0) close(ctx->fd);
+#    elif defined(_WIN32)
+  if (ctx->mapping) CloseHandle(ctx->mapping);
+#    endif
+  free(ctx);
+  return NULL;
+}
+
+bool yoru_shared_arena_allocator_unlink(cstr name) {
+  assert(name && "must not be null");
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  return shm_unlink(name) == 0;
+#    elif defined(_WIN32)
+  (void)name;
+  return true;
+#    endif
+}
+
+/// claims [start, start + size) at `alignment` with a CAS, the offset never
+/// moves past the capacity
+static inline Yoru_Opt __yoru_shared_arena_bump(Yoru_SharedArenaAllocatorCtx *arena, usize size, usize alignment) {
+  if (arena->read_only) return yoru_opt_none();
+  Yoru_SharedArenaHeader *header = arena->header;
+
+  usize start = 0;
+  u64   old   = atomic_load_explicit(&header->offset, memory_order_relaxed);
+  do {
+    start = yoru_align_up((usize)old, alignment);
+    if (start > header->capacity || size > header->capacity - start) return yoru_opt_none();
+  } while (!atomic_compare_exchange_weak_explicit(
+      &header->offset, &old, start + size, memory_order_relaxed, memory_order_relaxed));
+  return yoru_opt_some((u8 *)header + start);
+}
+
+Yoru_Opt __yoru_shared_arena_allocator_alloc(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_shared_arena_bump(ctx, size, YORU_DEFAULT_ALIGNMENT);
+}
+
+Yoru_Opt __yoru_shared_arena_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_shared_arena_bump(ctx, size, alignment < YORU_DEFAULT_ALIGNMENT ? YORU_DEFAULT_ALIGNMENT : alignment);
+}
+
+void __yoru_shared_arena_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  (void)ctx;
+  (void)ptr;
+  // the memory is freed when the last process lets go of the arena
+}
+
+Yoru_Opt __yoru_shared_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_shared_arena_allocator_alloc(ctx, new_size);
+  Yoru_SharedArenaAllocatorCtx *arena = ctx;
+  if (arena->read_only) return yoru_opt_none();
+
+  /* if nobody allocated since, the block is still at the end of the arena.
+     Shrinking keeps the memory, it might still be read somewhere */
+  Yoru_SharedArenaHeader *header  = arena->header;
+  u64                     start   = (u64)((u8 *)old_ptr - (u8 *)header);
+  u64                     old_end = start + old_size;
+  if (new_size > old_size && new_size <= header->capacity - start &&
+      atomic_compare_exchange_strong_explicit(
+          &header->offset, &old_end, start + new_size, memory_order_relaxed, memory_order_relaxed)) {
+    return yoru_opt_some(old_ptr);
+  }
+  if (new_size <= old_size) return yoru_opt_some(old_ptr);
+
+  Yoru_Opt maybe_new_ptr = __yoru_shared_arena_allocator_alloc(ctx, new_size);
+  if (!maybe_new_ptr.has_value) return yoru_opt_none();
+  memcpy(maybe_new_ptr.ptr, old_ptr, old_size);
+  return maybe_new_ptr;
+}
+
+static inline Yoru_SharedArenaAllocatorCtx *__yoru_shared_arena_ctx(Yoru_SharedArenaAllocator *allocator) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_shared_arena_allocator_vtable && "not a shared arena allocator");
+  return allocator->ctx;
+}
+
+void yoru_shared_arena_allocator_set_root(Yoru_SharedArenaAllocator *allocator, anyptr root) {
+  Yoru_SharedArenaAllocatorCtx *arena  = __yoru_shared_arena_ctx(allocator);
+  usize                         offset = yoru_shared_arena_allocator_to_offset(allocator, root);
+  assert(!arena->read_only && "read-only attachments can not publish a root");
+  atomic_store_explicit(&arena->header->root, offset, memory_order_release);
+}
+
+anyptr yoru_shared_arena_allocator_get_root(Yoru_SharedArenaAllocator *allocator) {
+  Yoru_SharedArenaAllocatorCtx *arena = __yoru_shared_arena_ctx(allocator);
+  usize                         root  = atomic_load_explicit(&arena->header->root, memory_order_acquire);
+  return yoru_shared_arena_allocator_from_offset(allocator, root);
+}
+
+usize yoru_shared_arena_allocator_to_offset(Yoru_SharedArenaAllocator *allocator, anyptr ptr) {
+  Yoru_SharedArenaHeader *header = __yoru_shared_arena_ctx(allocator)->header;
+  if (!ptr) return 0;
+  assert((u8 *)ptr >= (u8 *)header + header->data_start && "not memory of this arena");
+  assert((u8 *)ptr < (u8 *)header + header->capacity && "not memory of this arena");
+  return (usize)((u8 *)ptr - (u8 *)header);
+}
+
+anyptr yoru_shared_arena_allocator_from_offset(Yoru_SharedArenaAllocator *allocator, usize offset) {
+  Yoru_SharedArenaHeader *header = __yoru_shared_arena_ctx(allocator)->header;
+  if (offset == 0) return NULL;
+  assert(offset >= header->data_start && offset < header->capacity && "offset out of bounds");
+  return (u8 *)header + offset;
+}
+
+void __yoru_shared_arena_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  Yoru_SharedArenaAllocatorCtx *arena = ctx;
+#    if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__))
+  munmap(arena->header, arena->size);
+  if (arena->fd >= 0) close(arena->fd);
+#    elif defined(_WIN32)
+  UnmapViewOfFile(arena->header);
+  CloseHandle(arena->mapping);
+#    endif
+  free(arena);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+/* ============================================================
+   MODULE: TrackingAllocator
+   provides an allocator that wraps any other allocator and
+   keeps statistics about the allocations that go through it:
+   allocation, deallocation and reallocation counts, bytes in
+   use, peak bytes in use and a histogram of allocation sizes.
+
+   The counters are updated with relaxed atomics and without
+   any locks, so it is cheap enough to stay enabled in
+   production. It is as thread-safe as the allocator it wraps.
+
+   Every allocation is prefixed with a small header that
+   remembers its size, so `dealloc` can account for it.
+
+   ```c
+   Yoru_GlobalAllocator    global  = yoru_global_allocator_make();
+   Yoru_TrackingAllocator *tracked = yoru_tracking_allocator_make(&global, "hashmaps");
+   ...
+   yoru_tracking_allocator_report(tracked, stdout);
+   ```
+   ============================================================ */
+
+/// buckets of the size histogram: <= 16 bytes, <= 32 bytes, ..., <= 256 KiB
+/// and everything bigger in the last bucket
+#define YORU_TRACKING_HISTOGRAM_BUCKETS (16)
+#define YORU_TRACKING_HISTOGRAM_MIN_SIZE (16)
+
+typedef Yoru_Allocator Yoru_TrackingAllocator;
+
+/// @brief A snapshot of the statistics of a `TrackingAllocator`
+typedef struct Yoru_TrackingStats {
+  const char *tag;
+  usize       alloc_count;
+  usize       dealloc_count;
+  usize       realloc_count;
+  usize       bytes_in_use;
+  usize       peak_bytes_in_use;
+  /// number of allocations and reallocations per requested size, see
+  /// `YORU_TRACKING_HISTOGRAM_BUCKETS`
+  usize histogram[YORU_TRACKING_HISTOGRAM_BUCKETS];
+} Yoru_TrackingStats;
+
+/// @brief Creates a tracking allocator that forwards every allocation to
+/// `inner`. `tag` names the allocator in reports and must outlive it.
+/// Destroying the tracking allocator does NOT destroy `inner`
+Yoru_TrackingAllocator *yoru_tracking_allocator_make(Yoru_Allocator *inner, const char *tag);
+
+/// @brief Returns the current statistics. Counters are read one by one, so
+/// the snapshot is not atomic while other threads keep allocating
+Yoru_TrackingStats yoru_tracking_allocator_get_stats(Yoru_TrackingAllocator *allocator);
+
+/// @brief Writes a human readable report of the statistics to `out`
+void yoru_tracking_allocator_report(Yoru_TrackingAllocator *allocator, FILE *out);
+
+#ifdef YORU_IMPL
+Yoru_Opt __yoru_tracking_allocator_alloc(anyptr ctx, usize size);
+Yoru_Opt __yoru_tracking_allocator_alloc_uninit(anyptr ctx, usize size);
+Yoru_Opt __yoru_tracking_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment);
+void     __yoru_tracking_allocator_dealloc(anyptr ctx, anyptr ptr);
+Yoru_Opt __yoru_tracking_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size);
+void     __yoru_tracking_allocator_destroy(anyptr ctx);
+
+static const Yoru_AllocatorVTable __yoru_tracking_allocator_vtable = {
+    .alloc         = __yoru_tracking_allocator_alloc,
+    .alloc_uninit  = __yoru_tracking_allocator_alloc_uninit,
+    .alloc_aligned = __yoru_tracking_allocator_alloc_aligned,
+    .dealloc       = __yoru_tracking_allocator_dealloc,
+    .realloc       = __yoru_tracking_allocator_realloc,
+    .destroy       = __yoru_tracking_allocator_destroy,
+};
+
+/* sits right in front of every pointer handed out. `padding` is the distance
+   from the start of the inner block to the user pointer, which is bigger than
+   the header for alignments above YORU_DEFAULT_ALIGNMENT */
+typedef struct Yoru_TrackingHeader {
+  usize size;
+  usize padding;
+} Yoru_TrackingHeader;
+
+static_assert(sizeof(Yoru_TrackingHeader) <= YORU_DEFAULT_ALIGNMENT, "header must fit into the default alignment");
+
+typedef struct Yoru_TrackingAllocatorCtx {
+  Yoru_Allocator        *inner;
+  const char            *tag;
+  _Atomic usize          alloc_count;
+  _Atomic usize          dealloc_count;
+  _Atomic usize          realloc_count;
+  _Atomic usize          bytes_in_use;
+  _Atomic usize          peak_bytes_in_use;
+  _Atomic usize          histogram[YORU_TRACKING_HISTOGRAM_BUCKETS];
+  Yoru_TrackingAllocator allocator;
+} Yoru_TrackingAllocatorCtx;
+
+Yoru_TrackingAllocator *yoru_tracking_allocator_make(Yoru_Allocator *inner, const char *tag) {
+  assert(inner && "must not be null");
+  Yoru_TrackingAllocatorCtx *ctx = calloc(1, sizeof(Yoru_TrackingAllocatorCtx));
+  if (!ctx) return NULL;
+
+  ctx->inner            = inner;
+  ctx->tag              = tag ? tag : "tracking allocator";
+  ctx->allocator.vtable = &__yoru_tracking_allocator_vtable;
+  ctx->allocator.ctx    = ctx;
+  return &ctx->allocator;
+}
+
+static inline usize __yoru_tracking_bucket(usize size) {
+  usize bucket     = 0;
+  usize class_size = YORU_TRACKING_HISTOGRAM_MIN_SIZE;
+  while (class_size < size && bucket < YORU_TRACKING_HISTOGRAM_BUCKETS - 1) {
+    class_size <<= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+static inline void __yoru_tracking_add_bytes(Yoru_TrackingAllocatorCtx *t, usize size) {
+  usize in_use = atomic_fetch_add_explicit(&t->bytes_in_use, size, memory_order_relaxed) + size;
+  usize peak   = atomic_load_explicit(&t->peak_bytes_in_use, memory_order_relaxed);
+  /* a failed exchange reloads `peak`, so this stops as soon as another thread
+     stored a bigger peak */
+  while (in_use > peak) {
+    bool stored = atomic_compare_exchange_weak_explicit(
+        &t->peak_bytes_in_use, &peak, in_use, memory_order_relaxed, memory_order_relaxed);
+    if (stored) break;
+  }
+}
+
+static inline void __yoru_tracking_record(Yoru_TrackingAllocatorCtx *t, usize size) {
+  atomic_fetch_add_explicit(&t->histogram[__yoru_tracking_bucket(size)], 1, memory_order_relaxed);
+}
+
+/// writes the header in front of the user pointer and returns the user pointer
+static inline anyptr __yoru_tracking_wrap(anyptr block, usize size, usize padding) {
+  u8                  *ptr    = (u8 *)block + padding;
+  Yoru_TrackingHeader *header = (Yoru_TrackingHeader *)ptr - 1;
+  header->size                = size;
+  header->padding             = padding;
+  return ptr;
+}
+
+static inline Yoru_TrackingHeader *__yoru_tracking_header_of(anyptr ptr) {
+  return (Yoru_TrackingHeader *)ptr - 1;
+}
+
+static inline Yoru_Opt __yoru_tracking_inner_alloc(Yoru_Allocator *inner, usize size, usize alignment, bool zeroed) {
+  if (alignment > YORU_DEFAULT_ALIGNMENT) return yoru_allocator_alloc_aligned(inner, size, alignment);
+  if (zeroed) return yoru_allocator_alloc(inner, size);
+  return yoru_allocator_alloc_uninit(inner, size);
+}
+
+static inline Yoru_Opt __yoru_tracking_alloc(Yoru_TrackingAllocatorCtx *t, usize size, usize alignment, bool zeroed) {
+  usize    padding = alignment > YORU_DEFAULT_ALIGNMENT ? alignment : YORU_DEFAULT_ALIGNMENT;
+  Yoru_Opt maybe_block = __yoru_tracking_inner_alloc(t->inner, padding + size, alignment, zeroed);
+  if (!maybe_block.has_value) return yoru_opt_none();
+
+  atomic_fetch_add_explicit(&t->alloc_count, 1, memory_order_relaxed);
+  __yoru_tracking_add_bytes(t, size);
+  __yoru_tracking_record(t, size);
+  return yoru_opt_some(__yoru_tracking_wrap(maybe_block.ptr, size, padding));
+}
+
+Yoru_Opt __yoru_tracking_allocator_alloc(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_tracking_alloc(ctx, size, YORU_DEFAULT_ALIGNMENT, true);
+}
+
+Yoru_Opt __yoru_tracking_allocator_alloc_uninit(anyptr ctx, usize size) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_tracking_alloc(ctx, size, YORU_DEFAULT_ALIGNMENT, false);
+}
+
+Yoru_Opt __yoru_tracking_allocator_alloc_aligned(anyptr ctx, usize size, usize alignment) {
+  if (!ctx) return yoru_opt_none();
+  return __yoru_tracking_alloc(ctx, size, alignment, true);
+}
+
+void __yoru_tracking_allocator_dealloc(anyptr ctx, anyptr ptr) {
+  if (!ctx || !ptr) return;
+  Yoru_TrackingAllocatorCtx *t      = ctx;
+  Yoru_TrackingHeader       *header = __yoru_tracking_header_of(ptr);
+
+  atomic_fetch_add_explicit(&t->dealloc_count, 1, memory_order_relaxed);
+  atomic_fetch_sub_explicit(&t->bytes_in_use, header->size, memory_order_relaxed);
+  yoru_allocator_dealloc(t->inner, (u8 *)ptr - header->padding);
+}
+
+Yoru_Opt __yoru_tracking_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
+  (void)old_size;
+  if (!ctx) return yoru_opt_none();
+  if (!old_ptr) return __yoru_tracking_allocator_alloc(ctx, new_size);
+
+  /* the size in the header is the one that was accounted for, so it is used
+     instead of `old_size`. The padding is kept, it is a multiple of
+     YORU_DEFAULT_ALIGNMENT and the inner realloc keeps that alignment */
+  Yoru_TrackingAllocatorCtx *t         = ctx;
+  Yoru_TrackingHeader       *header    = __yoru_tracking_header_of(old_ptr);
+  usize                      tracked   = header->size;
+  usize                      padding   = header->padding;
+  u8                        *old_block = (u8 *)old_ptr - padding;
+
+  Yoru_Opt maybe_block = yoru_allocator_realloc(t->inner, padding + tracked, old_block, padding + new_size);
+  if (!maybe_block.has_value) return yoru_opt_none();
+
+  atomic_fetch_add_explicit(&t->realloc_count, 1, memory_order_relaxed);
+  if (new_size > tracked) {
+    __yoru_tracking_add_bytes(t, new_size - tracked);
+  } else {
+    atomic_fetch_sub_explicit(&t->bytes_in_use, tracked - new_size, memory_order_relaxed);
+  }
+  __yoru_tracking_record(t, new_size);
+  return yoru_opt_some(__yoru_tracking_wrap(maybe_block.ptr, new_size, padding));
+}
+
+void __yoru_tracking_allocator_destroy(anyptr ctx) {
+  assert(ctx && "must not be null");
+  free(ctx);
+}
+
+Yoru_TrackingStats yoru_tracking_allocator_get_stats(Yoru_TrackingAllocator *allocator) {
+  assert(allocator && "must not be null");
+  assert(allocator->vtable == &__yoru_tracking_allocator_vtable && "not a tracking allocator");
+  Yoru_TrackingAllocatorCtx *t = allocator->ctx;
+
+  Yoru_TrackingStats stats = {0};
+  stats.tag                = t->tag;
+  stats.alloc_count        = atomic_load_explicit(&t->alloc_count, memory_order_relaxed);
+  stats.dealloc_count      = atomic_load_explicit(&t->dealloc_count, memory_order_relaxed);
+  stats.realloc_count      = atomic_load_explicit(&t->realloc_count, memory_order_relaxed);
+  stats.bytes_in_use       = atomic_load_explicit(&t->bytes_in_use, memory_order_relaxed);
+  stats.peak_bytes_in_use  = atomic_load_explicit(&t->peak_bytes_in_use, memory_order_relaxed);
+  for (usize i = 0; i < YORU_TRACKING_HISTOGRAM_BUCKETS; ++i) {
+    stats.histogram[i] = atomic_load_explicit(&t->histogram[i], memory_order_relaxed);
+  }
+  return stats;
+}
+
+void yoru_tracking_allocator_report(Yoru_TrackingAllocator *allocator, FILE *out) {
+  assert(out && "must not be null");
+  Yoru_TrackingStats stats = yoru_tracking_allocator_get_stats(allocator);
+
+  fprintf(out, "[%s]\n", stats.tag);
+  fprintf(
+      out,
+      "  allocs: %zu, deallocs: %zu, reallocs: %zu\n",
+      stats.alloc_count,
+      stats.dealloc_count,
+      stats.realloc_count);
+  fprintf(
+      out,
+      "  in use: %zu bytes in %zu allocations, peak: %zu bytes\n",
+      stats.bytes_in_use,
+      stats.alloc_count - stats.dealloc_count,
+      stats.peak_bytes_in_use);
+  fprintf(out, "  sizes:\n");
+  usize class_size = YORU_TRACKING_HISTOGRAM_MIN_SIZE;
+  for (usize i = 0; i < YORU_TRACKING_HISTOGRAM_BUCKETS; ++i, class_size <<= 1) {
+    if (!stats.histogram[i]) continue;
+    if (i == YORU_TRACKING_HISTOGRAM_BUCKETS - 1) {
+      fprintf(out, "    >  %8zu: %zu\n", class_size >> 1, stats.histogram[i]);
+    } else {
+      fprintf(out, "    <= %8zu: %zu\n", class_size, stats.histogram[i]);
+    }
+  }
+}
+#endif // YORU_IMPL
+
+/* ============================================================
+   MODULE: ArrayList
+   provides an interface to create dynamic arrays by for example
+   creating a new typedef for your ArrayList type or add
+   it as a field in a struct:
+   ```c
+   typedef Yoru_ArrayList_T(int) IntArrayList;
+
+   // ... oooor you could also just add it as a field inside a struct,
+   // typedef struct {
+   //   Yoru_ArrayList_T(int) values;
+   // } OtherIntArrayList;
+
+   void my_func() {
+     Yoru_Allocator allocator = yoru_global_allocator_make();
+     IntArrayList xs = {0};
+
+     // you can just pass 0 as initial capacity and it will use the default
+     yoru_arraylist_init(&xs, &allocator, 16);
+     for (usize i = 0; i < 128; ++i) {
+       yoru_arraylist_append(&xs, i);
+     }
+
+     // do something
+
+     yoru_arraylist_destroy(&xs); // destroys arraylist with allocator that
+   `owns` it
+   }
+   ```
+
+   TODO:
+     - find a way to handle errors better
+   ============================================================ */
+
+#define YORU_ARRAYLIST_INITIAL_CAPACITY (16)
+
+#define Yoru_ArrayList_T(__T)                                                                                          \
+  struct {                                                                                                             \
+    __T            *items;                                                                                             \
+    usize           size, capacity;                                                                                    \
+    Yoru_Allocator *allocator;                                                                                         \
+  }
+
+#define yoru_arraylist_init_with(__kind, __arr_ptr, __allocator_ptr, __capacity)                                       \
+  do {                                                                                                                 \
+    usize    initial_capacity = ((__capacity) == 0) ? YORU_ARRAYLIST_INITIAL_CAPACITY : (__capacity);                  \
+    Yoru_Opt maybe_items      = yoru_allocator_alloc_uninit_with(                                                      \
+        __kind,                                                                                                        \
+        (__allocator_ptr),                                                                                             \
+        initial_capacity * sizeof((__arr_ptr)->items[0]));                                                             \
+    assert(maybe_items.has_value && "could not allocate memory for arraylist");                                        \
+    (__arr_ptr)->items     = maybe_items.ptr;                                                                          \
+    (__arr_ptr)->size      = 0;                                                                                        \
+    (__arr_ptr)->capacity  = initial_capacity;                                                                         \
+    (__arr_ptr)->allocator = __allocator_ptr;                                                                          \
+  } while (0);
+
+#define yoru_arraylist_init(__arr_ptr, __allocator_ptr, __capacity)                                                    \
+  yoru_arraylist_init_with(dynamic, __arr_ptr, __allocator_ptr, __capacity)
+
+#define yoru_arraylist_append_with(__kind, __arr_ptr, __value)                                                         \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    if ((__arr_ptr)->size + 1 > (__arr_ptr)->capacity) {                                                               \
+      yoru_arraylist_resize_with(__kind, (__arr_ptr), (__arr_ptr)->capacity * 2);                                      \
+    }                                                                                                                  \
+    (__arr_ptr)->items[(__arr_ptr)->size++] = (__value);                                                               \
+  } while (0);
+
+#define yoru_arraylist_append(__arr_ptr, __value)                                                                      \
+  yoru_arraylist_append_with(dynamic, __arr_ptr, __value)
+
+#define yoru_arraylist_destroy_with(__kind, __arr_ptr)                                                                 \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    if (!(__arr_ptr)->items) {                                                                                         \
+      yoru_allocator_dealloc_with(__kind, (__arr_ptr)->allocator, (__arr_ptr)->items);                                 \
+      (__arr_ptr)->items = NULL;                                                                                       \
+    }                                                                                                                  \
+    (__arr_ptr)->size      = 0;                                                                                        \
+    (__arr_ptr)->capacity  = 0;                                                                                        \
+    (__arr_ptr)->allocator = NULL;                                                                                     \
+  } while (0)
+
+#define yoru_arraylist_destroy(__arr_ptr)                                                                              \
+  yoru_arraylist_destroy_with(dynamic, __arr_ptr)
+
+/// sets every slot up to the capacity to `__value` and makes the list full.
+/// The slots above the old size are written too, since `init` leaves them
+/// uninitialized
+#define yoru_arraylist_fill(__arr_ptr, __value)                                                                        \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    assert((__arr_ptr)->items);                                                                                        \
+    for (usize __i = 0; __i < (__arr_ptr)->capacity; ++__i) {                                                          \
+      (__arr_ptr)->items[__i] = __value;                                                                               \
+    }                                                                                                                  \
+    (__arr_ptr)->size = (__arr_ptr)->capacity;                                                                         \
+  } while (0);
+
+#define yoru_arraylist_clear(__arr_ptr)                                                                                \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    assert((__arr_ptr)->items);                                                                                        \
+    memset((__arr_ptr)->items, 0, (__arr_ptr)->capacity * sizeof((__arr_ptr)->items[0]));                              \
+    (__arr_ptr)->size = 0;                                                                                             \
+  } while (0)
+
+#define yoru_arraylist_prepend_with(__kind, __arr_ptr, __value)                                                        \
+  do {                                                                                                                 \
+    usize item_size = sizeof((__arr_ptr)->items[0]);                                                                   \
+    assert((__arr_ptr));                                                                                               \
+    if ((__arr_ptr)->size + 1 > (__arr_ptr)->capacity) {                                                               \
+      yoru_arraylist_resize_with(__kind, (__arr_ptr), (__arr_ptr)->capacity * 2);                                      \
+    }                                                                                                                  \
+    memmove((__arr_ptr)->items + 1, (__arr_ptr)->items, (__arr_ptr)->size * item_size);                                \
+    (__arr_ptr)->items[0] = __value;                                                                                   \
+    ++(__arr_ptr)->size;                                                                                               \
+  } while (0);
+
+#define yoru_arraylist_prepend(__arr_ptr, __value)                                                                     \
+  yoru_arraylist_prepend_with(dynamic, __arr_ptr, __value)
+
+#define yoru_arraylist_resize_with(__kind, __arr_ptr, __new_capacity)                                                  \
+  do {                                                                                                                 \
+    usize item_size = sizeof((__arr_ptr)->items[0]);                                                                   \
+    assert((__arr_ptr));                                                                                               \
+    Yoru_Opt maybe_new_ptr = yoru_allocator_realloc_with(                                                              \
+        __kind,                                                                                                        \
+        (__arr_ptr)->allocator,                                                                                        \
+        (__arr_ptr)->capacity * item_size,                                                                             \
+        (__arr_ptr)->items,                                                                                            \
+        (__new_capacity) * item_size);                                                                                 \
+    assert(maybe_new_ptr.has_value && "could not append new value");                                                   \
+    anyptr new_ptr        = maybe_new_ptr.ptr;                                                                         \
+    (__arr_ptr)->items    = new_ptr;                                                                                   \
+    (__arr_ptr)->size     = (__arr_ptr)->size < (__new_capacity) ? (__arr_ptr)->size : (__new_capacity);               \
+    (__arr_ptr)->capacity = (__new_capacity);                                                                          \
+  } while (0);
+
+#define yoru_arraylist_resize(__arr_ptr, __new_capacity)                                                               \
+  yoru_arraylist_resize_with(dynamic, __arr_ptr, __new_capacity)
+
+/// grows the capacity to exactly `__min_capacity` with a single reallocation
+/// if it is smaller, so filling a list of known size does not double and copy
+/// its way up. Never shrinks
+#define yoru_arraylist_reserve_with(__kind, __arr_ptr, __min_capacity)                                                 \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    usize reserve_capacity = (__min_capacity);                                                                         \
+    if ((__arr_ptr)->capacity < reserve_capacity) {                                                                    \
+      yoru_arraylist_resize_with(__kind, (__arr_ptr), reserve_capacity);                                               \
+    }                                                                                                                  \
+  } while (0)
+
+#define yoru_arraylist_reserve(__arr_ptr, __min_capacity)                                                              \
+  yoru_arraylist_reserve_with(dynamic, __arr_ptr, __min_capacity)
+
+/// releases the capacity above the size. At least one item is kept, so
+/// appending can keep doubling the capacity
+#define yoru_arraylist_shrink_to_fit_with(__kind, __arr_ptr)                                                           \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    usize fitting_capacity = (__arr_ptr)->size > 0 ? (__arr_ptr)->size : 1;                                            \
+    if ((__arr_ptr)->capacity > fitting_capacity) {                                                                    \
+      yoru_arraylist_resize_with(__kind, (__arr_ptr), fitting_capacity);                                               \
+    }                                                                                                                  \
+  } while (0)
+
+#define yoru_arraylist_shrink_to_fit(__arr_ptr)                                                                        \
+  yoru_arraylist_shrink_to_fit_with(dynamic, __arr_ptr)
+
+/// makes room for `__needed` items in total, at least doubling the capacity
+/// so repeated bulk appends stay amortized
+#define __yoru_arraylist_ensure_with(__kind, __arr_ptr, __needed)                                                      \
+  do {                                                                                                                 \
+    usize needed_capacity = (__needed);                                                                                \
+    if (needed_capacity > (__arr_ptr)->capacity) {                                                                     \
+      usize doubled_capacity = (__arr_ptr)->capacity * 2;                                                              \
+      yoru_arraylist_resize_with(                                                                                      \
+          __kind,                                                                                                      \
+          (__arr_ptr),                                                                                                 \
+          needed_capacity > doubled_capacity ? needed_capacity : doubled_capacity);                                    \
+    }                                                                                                                  \
+  } while (0)
+
+/// appends `__count` items from the array `__items` with at most one
+/// reallocation and a single copy. `__items` must not point into the list
+#define yoru_arraylist_append_many_with(__kind, __arr_ptr, __items, __count)                                           \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    static_assert(sizeof((__arr_ptr)->items[0]) == sizeof((__items)[0]), "item types must match");                     \
+    usize append_item_size = sizeof((__arr_ptr)->items[0]);                                                            \
+    usize append_count     = (__count);                                                                                \
+    if (append_count == 0) break;                                                                                      \
+    /* checked once up front, so the byte count below can not overflow */                                              \
+    bool append_fits = append_count <= USIZE_MAX / append_item_size - (__arr_ptr)->size;                               \
+    assert(append_fits && "too many items to append");                                                                 \
+    if (!append_fits) break;                                                                                           \
+    __yoru_arraylist_ensure_with(__kind, (__arr_ptr), (__arr_ptr)->size + append_count);                               \
+    u8   *append_dst   = (u8 *)((__arr_ptr)->items + (__arr_ptr)->size);                                               \
+    usize append_bytes = append_count * append_item_size;                                                              \
+    memcpy(append_dst, (__items), append_bytes);                                                                       \
+    (__arr_ptr)->size += append_count;                                                                                 \
+  } while (0)
+
+#define yoru_arraylist_append_many(__arr_ptr, __items, __count)                                                        \
+  yoru_arraylist_append_many_with(dynamic, __arr_ptr, __items, __count)
+
+/// appends all items of the arraylist `__other_ptr`, which must be another list
+#define yoru_arraylist_extend_with(__kind, __arr_ptr, __other_ptr)                                                     \
+  do {                                                                                                                 \
+    assert((__other_ptr));                                                                                             \
+    yoru_arraylist_append_many_with(__kind, (__arr_ptr), (__other_ptr)->items, (__other_ptr)->size);                   \
+  } while (0)
+
+#define yoru_arraylist_extend(__arr_ptr, __other_ptr)                                                                  \
+  yoru_arraylist_extend_with(dynamic, __arr_ptr, __other_ptr)
+
+/// inserts `__count` items from `__items` before `__index` (which may be the
+/// size to append), moving the tail once. `__items` must not point into the list
+#define yoru_arraylist_insert_range_with(__kind, __arr_ptr, __index, __items, __count)                                 \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    static_assert(sizeof((__arr_ptr)->items[0]) == sizeof((__items)[0]), "item types must match");                     \
+    usize item_size    = sizeof((__arr_ptr)->items[0]);                                                                \
+    usize insert_at    = (__index);                                                                                    \
+    usize insert_count = (__count);                                                                                    \
+    assert(insert_at <= (__arr_ptr)->size && "index out of bounds");                                                   \
+    if (insert_count == 0) break;                                                                                      \
+    /* checked once up front, so the byte counts below can not overflow */                                             \
+    bool insert_fits = insert_count <= USIZE_MAX / item_size - (__arr_ptr)->size;                                      \
+    assert(insert_fits && "too many items to insert");                                                                 \
+    if (!insert_fits) break;                                                                                           \
+    __yoru_arraylist_ensure_with(__kind, (__arr_ptr), (__arr_ptr)->size + insert_count);                               \
+    memmove(                                                                                                           \
+        (__arr_ptr)->items + insert_at + insert_count,                                                                 \
+        (__arr_ptr)->items + insert_at,                                                                                \
+        ((__arr_ptr)->size - insert_at) * item_size);                                                                  \
+    memcpy((__arr_ptr)->items + insert_at, (__items), insert_count * item_size);                                       \
+    (__arr_ptr)->size += insert_count;                                                                                 \
+  } while (0)
+
+#define yoru_arraylist_insert_range(__arr_ptr, __index, __items, __count)                                              \
+  yoru_arraylist_insert_range_with(dynamic, __arr_ptr, __index, __items, __count)
+
+/// removes the `__count` items starting at `__index`, keeping the order of the
+/// remaining ones. The capacity stays the same
+#define yoru_arraylist_remove_range(__arr_ptr, __index, __count)                                                       \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    usize remove_at    = (__index);                                                                                    \
+    usize remove_count = (__count);                                                                                    \
+    assert(remove_at <= (__arr_ptr)->size && remove_count <= (__arr_ptr)->size - remove_at && "out of bounds");        \
+    memmove(                                                                                                           \
+        (__arr_ptr)->items + remove_at,                                                                                \
+        (__arr_ptr)->items + remove_at + remove_count,                                                                 \
+        ((__arr_ptr)->size - remove_at - remove_count) * sizeof((__arr_ptr)->items[0]));                               \
+    (__arr_ptr)->size -= remove_count;                                                                                 \
+  } while (0)
+
+/// removes the item at `__index` in O(1) by moving the last item into its
+/// place, so the order is not kept
+#define yoru_arraylist_swap_remove(__arr_ptr, __index)                                                                 \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    usize remove_at = (__index);                                                                                       \
+    assert(remove_at < (__arr_ptr)->size && "index out of bounds");                                                    \
+    (__arr_ptr)->items[remove_at] = (__arr_ptr)->items[--(__arr_ptr)->size];                                           \
+  } while (0)
+
+/* ============================================================
+   MODULE: SmallArrayList
+   provides an ArrayList that keeps up to N items inline in the
+   struct and only allocates once it grows past them, for the
+   many lists that stay tiny:
+   ```c
+   Yoru_Allocator allocator = yoru_global_allocator_make();
+   Yoru_SmallArrayList_T(int, 8) xs = {0};
+   yoru_small_arraylist_init(&xs, &allocator);
+
+   yoru_small_arraylist_append(&xs, 1); // no allocation yet
+   int first = yoru_small_arraylist_items(&xs)[0];
+
+   yoru_small_arraylist_destroy(&xs);
+   ```
+
+   The list does not point into itself, so it can be moved like
+   any other struct. That's why the items are reached through
+   `yoru_small_arraylist_items` instead of a field. Copies are
+   only fine while the items are inline: once the list spilled,
+   a copy shares the heap buffer with the original, so both
+   would write into it and free it. Move a spilled list, i.e.
+   stop using the old one, instead of copying it.
+   ============================================================ */
+
+#define Yoru_SmallArrayList_T(__T, __N)                                                                                \
+  struct {                                                                                                             \
+    __T            *heap; /* NULL while the items are inline */                                                        \
+    usize           size, capacity;                                                                                    \
+    Yoru_Allocator *allocator;                                                                                         \
+    __T             inline_items[__N];                                                                                 \
+  }
+
+/// the number of items that fit inline
+#define yoru_small_arraylist_inline_capacity(__arr_ptr)                                                                \
+  (sizeof((__arr_ptr)->inline_items) / sizeof((__arr_ptr)->inline_items[0]))
+
+/// pointer to the first item, wherever the items currently live
+#define yoru_small_arraylist_items(__arr_ptr) ((__arr_ptr)->heap ? (__arr_ptr)->heap : (__arr_ptr)->inline_items)
+
+#define yoru_small_arraylist_is_inline(__arr_ptr) ((__arr_ptr)->heap == NULL)
+
+/// nothing is allocated until the inline items are full
+#define yoru_small_arraylist_init(__arr_ptr, __allocator_ptr)                                                          \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    (__arr_ptr)->heap      = NULL;                                                                                     \
+    (__arr_ptr)->size      = 0;                                                                                        \
+    (__arr_ptr)->capacity  = yoru_small_arraylist_inline_capacity(__arr_ptr);                                          \
+    (__arr_ptr)->allocator = __allocator_ptr;                                                                          \
+  } while (0)
+
+/// moves the items to the allocator when `__new_capacity` does not fit inline,
+/// and back inline (freeing the allocation) when it does
+#define yoru_small_arraylist_resize_with(__kind, __arr_ptr, __new_capacity)                                            \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    usize item_size       = sizeof((__arr_ptr)->inline_items[0]);                                                      \
+    usize inline_capacity = yoru_small_arraylist_inline_capacity(__arr_ptr);                                           \
+    usize new_capacity    = (__new_capacity);                                                                          \
+    usize kept_size       = (__arr_ptr)->size < new_capacity ? (__arr_ptr)->size : new_capacity;                       \
+    if (new_capacity <= inline_capacity) {                                                                             \
+      if ((__arr_ptr)->heap) {                                                                                         \
+        memcpy((__arr_ptr)->inline_items, (__arr_ptr)->heap, kept_size * item_size);                                   \
+        yoru_allocator_dealloc_with(__kind, (__arr_ptr)->allocator, (__arr_ptr)->heap);                                \
+        (__arr_ptr)->heap = NULL;                                                                                      \
+      }                                                                                                                \
+      new_capacity = inline_capacity;                                                                                  \
+    } else if ((__arr_ptr)->heap) {                                                                                    \
+      Yoru_Opt maybe_new_ptr = yoru_allocator_realloc_with(                                                            \
+          __kind,                                                                                                      \
+          (__arr_ptr)->allocator,                                                                                      \
+          (__arr_ptr)->capacity * item_size,                                                                           \
+          (__arr_ptr)->heap,                                                                                           \
+          new_capacity * item_size);                                                                                   \
+      assert(maybe_new_ptr.has_value && "could not resize small arraylist");                                           \
+      (__arr_ptr)->heap = maybe_new_ptr.ptr;                                                                           \
+    } else {                                                                                                           \
+      Yoru_Opt maybe_new_ptr =                                                                                         \
+          yoru_allocator_alloc_uninit_with(__kind, (__arr_ptr)->allocator, new_capacity * item_size);                  \
+      assert(maybe_new_ptr.has_value && "could not resize small arraylist");                                           \
+      memcpy(maybe_new_ptr.ptr, (__arr_ptr)->inline_items, kept_size * item_size);                                     \
+      (__arr_ptr)->heap = maybe_new_ptr.ptr;                                                                           \
+    }                                                                                                                  \
+    (__arr_ptr)->size     = kept_size;                                                                                 \
+    (__arr_ptr)->capacity = new_capacity;                                                                              \
+  } while (0)
+
+#define yoru_small_arraylist_resize(__arr_ptr, __new_capacity)                                                         \
+  yoru_small_arraylist_resize_with(dynamic, __arr_ptr, __new_capacity)
+
+#define yoru_small_arraylist_append_with(__kind, __arr_ptr, __value)                                                   \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    if ((__arr_ptr)->size + 1 > (__arr_ptr)->capacity) {                                                               \
+      yoru_small_arraylist_resize_with(__kind, (__arr_ptr), (__arr_ptr)->capacity * 2);                                \
+    }                                                                                                                  \
+    yoru_small_arraylist_items(__arr_ptr)[(__arr_ptr)->size++] = (__value);                                            \
+  } while (0)
+
+#define yoru_small_arraylist_append(__arr_ptr, __value) yoru_small_arraylist_append_with(dynamic, __arr_ptr, __value)
+
+/// frees the allocation if the items spilled, the list is empty and inline
+/// afterwards and can be reused
+#define yoru_small_arraylist_destroy_with(__kind, __arr_ptr)                                                           \
+  do {                                                                                                                 \
+    assert((__arr_ptr));                                                                                               \
+    if ((__arr_ptr)->heap) yoru_allocator_dealloc_with(__kind, (__arr_ptr)->allocator, (__arr_ptr)->heap);             \
+    (__arr_ptr)->heap     = NULL;                                                                                      \
+    (__arr_ptr)->size     = 0;                                                                                         \
+    (__arr_ptr)->capacity = yoru_small_arraylist_inline_capacity(__arr_ptr);                                           \
+  } while (0)
+
+#define yoru_small_arraylist_destroy(__arr_ptr) yoru_small_arraylist_destroy_with(dynamic, __arr_ptr)
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
+/* ============================================================
+   MODULE: VirtualArrayList
+   provides an ArrayList that reserves address space for its
+   maximum capacity up front and grows by committing more pages
+   of it, so growing never copies and pointers to the items stay
+   valid for the lifetime of the list:
+   ```c
+   Yoru_VirtualArrayList_T(Event) log = {0};
+   yoru_virtual_arraylist_init(&log, 1ull << 32); // only address space
+
+   for (;;) {
+     yoru_virtual_arraylist_append(&log, next_event());
+   }
+
+   yoru_virtual_arraylist_destroy(&log);
+   ```
+
+   Makes use of the VirtualMemory module and therefore is only
+   supported by platforms where the VirtualMemory module
+   is defined.
+   ============================================================ */
+
+/// @brief size of the first commit of a `VirtualArrayList`, every following
+/// one doubles the committed size
+#  define YORU_VIRTUAL_ARRAYLIST_MIN_COMMIT_SIZE (YORU_KiB(64))
+
+#  define Yoru_VirtualArrayList_T(__T)                                                                                 \
+    struct {                                                                                                           \
+      __T          *items;                                                                                             \
+      usize         size, capacity; /* the capacity is what is committed */                                            \
+      Yoru_Vmem_Ctx vmem;                                                                                              \
+    }
+
+/// @brief commits more of the reservation behind a `VirtualArrayList` so at
+/// least `needed` bytes are usable, at least doubling what is committed.
+/// Returns false if the reservation is too small
+bool __yoru_virtual_arraylist_commit(Yoru_Vmem_Ctx *vmem, usize needed);
+
+/// reserves room for `__max_capacity` items without committing any of it
+#  define yoru_virtual_arraylist_init(__arr_ptr, __max_capacity)                                                       \
+    do {                                                                                                               \
+      assert((__arr_ptr));                                                                                             \
+      usize reserve_size = yoru_align_up((__max_capacity) * sizeof((__arr_ptr)->items[0]), yoru_get_page_size());      \
+      bool  reserved     = yoru_vmem_reserve(reserve_size, &(__arr_ptr)->vmem);                                        \
+      assert(reserved && "could not reserve memory for virtual arraylist");                                            \
+      (void)reserved;                                                                                                  \
+      (__arr_ptr)->items    = (__arr_ptr)->vmem.base;                                                                  \
+      (__arr_ptr)->size     = 0;                                                                                       \
+      (__arr_ptr)->capacity = 0;                                                                                       \
+    } while (0)
+
+/// commits room for at least `__min_capacity` items
+#  define yoru_virtual_arraylist_reserve(__arr_ptr, __min_capacity)                                                    \
+    do {                                                                                                               \
+      assert((__arr_ptr));                                                                                             \
+      usize item_size    = sizeof((__arr_ptr)->items[0]);                                                              \
+      usize min_capacity = (__min_capacity);                                                                           \
+      if (min_capacity > (__arr_ptr)->capacity) {                                                                      \
+        bool committed = __yoru_virtual_arraylist_commit(&(__arr_ptr)->vmem, min_capacity * item_size);                \
+        assert(committed && "virtual arraylist is full");                                                              \
+        (void)committed;                                                                                               \
+        (__arr_ptr)->capacity = (__arr_ptr)->vmem.commit_pos / item_size;                                              \
+      }                                                                                                                \
+    } while (0)
+
+#  define yoru_virtual_arraylist_append(__arr_ptr, __value)                                                            \
+    do {                                                                                                               \
+      assert((__arr_ptr));                                                                                             \
+      if ((__arr_ptr)->size + 1 > (__arr_ptr)->capacity) {                                                             \
+        yoru_virtual_arraylist_reserve((__arr_ptr), (__arr_ptr)->size + 1);                                            \
+      }                                                                                                                \
+      (__arr_ptr)->items[(__arr_ptr)->size++] = (__value);                                                             \
+    } while (0)
+
+/// appends `__count` items from the array `__items` with a single copy
+#  define yoru_virtual_arraylist_append_many(__arr_ptr, __items, __count)                                              \
+    do {                                                                                                               \
+      assert((__arr_ptr));                                                                                             \
+      static_assert(sizeof((__arr_ptr)->items[0]) == sizeof((__items)[0]), "item types must match");                   \
+      usize append_count = (__count);                                                                                  \
+      yoru_virtual_arraylist_reserve((__arr_ptr), (__arr_ptr)->size + append_count);                                   \
+      memcpy((__arr_ptr)->items + (__arr_ptr)->size, (__items), append_count * sizeof((__arr_ptr)->items[0]));         \
+      (__arr_ptr)->size += append_count;                                                                               \
+    } while (0)
+
+/// hands the committed pages above the size back to the OS. The items stay
+/// where they are and the list can grow into the pages again
+#  define yoru_virtual_arraylist_shrink_to_fit(__arr_ptr)                                                              \
+    do {                                                                                                               \
+      assert((__arr_ptr));                                                                                             \
+      usize item_size = sizeof((__arr_ptr)->items[0]);                                                                 \
+      usize used      = (__arr_ptr)->size * item_size;                                                                 \
+      if ((__arr_ptr)->vmem.commit_pos > used) {                                                                       \
+        yoru_vmem_decommit(&(__arr_ptr)->vmem, (__arr_ptr)->vmem.commit_pos - used, YORU_VMEM_DECOMMIT_NONE);          \
+        (__arr_ptr)->capacity = (__arr_ptr)->vmem.commit_pos / item_size;                                              \
+      }                                                                                                                \
+    } while (0)
+
+/// releases the whole reservation, the items must not be used afterwards
+#  define yoru_virtual_arraylist_destroy(__arr_ptr)                                                                    \
+    do {                                                                                                               \
+      assert((__arr_ptr));                                                                                             \
+      if ((__arr_ptr)->vmem.base) yoru_vmem_free(&(__arr_ptr)->vmem);                                                  \
+      (__arr_ptr)->items    = NULL;                                                                                    \
+      (__arr_ptr)->size     = 0;                                                                                       \
+      (__arr_ptr)->capacity = 0;                                                                                       \
+    } while (0)
+
+#  ifdef YORU_IMPL
+bool __yoru_virtual_arraylist_commit(Yoru_Vmem_Ctx *vmem, usize needed) {
+  assert(vmem && "must not be null");
+  if (needed <= vmem->commit_pos) return true;
+  if (needed > vmem->addr_space_size) return false;
+
+  usize step      = needed - vmem->commit_pos;
+  usize remaining = vmem->addr_space_size - vmem->commit_pos;
+  if (step < vmem->commit_pos) step = vmem->commit_pos;
+  if (step < YORU_VIRTUAL_ARRAYLIST_MIN_COMMIT_SIZE) step = YORU_VIRTUAL_ARRAYLIST_MIN_COMMIT_SIZE;
+  if (step > remaining) step = remaining;
+  return yoru_vmem_commit(vmem, step);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
+
+/* ============================================================
+   MODULE: Deque
+   provides a typesafe double ended queue in a ring buffer, so
+   pushing and popping at both ends is O(1), e.g. for a FIFO:
+   ```c
+   Yoru_Allocator allocator = yoru_global_allocator_make();
+   Yoru_Deque_T(Job) jobs   = {0};
+   yoru_deque_init(&jobs, &allocator, 0);
+
+   yoru_deque_push_back(&jobs, job);
+   while (!yoru_deque_is_empty(&jobs)) {
+     Job next;
+     yoru_deque_pop_front(&jobs, &next);
+     // ...
+   }
+
+   yoru_deque_destroy(&jobs);
+   ```
+
+   The capacity is always a power of two, so wrapping around the
+   end of the buffer is a mask instead of a division.
+   ============================================================ */
+
+#define YORU_DEQUE_INITIAL_CAPACITY (16)
+
+#define Yoru_Deque_T(__T)                                                                                              \
+  struct {                                                                                                             \
+    __T            *items;                                                                                             \
+    usize           head; /* index of the front item in items */                                                       \
+    usize           size, capacity;                                                                                    \
+    Yoru_Allocator *allocator;                                                                                         \
+  }
+
+/// @brief copies `count` items from `src` into the ring `items` starting at
+/// slot `start`, with at most two memcpys
+void __yoru_deque_copy_in(u8 *items, usize item_size, usize capacity, usize start, const u8 *src, usize count);
+
+/// @brief copies `count` items from the ring `items` starting at slot `start`
+/// to `dst`, with at most two memcpys
+void __yoru_deque_copy_out(const u8 *items, usize item_size, usize capacity, usize start, u8 *dst, usize count);
+
+/// @brief fixes up the items after the buffer grew from `old_capacity`: the
+/// part that wrapped around is moved behind the old end
+void __yoru_deque_unwrap(u8 *items, usize item_size, usize head, usize size, usize old_capacity);
+
+/// the item `__index` positions behind the front, usable as an lvalue
+#define yoru_deque_at(__deque_ptr, __index)                                                                            \
+  ((__deque_ptr)->items[((__deque_ptr)->head + (__index)) & ((__deque_ptr)->capacity - 1)])
+
+#define yoru_deque_is_empty(__deque_ptr) ((__deque_ptr)->size == 0)
+
+/// `__capacity` is rounded up to a power of two, 0 uses the default
+#define yoru_deque_init_with(__kind, __deque_ptr, __allocator_ptr, __capacity)                                         \
+  do {                                                                                                                 \
+    usize initial_capacity = ((__capacity) == 0) ? YORU_DEQUE_INITIAL_CAPACITY : (__capacity);                         \
+    initial_capacity       = yoru_next_power_of_two(initial_capacity);                                                 \
+    Yoru_Opt maybe_items   = yoru_allocator_alloc_uninit_with(                                                         \
+        __kind,                                                                                                        \
+        (__allocator_ptr),                                                                                             \
+        initial_capacity * sizeof((__deque_ptr)->items[0]));                                                           \
+    assert(maybe_items.has_value && "could not allocate memory for deque");                                            \
+    (__deque_ptr)->items     = maybe_items.ptr;                                                                        \
+    (__deque_ptr)->head      = 0;                                                                                      \
+    (__deque_ptr)->size      = 0;                                                                                      \
+    (__deque_ptr)->capacity  = initial_capacity;                                                                       \
+    (__deque_ptr)->allocator = __allocator_ptr;                                                                        \
+  } while (0)
+
+#define yoru_deque_init(__deque_ptr, __allocator_ptr, __capacity)                                                      \
+  yoru_deque_init_with(dynamic, __deque_ptr, __allocator_ptr, __capacity)
+
+/// doubles the capacity until `__needed` items fit
+#define __yoru_deque_ensure_with(__kind, __deque_ptr, __needed)                                                        \
+  do {                                                                                                                 \
+    usize needed_capacity = (__needed);                                                                                \
+    if (needed_capacity > (__deque_ptr)->capacity) {                                                                   \
+      usize    item_size     = sizeof((__deque_ptr)->items[0]);                                                        \
+      usize    old_capacity  = (__deque_ptr)->capacity;                                                                \
+      usize    new_capacity  = yoru_next_power_of_two(needed_capacity);                                                \
+      Yoru_Opt maybe_new_ptr = yoru_allocator_realloc_with(                                                            \
+          __kind,                                                                                                      \
+          (__deque_ptr)->allocator,                                                                                    \
+          old_capacity * item_size,                                                                                    \
+          (__deque_ptr)->items,                                                                                        \
+          new_capacity * item_size);                                                                                   \
+      assert(maybe_new_ptr.has_value && "could not grow deque");                                                       \
+      (__deque_ptr)->items    = maybe_new_ptr.ptr;                                                                     \
+      (__deque_ptr)->capacity = new_capacity;                                                                          \
+      __yoru_deque_unwrap(                                                                                             \
+          (u8 *)(__deque_ptr)->items,                                                                                  \
+          item_size,                                                                                                   \
+          (__deque_ptr)->head,                                                                                         \
+          (__deque_ptr)->size,                                                                                         \
+          old_capacity);                                                                                               \
+    }                                                                                                                  \
+  } while (0)
+
+#define yoru_deque_push_back_with(__kind, __deque_ptr, __value)                                                        \
+  do {                                                                                                                 \
+    assert((__deque_ptr));                                                                                             \
+    __yoru_deque_ensure_with(__kind, (__deque_ptr), (__deque_ptr)->size + 1);                                          \
+    yoru_deque_at((__deque_ptr), (__deque_ptr)->size) = (__value);                                                     \
+    ++(__deque_ptr)->size;                                                                                             \
+  } while (0)
+
+#define yoru_deque_push_back(__deque_ptr, __value) yoru_deque_push_back_with(dynamic, __deque_ptr, __value)
+
+#define yoru_deque_push_front_with(__kind, __deque_ptr, __value)                                                       \
+  do {                                                                                                                 \
+    assert((__deque_ptr));                                                                                             \
+    __yoru_deque_ensure_with(__kind, (__deque_ptr), (__deque_ptr)->size + 1);                                          \
+    (__deque_ptr)->head = ((__deque_ptr)->head - 1) & ((__deque_ptr)->capacity - 1);                                   \
+    (__deque_ptr)->items[(__deque_ptr)->head] = (__value);                                                             \
+    ++(__deque_ptr)->size;                                                                                             \
+  } while (0)
+
+#define yoru_deque_push_front(__deque_ptr, __value) yoru_deque_push_front_with(dynamic, __deque_ptr, __value)
+
+/// removes the front item and stores it in `*__out_value_ptr`
+#define yoru_deque_pop_front(__deque_ptr, __out_value_ptr)                                                             \
+  do {                                                                                                                 \
+    assert((__deque_ptr));                                                                                             \
+    assert((__deque_ptr)->size > 0 && "deque is empty");                                                               \
+    *(__out_value_ptr)  = (__deque_ptr)->items[(__deque_ptr)->head];                                                   \
+    (__deque_ptr)->head = ((__deque_ptr)->head + 1) & ((__deque_ptr)->capacity - 1);                                   \
+    --(__deque_ptr)->size;                                                                                             \
+  } while (0)
+
+/// removes the back item and stores it in `*__out_value_ptr`
+#define yoru_deque_pop_back(__deque_ptr, __out_value_ptr)                                                              \
+  do {                                                                                                                 \
+    assert((__deque_ptr));                                                                                             \
+    assert((__deque_ptr)->size > 0 && "deque is empty");                                                               \
+    *(__out_value_ptr) = yoru_deque_at((__deque_ptr), (__deque_ptr)->size - 1);                                        \
+    --(__deque_ptr)->size;                                                                                             \
+  } while (0)
+
+/// pushes `__count` items from the array `__items` to the back, growing at
+/// most once
+#define yoru_deque_push_back_many_with(__kind, __deque_ptr, __items, __count)                                          \
+  do {                                                                                                                 \
+    assert((__deque_ptr));                                                                                             \
+    static_assert(sizeof((__deque_ptr)->items[0]) == sizeof((__items)[0]), "item types must match");                   \
+    usize push_count = (__count);                                                                                      \
+    __yoru_deque_ensure_with(__kind, (__deque_ptr), (__deque_ptr)->size + push_count);                                 \
+    __yoru_deque_copy_in(                                                                                              \
+        (u8 *)(__deque_ptr)->items,                                                                                    \
+        sizeof((__deque_ptr)->items[0]),                                                                               \
+        (__deque_ptr)->capacity,                                                                                       \
+        ((__deque_ptr)->head + (__deque_ptr)->size) & ((__deque_ptr)->capacity - 1),                                   \
+        (const u8 *)(__items),                                                                                         \
+        push_count);                                                                                                   \
+    (__deque_ptr)->size += push_count;                                                                                 \
+  } while (0)
+
+#define yoru_deque_push_back_many(__deque_ptr, __items, __count)                                                       \
+  yoru_deque_push_back_many_with(dynamic, __deque_ptr, __items, __count)
+
+/// pops up to `__max_count` items from the front into the array `__out_items`
+/// and stores how many that were in `*__out_count_ptr`
+#define yoru_deque_pop_front_many(__deque_ptr, __out_items, __max_count, __out_count_ptr)                              \
+  do {                                                                                                                 \
+    assert((__deque_ptr));                                                                                             \
+    static_assert(sizeof((__deque_ptr)->items[0]) == sizeof((__out_items)[0]), "item types must match");               \
+    usize pop_count = (__max_count) < (__deque_ptr)->size ? (__max_count) : (__deque_ptr)->size;                       \
+    __yoru_deque_copy_out(                                                                                             \
+        (const u8 *)(__deque_ptr)->items,                                                                              \
+        sizeof((__deque_ptr)->items[0]),                                                                               \
+        (__deque_ptr)->capacity,                                                                                       \
+        (__deque_ptr)->head,                                                                                           \
+        (u8 *)(__out_items),                                                                                           \
+        pop_count);                                                                                                    \
+    (__deque_ptr)->head = ((__deque_ptr)->head + pop_count) & ((__deque_ptr)->capacity - 1);                           \
+    (__deque_ptr)->size -= pop_count;                                                                                  \
+    *(__out_count_ptr) = pop_count;                                                                                    \
+  } while (0)
+
+#define yoru_deque_clear(__deque_ptr)                                                                                  \
+  do {                                                                                                                 \
+    assert((__deque_ptr));                                                                                             \
+    (__deque_ptr)->head = 0;                                                                                           \
+    (__deque_ptr)->size = 0;                                                                                           \
+  } while (0)
+
+#define yoru_deque_destroy_with(__kind, __deque_ptr)                                                                   \
+  do {                                                                                                                 \
+    assert((__deque_ptr));                                                                                             \
+    if ((__deque_ptr)->items) yoru_allocator_dealloc_with(__kind, (__deque_ptr)->allocator, (__deque_ptr)->items);     \
+    (__deque_ptr)->items     = NULL;                                                                                   \
+    (__deque_ptr)->head      = 0;                                                                                      \
+    (__deque_ptr)->size      = 0;                                                                                      \
+    (__deque_ptr)->capacity  = 0;                                                                                      \
+    (__deque_ptr)->allocator = NULL;                                                                                   \
+  } while (0)
 
-static const Yoru_AllocatorVTable __yoru_virtual_arena_allocator_vtable = {
-    .alloc   = __yoru_virtual_arena_allocator_alloc,
-    .dealloc = __yoru_virtual_arena_allocator_dealloc,
-    .realloc = __yoru_virtual_arena_allocator_realloc,
-    .destroy = __yoru_virtual_arena_allocator_destroy,
-};
+#define yoru_deque_destroy(__deque_ptr) yoru_deque_destroy_with(dynamic, __deque_ptr)
 
-typedef struct Yoru_VirtualArenaAllocatorCtx {
-  usize          offset;
-  Yoru_Vmem_Ctx *vmem_ctx;
-} Yoru_VirtualArenaAllocatorCtx;
+#ifdef YORU_IMPL
+void __yoru_deque_copy_in(u8 *items, usize item_size, usize capacity, usize start, const u8 *src, usize count) {
+  usize first = capacity - start < count ? capacity - start : count;
+  memcpy(items + start * item_size, src, first * item_size);
+  if (count > first) memcpy(items, src + first * item_size, (count - first) * item_size);
+}
 
-Yoru_VirtualArenaAllocator *yoru_virtual_arena_allocator_make(usize capacity) {
-  Yoru_VirtualArenaAllocator *a = calloc(1, sizeof(Yoru_VirtualArenaAllocator));
-  if (!a) return NULL;
+void __yoru_deque_copy_out(const u8 *items, usize item_size, usize capacity, usize start, u8 *dst, usize count) {
+  usize first = capacity - start < count ? capacity - start : count;
+  memcpy(dst, items + start * item_size, first * item_size);
+  if (count > first) memcpy(dst + first * item_size, items, (count - first) * item_size);
+}
 
-  Yoru_VirtualArenaAllocatorCtx *ctx = calloc(1, sizeof(Yoru_VirtualArenaAllocatorCtx));
-  if (!ctx) goto err;
+void __yoru_deque_unwrap(u8 *items, usize item_size, usize head, usize size, usize old_capacity) {
+  if (head + size <= old_capacity) return;
+  /* the wrapped part is shorter than the head offset, which is less than the
+     old capacity, so it always fits behind the old end */
+  usize wrapped = head + size - old_capacity;
+  memcpy(items + old_capacity * item_size, items, wrapped * item_size);
+}
+#endif
 
-  Yoru_Vmem_Ctx *vmem_ctx = calloc(1, sizeof *vmem_ctx);
-  if (!vmem_ctx) goto err;
+/* ============================================================
+   MODULE: StructOfArrays
+   generates a container that stores every field of a record in
+   its own array, so a scan over one field only touches memory of
+   that field. The fields are listed once as an X-macro:
+   ```c
+   #define RECORD_FIELDS(X) X(u64, id) X(u32, kind) X(f32, value)
+   YORU_SOA_DEFINE(Records, records, RECORD_FIELDS)
 
-  capacity = yoru_align_up(capacity, yoru_get_page_size());
+   void my_func() {
+     Yoru_Allocator allocator = yoru_global_allocator_make();
+     Records records = {0};
+     records_init(&records, &allocator, 0);
 
-  if (!yoru_vmem_reserve(capacity, vmem_ctx)) goto err;
-  if (!yoru_vmem_commit(vmem_ctx, yoru_get_page_size())) goto err;
+     records_append(&records, (RecordsRow){.id = 1, .kind = 3, .value = 0.5f});
+     f32 sum = 0;
+     for (usize i = 0; i < records.size; ++i) sum += records.value[i];
 
-  ctx->offset   = 0;
-  ctx->vmem_ctx = vmem_ctx;
+     records_destroy(&records);
+   }
+   ```
 
-  a->vtable = &__yoru_virtual_arena_allocator_vtable;
-  a->ctx    = ctx;
-  return a;
+   `YORU_SOA_DEFINE(Type, prefix, FIELDS)` defines
+     - `Type` with `size`, `capacity`, `allocator` and one array
+       per field, named after the field
+     - `TypeRow`, a plain struct with all the fields
+     - `prefix_init`, `prefix_resize`, `prefix_append`,
+       `prefix_get`, `prefix_set` and `prefix_destroy`
+   ============================================================ */
 
-err:
-  if (vmem_ctx) {
-    yoru_vmem_free(vmem_ctx);
-    free(vmem_ctx);
+#define YORU_SOA_INITIAL_CAPACITY (16)
+
+#define __YORU_SOA_ROW_FIELD(__T, __field) __T __field;
+#define __YORU_SOA_COLUMN_FIELD(__T, __field) __T *__field;
+#define __YORU_SOA_COLUMN_ALLOC(__T, __field)                                                                          \
+  if (ok) {                                                                                                            \
+    Yoru_Opt maybe_column = yoru_allocator_alloc_uninit(soa->allocator, new_capacity * sizeof(__T));                   \
+    ok                    = maybe_column.has_value;                                                                    \
+    resized.__field       = maybe_column.ptr;                                                                          \
+  }
+#define __YORU_SOA_COLUMN_FREE_RESIZED(__T, __field)                                                                   \
+  if (resized.__field) yoru_allocator_dealloc(soa->allocator, resized.__field);
+#define __YORU_SOA_COLUMN_MOVE(__T, __field)                                                                           \
+  if (soa->__field) {                                                                                                  \
+    memcpy(resized.__field, soa->__field, kept * sizeof(__T));                                                         \
+    yoru_allocator_dealloc(soa->allocator, soa->__field);                                                              \
+  }                                                                                                                    \
+  soa->__field = resized.__field;
+#define __YORU_SOA_COLUMN_STORE(__T, __field) soa->__field[index] = row.__field;
+#define __YORU_SOA_COLUMN_LOAD(__T, __field) row.__field = soa->__field[index];
+#define __YORU_SOA_COLUMN_DESTROY(__T, __field)                                                                        \
+  if (soa->__field) yoru_allocator_dealloc(soa->allocator, soa->__field);                                              \
+  soa->__field = NULL;
+
+/// defines the container `__type`, its row `__type##Row` and the functions
+/// `__prefix##_*` for the fields in the X-macro `__fields`
+#define YORU_SOA_DEFINE(__type, __prefix, __fields)                                                                    \
+  typedef struct __type##Row {                                                                                         \
+    __fields(__YORU_SOA_ROW_FIELD)                                                                                     \
+  } __type##Row;                                                                                                       \
+                                                                                                                       \
+  typedef struct __type {                                                                                              \
+    usize           size, capacity;                                                                                    \
+    Yoru_Allocator *allocator;                                                                                         \
+    __fields(__YORU_SOA_COLUMN_FIELD)                                                                                  \
+  } __type;                                                                                                            \
+                                                                                                                       \
+  /* all new columns are allocated before any old one is touched, so when one                                          \
+     allocation fails the container stays exactly as it was */                                                         \
+  static inline bool __prefix##_resize(__type *soa, usize new_capacity) {                                              \
+    assert(soa && "must not be null");                                                                                 \
+    __type resized = {0};                                                                                              \
+    bool   ok      = true;                                                                                             \
+    __fields(__YORU_SOA_COLUMN_ALLOC)                                                                                  \
+    if (!ok) {                                                                                                         \
+      __fields(__YORU_SOA_COLUMN_FREE_RESIZED)                                                                         \
+      return false;                                                                                                    \
+    }                                                                                                                  \
+                                                                                                                       \
+    usize kept = soa->size < new_capacity ? soa->size : new_capacity;                                                  \
+    __fields(__YORU_SOA_COLUMN_MOVE)                                                                                   \
+    soa->capacity = new_capacity;                                                                                      \
+    soa->size     = kept;                                                                                              \
+    return true;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  static inline bool __prefix##_init(__type *soa, Yoru_Allocator *allocator, usize capacity) {                         \
+    assert(soa && "must not be null");                                                                                 \
+    assert(allocator && "must not be null");                                                                           \
+    *soa           = (__type){0};                                                                                      \
+    soa->allocator = allocator;                                                                                        \
+    return __prefix##_resize(soa, capacity == 0 ? YORU_SOA_INITIAL_CAPACITY : capacity);                               \
+  }                                                                                                                    \
+                                                                                                                       \
+  static inline bool __prefix##_append(__type *soa, __type##Row row) {                                                 \
+    assert(soa && "must not be null");                                                                                 \
+    usize grown_capacity = soa->capacity ? soa->capacity * 2 : YORU_SOA_INITIAL_CAPACITY;                              \
+    if (soa->size + 1 > soa->capacity && !__prefix##_resize(soa, grown_capacity)) return false;                        \
+    usize index = soa->size++;                                                                                         \
+    __fields(__YORU_SOA_COLUMN_STORE)                                                                                  \
+    return true;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  static inline __type##Row __prefix##_get(const __type *soa, usize index) {                                           \
+    assert(soa && "must not be null");                                                                                 \
+    assert(index < soa->size && "index out of bounds");                                                                \
+    __type##Row row = {0};                                                                                             \
+    __fields(__YORU_SOA_COLUMN_LOAD)                                                                                   \
+    return row;                                                                                                        \
+  }                                                                                                                    \
+                                                                                                                       \
+  static inline void __prefix##_set(__type *soa, usize index, __type##Row row) {                                       \
+    assert(soa && "must not be null");                                                                                 \
+    assert(index < soa->size && "index out of bounds");                                                                \
+    __fields(__YORU_SOA_COLUMN_STORE)                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  static inline void __prefix##_destroy(__type *soa) {                                                                 \
+    assert(soa && "must not be null");                                                                                 \
+    __fields(__YORU_SOA_COLUMN_DESTROY)                                                                                \
+    soa->size      = 0;                                                                                                \
+    soa->capacity  = 0;                                                                                                \
+    soa->allocator = NULL;                                                                                             \
   }
-  free(ctx);
-  free(a);
-  return NULL;
-}
 
-Yoru_Opt __yoru_virtual_arena_allocator_alloc(anyptr ctx, usize size) {
-  if (!ctx) return yoru_opt_none();
+/* ============================================================
+   MODULE: Sort
+   generates typed sort and binary search functions, so the
+   comparison is inlined instead of being an indirect call for
+   every comparison like with qsort:
+   ```c
+   #define U64_LESS(a, b) ((a) < (b))
+   YORU_SORT_DEFINE(u64s, u64, U64_LESS)
 
-  Yoru_VirtualArenaAllocatorCtx *arena = ctx;
-  Yoru_Vmem_Ctx                 *vm    = arena->vmem_ctx;
-  if (arena->offset + size > vm->addr_space_size) return yoru_opt_none();
+   #define U64_KEY(x) (x)
+   YORU_RADIX_SORT_DEFINE(u64s, u64, U64_KEY)
 
-  usize needed = arena->offset + size;
-  usize page   = yoru_get_page_size();
+   void my_func(Yoru_Allocator *allocator) {
+     Yoru_ArrayList_T(u64) xs = {0};
+     // ...
+     yoru_arraylist_sort(&xs, u64s);
+     usize first_ten = yoru_arraylist_lower_bound(&xs, u64s, 10);
 
-  while (vm->commit_pos < needed) {
-    if (!yoru_vmem_commit(vm, page)) return yoru_opt_none();
-  }
+     // or, for integer and float keys, without comparisons at all
+     yoru_arraylist_radix_sort(&xs, u64s, allocator);
+   }
+   ```
 
-  anyptr ptr = (char *)vm->base + arena->offset;
-  arena->offset += size;
+   `YORU_SORT_DEFINE(prefix, T, LESS)` defines `prefix_sort` (an
+   introsort: quicksort that falls back to heapsort when it
+   degenerates and to insertion sort for small ranges),
+   `prefix_lower_bound` and `prefix_upper_bound`. LESS(a, b) is a
+   function or macro that returns true if `a` goes before `b`.
+
+   `YORU_RADIX_SORT_DEFINE(prefix, T, KEY)` defines the stable
+   `prefix_radix_sort`, an LSD radix sort over the u64 that
+   KEY(item) returns. Signed and floating point keys have to go
+   through `yoru_sort_key_i64`, `yoru_sort_key_f32` or
+   `yoru_sort_key_f64` first so their order survives.
+   ============================================================ */
 
-  return yoru_opt_some(ptr);
-}
+/// ranges of up to this many items are insertion sorted
+#define YORU_SORT_INSERTION_THRESHOLD (16)
 
-void __yoru_virtual_arena_allocator_dealloc(anyptr ctx, anyptr ptr) {
-  (void)ctx;
-  (void)ptr;
-  /* Freeing in an arena is a no-op because the idea is that you free the entire
-     arena once. For that you would call the yoru_allocator_destroy func on the
-     arena allocator */
+/// @brief maps an i64 to a u64 with the same order
+static inline u64 yoru_sort_key_i64(i64 x) {
+  return (u64)x ^ ((u64)1 << 63);
 }
 
-Yoru_Opt __yoru_virtual_arena_allocator_realloc(anyptr ctx, usize old_size, anyptr old_ptr, usize new_size) {
-  (void)ctx;
-  (void)old_size;
-  (void)old_ptr;
-  (void)new_size;
-  /* Reallocations are not supported on arena allocators because if you want to
-     grow something in the middle of the arena then we would also have to shift
-     every ptr to the right which might not work becuase the arena might not be
-     able to fit everything with the new ptr in the arena and we dont know in
-     the arena ctx where which ptr starts! otherwise we would have to keep track
-     of them here.
+/// @brief maps an f32 to a u64 with the same order (NaNs go last, or first
+/// when their sign bit is set)
+static inline u64 yoru_sort_key_f32(f32 x) {
+  u32 bits = 0;
+  memcpy(&bits, &x, sizeof(bits));
+  return (u64)((bits & ((u32)1 << 31)) ? ~bits : bits | ((u32)1 << 31));
+}
 
-     -> maybe we could handle reallocs like normal allocations instead and just
-     push to the arena?
-  */
-  return yoru_opt_none();
+/// @brief maps an f64 to a u64 with the same order (NaNs go last, or first
+/// when their sign bit is set)
+static inline u64 yoru_sort_key_f64(f64 x) {
+  u64 bits = 0;
+  memcpy(&bits, &x, sizeof(bits));
+  return (bits & ((u64)1 << 63)) ? ~bits : bits | ((u64)1 << 63);
 }
 
-void __yoru_virtual_arena_allocator_destroy(anyptr ctx) {
-  assert(ctx && "must not be null");
-  Yoru_VirtualArenaAllocatorCtx *c = (Yoru_VirtualArenaAllocatorCtx *)ctx;
-  assert(c->vmem_ctx && "must not be null");
+#define YORU_SORT_DEFINE(__prefix, __T, __less)                                                                        \
+  static inline void __prefix##_swap(__T *items, usize a, usize b) {                                                   \
+    __T tmp  = items[a];                                                                                               \
+    items[a] = items[b];                                                                                               \
+    items[b] = tmp;                                                                                                    \
+  }                                                                                                                    \
+                                                                                                                       \
+  static inline void __prefix##_insertion_sort(__T *items, usize count) {                                              \
+    for (usize i = 1; i < count; ++i) {                                                                                \
+      __T   value = items[i];                                                                                          \
+      usize j     = i;                                                                                                 \
+      for (; j > 0 && __less(value, items[j - 1]); --j) items[j] = items[j - 1];                                       \
+      items[j] = value;                                                                                                \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  static inline void __prefix##_sift_down(__T *items, usize root, usize count) {                                       \
+    for (usize child = 2 * root + 1; child < count; child = 2 * root + 1) {                                            \
+      if (child + 1 < count && __less(items[child], items[child + 1])) ++child;                                        \
+      if (!__less(items[root], items[child])) return;                                                                  \
+      __prefix##_swap(items, root, child);                                                                             \
+      root = child;                                                                                                    \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  static inline void __prefix##_heap_sort(__T *items, usize count) {                                                   \
+    for (usize i = count / 2; i-- > 0;) __prefix##_sift_down(items, i, count);                                         \
+    for (usize end = count; end-- > 1;) {                                                                              \
+      __prefix##_swap(items, 0, end);                                                                                  \
+      __prefix##_sift_down(items, 0, end);                                                                             \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  /* recurses into the smaller partition and loops on the larger one, so the                                           \
+     stack stays logarithmic. Once `depth` runs out the pivots were bad too                                            \
+     often and the range is heap sorted instead */                                                                     \
+  static inline void __prefix##_introsort(__T *items, usize count, usize depth) {                                      \
+    while (count > YORU_SORT_INSERTION_THRESHOLD) {                                                                    \
+      if (depth-- == 0) {                                                                                              \
+        __prefix##_heap_sort(items, count);                                                                            \
+        return;                                                                                                        \
+      }                                                                                                                \
+                                                                                                                       \
+      usize last = count - 1;                                                                                          \
+      usize mid  = last / 2;                                                                                           \
+      if (__less(items[mid], items[0])) __prefix##_swap(items, mid, 0);                                                \
+      if (__less(items[last], items[mid])) {                                                                           \
+        __prefix##_swap(items, last, mid);                                                                             \
+        if (__less(items[mid], items[0])) __prefix##_swap(items, mid, 0);                                              \
+      }                                                                                                                \
+                                                                                                                       \
+      /* hoare partition around the median of three, [0, split] <= pivot and                                           \
+         (split, count) >= pivot with both sides non-empty */                                                          \
+      __T   pivot = items[mid];                                                                                        \
+      usize i     = (usize)-1;                                                                                         \
+      usize split = count;                                                                                             \
+      for (;;) {                                                                                                       \
+        while (__less(items[++i], pivot)) {}                                                                           \
+        while (__less(pivot, items[--split])) {}                                                                       \
+        if (i >= split) break;                                                                                         \
+        __prefix##_swap(items, i, split);                                                                              \
+      }                                                                                                                \
+                                                                                                                       \
+      usize left_count  = split + 1;                                                                                   \
+      usize right_count = count - left_count;                                                                          \
+      if (left_count < right_count) {                                                                                  \
+        __prefix##_introsort(items, left_count, depth);                                                                \
+        items += left_count;                                                                                           \
+        count  = right_count;                                                                                          \
+      } else {                                                                                                         \
+        __prefix##_introsort(items + left_count, right_count, depth);                                                  \
+        count = left_count;                                                                                            \
+      }                                                                                                                \
+    }                                                                                                                  \
+    __prefix##_insertion_sort(items, count);                                                                           \
+  }                                                                                                                    \
+                                                                                                                       \
+  /* sorts `items` in place, not stable */                                                                             \
+  static inline void __prefix##_sort(__T *items, usize count) {                                                        \
+    usize depth = 0;                                                                                                   \
+    for (usize n = count; n > 1; n /= 2) depth += 2;                                                                   \
+    __prefix##_introsort(items, count, depth);                                                                         \
+  }                                                                                                                    \
+                                                                                                                       \
+  /* index of the first item that does not go before `value`, or `count` */                                            \
+  static inline usize __prefix##_lower_bound(const __T *items, usize count, __T value) {                               \
+    usize low = 0;                                                                                                     \
+    while (count > 0) {                                                                                                \
+      usize half = count / 2;                                                                                          \
+      if (__less(items[low + half], value)) {                                                                          \
+        low   += half + 1;                                                                                             \
+        count -= half + 1;                                                                                             \
+      } else {                                                                                                         \
+        count = half;                                                                                                  \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return low;                                                                                                        \
+  }                                                                                                                    \
+                                                                                                                       \
+  /* index of the first item that goes after `value`, or `count` */                                                    \
+  static inline usize __prefix##_upper_bound(const __T *items, usize count, __T value) {                               \
+    usize low = 0;                                                                                                     \
+    while (count > 0) {                                                                                                \
+      usize half = count / 2;                                                                                          \
+      if (!__less(value, items[low + half])) {                                                                         \
+        low   += half + 1;                                                                                             \
+        count -= half + 1;                                                                                             \
+      } else {                                                                                                         \
+        count = half;                                                                                                  \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return low;                                                                                                        \
+  }
 
-  yoru_vmem_free(c->vmem_ctx);
-  free(c->vmem_ctx);
-  free(c);
-}
-#  endif // YORU_IMPL
-#endif   // Platform Check
+#define YORU_RADIX_SORT_DEFINE(__prefix, __T, __key)                                                                   \
+  /* stable, sorts by one byte of the key per pass. The counts for all passes                                          \
+     are collected up front, passes where every key has the same byte are                                              \
+     skipped. Needs a scratch buffer of `count` items, returns false if it can                                         \
+     not be allocated */                                                                                               \
+  static inline bool __prefix##_radix_sort(__T *items, usize count, Yoru_Allocator *scratch_allocator) {               \
+    if (count < 2) return true;                                                                                        \
+    Yoru_Opt maybe_scratch = yoru_allocator_alloc_uninit(scratch_allocator, count * sizeof(__T));                      \
+    if (!maybe_scratch.has_value) return false;                                                                        \
+                                                                                                                       \
+    usize counts[sizeof(u64)][256] = {0};                                                                              \
+    for (usize i = 0; i < count; ++i) {                                                                                \
+      u64 key = __key(items[i]);                                                                                       \
+      for (usize pass = 0; pass < sizeof(u64); ++pass) ++counts[pass][(key >> (pass * 8)) & 0xFF];                     \
+    }                                                                                                                  \
+                                                                                                                       \
+    __T *src = items;                                                                                                  \
+    __T *dst = maybe_scratch.ptr;                                                                                      \
+    for (usize pass = 0; pass < sizeof(u64); ++pass) {                                                                 \
+      usize *pass_counts = counts[pass];                                                                               \
+      if (pass_counts[(__key(src[0]) >> (pass * 8)) & 0xFF] == count) continue;                                        \
+                                                                                                                       \
+      usize offset = 0;                                                                                                \
+      for (usize digit = 0; digit < 256; ++digit) {                                                                    \
+        usize digit_count  = pass_counts[digit];                                                                       \
+        pass_counts[digit] = offset;                                                                                   \
+        offset            += digit_count;                                                                              \
+      }                                                                                                                \
+      for (usize i = 0; i < count; ++i) dst[pass_counts[(__key(src[i]) >> (pass * 8)) & 0xFF]++] = src[i];             \
+                                                                                                                       \
+      __T *tmp = src;                                                                                                  \
+      src      = dst;                                                                                                  \
+      dst      = tmp;                                                                                                  \
+    }                                                                                                                  \
+                                                                                                                       \
+    if (src != items) memcpy(items, src, count * sizeof(__T));                                                         \
+    yoru_allocator_dealloc(scratch_allocator, maybe_scratch.ptr);                                                      \
+    return true;                                                                                                       \
+  }
 
-#define YORU_B(_n) ((usize)1 * (_n))
-#define YORU_KB(_n) ((_n) * YORU_B(1000))    // 1 KB = 1000 bytes
-#define YORU_KiB(_n) ((_n) * YORU_B(1024))   // 1 KiB = 1024 bytes
-#define YORU_MB(_n) ((_n) * YORU_KB(1000))   // 1 MB = 1000 KB
-#define YORU_MiB(_n) ((_n) * YORU_KiB(1024)) // 1 MiB = 1024 KiB
-#define YORU_GB(_n) ((_n) * YORU_MB(1000))   // 1 GB = 1000 MB
-#define YORU_GiB(_n) ((_n) * YORU_MiB(1024)) // 1 GiB = 1024 MiB
+/// sorts the items of an arraylist with the functions from `YORU_SORT_DEFINE`
+#define yoru_arraylist_sort(__arr_ptr, __prefix) __prefix##_sort((__arr_ptr)->items, (__arr_ptr)->size)
+
+/// sorts the items of an arraylist with the function from
+/// `YORU_RADIX_SORT_DEFINE`, returns false if there was no memory for scratch
+#define yoru_arraylist_radix_sort(__arr_ptr, __prefix, __scratch_allocator)                                            \
+  __prefix##_radix_sort((__arr_ptr)->items, (__arr_ptr)->size, (__scratch_allocator))
+
+/// index of the first item of a sorted arraylist that does not go before
+/// `__value`, or its size
+#define yoru_arraylist_lower_bound(__arr_ptr, __prefix, __value)                                                       \
+  __prefix##_lower_bound((__arr_ptr)->items, (__arr_ptr)->size, (__value))
 
+/// index of the first item of a sorted arraylist that goes after `__value`, or
+/// its size
+#define yoru_arraylist_upper_bound(__arr_ptr, __prefix, __value)                                                       \
+  __prefix##_upper_bound((__arr_ptr)->items, (__arr_ptr)->size, (__value))
+
+#if defined(__linux__) || (defined(__APPLE__) && defined(__MACH__)) || defined(_WIN32)
 /* ============================================================
-   MODULE: ArrayList
-   provides an interface to create dynamic arrays by for example
-   creating a new typedef for your ArrayList type or add
-   it as a field in a struct:
+   MODULE: Parallel
+   provides a pool of worker threads and generates parallel
+   for_each, map, reduce and filter functions over arrays, so a
+   pass over a large arraylist uses every core:
    ```c
-   typedef Yoru_ArrayList_T(int) IntArrayList;
+   #define SCALE(x, ctx) (*(x) *= *(u64 *)(ctx))
+   YORU_PARALLEL_FOR_EACH_DEFINE(scale_u64s, u64, SCALE)
 
-   // ... oooor you could also just add it as a field inside a struct,
-   // typedef struct {
-   //   Yoru_ArrayList_T(int) values;
-   // } OtherIntArrayList;
+   #define ADD(a, b) ((a) + (b))
+   YORU_PARALLEL_REDUCE_DEFINE(sum_u64s, u64, ADD)
 
-   void my_func() {
-     Yoru_Allocator allocator = yoru_global_allocator_make();
-     IntArrayList xs = {0};
+   #define IS_EVEN(x, ctx) ((x) % 2 == 0)
+   YORU_PARALLEL_FILTER_DEFINE(filter_even_u64s, u64, IS_EVEN)
 
-     // you can just pass 0 as initial capacity and it will use the default
-     yoru_arraylist_init(&xs, &allocator, 16);
-     for (usize i = 0; i < 128; ++i) {
-       yoru_arraylist_append(&xs, i);
-     }
+   void my_func(Yoru_Allocator *allocator) {
+     Yoru_ThreadPool *pool = yoru_thread_pool_make(0);
+     Yoru_ArrayList_T(u64) xs = {0}, evens = {0};
+     // ...
+     u64 factor = 3;
+     yoru_arraylist_parallel_for_each(pool, &xs, scale_u64s, &factor);
 
-     // do something
+     u64 sum = 0;
+     yoru_arraylist_parallel_reduce(pool, &xs, sum_u64s, 0, &sum, allocator);
 
-     yoru_arraylist_destroy(&xs); // destroys arraylist with allocator that
-   `owns` it
+     yoru_arraylist_init(&evens, allocator, 0);
+     yoru_arraylist_parallel_filter(pool, &xs, &evens, filter_even_u64s, NULL, allocator);
+     yoru_thread_pool_destroy(pool);
    }
    ```
 
-   TODO:
-     - find a way to handle errors better
+   The items are split into chunks of about
+   `YORU_PARALLEL_CHUNK_BYTES`, which the workers and the calling
+   thread take from a shared counter until none are left, so
+   uneven work balances itself. Results do not depend on the
+   number of threads: reduce combines the chunks in order (the
+   operation only has to be associative) and filter keeps the
+   order of the items.
+
+   A pool runs one job at a time and must not be used from
+   inside one of its own jobs. Passing a NULL pool runs
+   everything on the calling thread.
    ============================================================ */
 
-#define YORU_ARRAYLIST_INITIAL_CAPACITY (16)
+/// items are handed to the threads in chunks of about this many bytes
+#  define YORU_PARALLEL_CHUNK_BYTES (YORU_KiB(64))
 
-#define Yoru_ArrayList_T(__T)                                                                                          \
-  struct {                                                                                                             \
-    __T            *items;                                                                                             \
-    usize           size, capacity;                                                                                    \
-    Yoru_Allocator *allocator;                                                                                         \
-  }
+typedef struct Yoru_ThreadPool Yoru_ThreadPool;
 
-#define yoru_arraylist_init(__arr_ptr, __allocator_ptr, __capacity)                                                    \
-  do {                                                                                                                 \
-    Yoru_Opt maybe_items =                                                                                             \
-        yoru_allocator_alloc((__allocator_ptr), YORU_ARRAYLIST_INITIAL_CAPACITY * sizeof((__arr_ptr)->items[0]));      \
-    assert(maybe_items.has_value && "could not allocate memory for arraylist");                                        \
-    (__arr_ptr)->items     = maybe_items.ptr;                                                                          \
-    (__arr_ptr)->size      = 0;                                                                                        \
-    (__arr_ptr)->capacity  = ((__capacity) == 0) ? YORU_ARRAYLIST_INITIAL_CAPACITY : (__capacity);                     \
-    (__arr_ptr)->allocator = __allocator_ptr;                                                                          \
-  } while (0);
+/// @brief processes the items [begin, end) of a job, `chunk` is the index of
+/// the chunk
+typedef void (*Yoru_ParallelChunkFunc)(anyptr ctx, usize chunk, usize begin, usize end);
 
-#define yoru_arraylist_append(__arr_ptr, __value)                                                                      \
-  do {                                                                                                                 \
-    assert((__arr_ptr));                                                                                               \
-    if ((__arr_ptr)->size + 1 > (__arr_ptr)->capacity) {                                                               \
-      yoru_arraylist_resize((__arr_ptr), (__arr_ptr)->capacity * 2);                                                   \
-    }                                                                                                                  \
-    (__arr_ptr)->items[(__arr_ptr)->size++] = (__value);                                                               \
-  } while (0);
+/// @brief starts a pool that runs jobs on `thread_count` threads, counting
+/// the thread that calls `yoru_thread_pool_run`. 0 uses one thread per cpu.
+/// Returns NULL on failure
+Yoru_ThreadPool *yoru_thread_pool_make(usize thread_count);
 
-#define yoru_arraylist_destroy(__arr_ptr)                                                                              \
-  do {                                                                                                                 \
-    assert((__arr_ptr));                                                                                               \
-    if (!(__arr_ptr)->items) {                                                                                         \
-      yoru_allocator_dealloc((__arr_ptr)->allocator, (__arr_ptr)->items);                                              \
-      (__arr_ptr)->items = NULL;                                                                                       \
+/// @brief returns the number of threads a job runs on, counting the caller
+usize yoru_thread_pool_thread_count(const Yoru_ThreadPool *pool);
+
+/// @brief calls `func(ctx, chunk, begin, end)` for all chunks of `chunk_size`
+/// items that `count` items split into, spread over the threads of the pool.
+/// Returns once all chunks are done
+void yoru_thread_pool_run(
+    Yoru_ThreadPool *pool, usize count, usize chunk_size, Yoru_ParallelChunkFunc func, anyptr ctx);
+
+/// @brief stops and joins the worker threads and frees the pool
+void yoru_thread_pool_destroy(Yoru_ThreadPool *pool);
+
+/// @brief returns the number of items of `item_size` bytes per chunk
+static inline usize yoru_parallel_chunk_size(usize item_size) {
+  usize chunk_size = YORU_PARALLEL_CHUNK_BYTES / item_size;
+  return chunk_size > 0 ? chunk_size : 1;
+}
+
+/// @brief returns the number of chunks `count` items split into
+static inline usize yoru_parallel_chunk_count(usize count, usize chunk_size) {
+  return (count + chunk_size - 1) / chunk_size;
+}
+
+/// defines `void __name(Yoru_ThreadPool *pool, __T *items, usize count,
+/// anyptr ctx)`, which calls `__func(&items[i], ctx)` for every item
+#  define YORU_PARALLEL_FOR_EACH_DEFINE(__name, __T, __func)                                                           \
+    typedef struct __name##_Job {                                                                                      \
+      __T   *items;                                                                                                    \
+      anyptr ctx;                                                                                                      \
+    } __name##_Job;                                                                                                    \
+                                                                                                                       \
+    static void __name##_chunk(anyptr job_ptr, usize chunk, usize begin, usize end) {                                  \
+      __name##_Job *job = job_ptr;                                                                                     \
+      (void)chunk;                                                                                                     \
+      for (usize i = begin; i < end; ++i) __func(&job->items[i], job->ctx);                                            \
     }                                                                                                                  \
-    (__arr_ptr)->size      = 0;                                                                                        \
-    (__arr_ptr)->capacity  = 0;                                                                                        \
-    (__arr_ptr)->allocator = NULL;                                                                                     \
-  } while (0)
+                                                                                                                       \
+    static inline void __name(Yoru_ThreadPool *pool, __T *items, usize count, anyptr ctx) {                            \
+      __name##_Job job = {.items = items, .ctx = ctx};                                                                 \
+      yoru_thread_pool_run(pool, count, yoru_parallel_chunk_size(sizeof(__T)), __name##_chunk, &job);                  \
+    }
 
-#define yoru_arraylist_fill(__arr_ptr, __value)                                                                        \
-  do {                                                                                                                 \
-    assert((__arr_ptr));                                                                                               \
-    assert((__arr_ptr)->items);                                                                                        \
-    for (usize __i = 0; __i < (__arr_ptr)->size; ++__i) {                                                              \
-      (__arr_ptr)->items[__i] = __value;                                                                               \
+/// defines `void __name(Yoru_ThreadPool *pool, const __T *items, usize count,
+/// __U *out, anyptr ctx)`, which sets `out[i] = __func(items[i], ctx)` for
+/// every item. `out` must have room for `count` items
+#  define YORU_PARALLEL_MAP_DEFINE(__name, __T, __U, __func)                                                           \
+    typedef struct __name##_Job {                                                                                      \
+      const __T *items;                                                                                                \
+      __U       *out;                                                                                                  \
+      anyptr     ctx;                                                                                                  \
+    } __name##_Job;                                                                                                    \
+                                                                                                                       \
+    static void __name##_chunk(anyptr job_ptr, usize chunk, usize begin, usize end) {                                  \
+      __name##_Job *job = job_ptr;                                                                                     \
+      (void)chunk;                                                                                                     \
+      for (usize i = begin; i < end; ++i) job->out[i] = __func(job->items[i], job->ctx);                               \
     }                                                                                                                  \
-    (__arr_ptr)->size = (__arr_ptr)->capacity;                                                                         \
-  } while (0);
+                                                                                                                       \
+    static inline void __name(Yoru_ThreadPool *pool, const __T *items, usize count, __U *out, anyptr ctx) {            \
+      __name##_Job job        = {.items = items, .out = out, .ctx = ctx};                                              \
+      usize        chunk_size = yoru_parallel_chunk_size(sizeof(__T) > sizeof(__U) ? sizeof(__T) : sizeof(__U));       \
+      yoru_thread_pool_run(pool, count, chunk_size, __name##_chunk, &job);                                             \
+    }
 
-#define yoru_arraylist_clear(__arr_ptr)                                                                                \
-  do {                                                                                                                 \
-    assert((__arr_ptr));                                                                                               \
-    assert((__arr_ptr)->items);                                                                                        \
-    memset((__arr_ptr)->items, 0, (__arr_ptr)->capacity * sizeof((__arr_ptr)->items[0]));                              \
-    (__arr_ptr)->size = 0;                                                                                             \
-  } while (0)
+/// defines `bool __name(Yoru_ThreadPool *pool, const __T *items, usize count,
+/// __T init, __T *out_result, Yoru_Allocator *scratch_allocator)`, which
+/// stores `init` combined with all items in order by the associative
+/// `__op(a, b)` in `out_result`. Every chunk is combined on its own and the
+/// results of the chunks are combined in order on the calling thread. Needs
+/// a scratch buffer of one item per chunk, returns false if it can not be
+/// allocated
+#  define YORU_PARALLEL_REDUCE_DEFINE(__name, __T, __op)                                                               \
+    typedef struct __name##_Job {                                                                                      \
+      const __T *items;                                                                                                \
+      __T       *partials;                                                                                             \
+    } __name##_Job;                                                                                                    \
+                                                                                                                       \
+    static void __name##_chunk(anyptr job_ptr, usize chunk, usize begin, usize end) {                                  \
+      __name##_Job *job = job_ptr;                                                                                     \
+      __T           acc = job->items[begin];                                                                           \
+      for (usize i = begin + 1; i < end; ++i) acc = __op(acc, job->items[i]);                                          \
+      job->partials[chunk] = acc;                                                                                      \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline bool __name(                                                                                         \
+        Yoru_ThreadPool *pool,                                                                                         \
+        const __T       *items,                                                                                        \
+        usize            count,                                                                                        \
+        __T              init,                                                                                         \
+        __T             *out_result,                                                                                   \
+        Yoru_Allocator  *scratch_allocator) {                                                                          \
+      assert(out_result && "must not be null");                                                                        \
+      usize chunk_size  = yoru_parallel_chunk_size(sizeof(__T));                                                       \
+      usize chunk_count = yoru_parallel_chunk_count(count, chunk_size);                                                \
+      if (chunk_count == 0) {                                                                                          \
+        *out_result = init;                                                                                            \
+        return true;                                                                                                   \
+      }                                                                                                                \
+      Yoru_Opt maybe_partials = yoru_allocator_alloc_uninit(scratch_allocator, chunk_count * sizeof(__T));             \
+      if (!maybe_partials.has_value) return false;                                                                     \
+                                                                                                                       \
+      __name##_Job job = {.items = items, .partials = maybe_partials.ptr};                                             \
+      yoru_thread_pool_run(pool, count, chunk_size, __name##_chunk, &job);                                             \
+      __T acc = init;                                                                                                  \
+      for (usize chunk = 0; chunk < chunk_count; ++chunk) acc = __op(acc, job.partials[chunk]);                        \
+      *out_result = acc;                                                                                               \
+                                                                                                                       \
+      yoru_allocator_dealloc(scratch_allocator, maybe_partials.ptr);                                                   \
+      return true;                                                                                                     \
+    }
 
-#define yoru_arraylist_prepend(__arr_ptr, __value)                                                                     \
-  do {                                                                                                                 \
-    usize item_size = sizeof((__arr_ptr)->items[0]);                                                                   \
-    assert((__arr_ptr));                                                                                               \
-    if ((__arr_ptr)->size + 1 > (__arr_ptr)->capacity) {                                                               \
-      yoru_arraylist_resize((__arr_ptr), (__arr_ptr)->capacity * 2);                                                   \
-      \                                                                                                                \
+/// defines `bool __name(Yoru_ThreadPool *pool, const __T *items, usize count,
+/// __T *out, usize *out_count, anyptr ctx, Yoru_Allocator *scratch_allocator)`,
+/// which copies the items for which `__pred(items[i], ctx)` is true to `out`,
+/// keeping their order. The first pass counts the kept items of every chunk,
+/// the second one copies them to the offset that the prefix sum over the
+/// counts gives for the chunk, so `__pred` is called twice per item and must
+/// return the same both times. `out` must have room for `count` items and
+/// must not overlap `items`. Needs a scratch buffer of one usize per chunk,
+/// returns false if it can not be allocated
+#  define YORU_PARALLEL_FILTER_DEFINE(__name, __T, __pred)                                                             \
+    typedef struct __name##_Job {                                                                                      \
+      const __T *items;                                                                                                \
+      __T       *out;                                                                                                  \
+      usize     *offsets;                                                                                              \
+      anyptr     ctx;                                                                                                  \
+    } __name##_Job;                                                                                                    \
+                                                                                                                       \
+    static void __name##_count_chunk(anyptr job_ptr, usize chunk, usize begin, usize end) {                            \
+      __name##_Job *job  = job_ptr;                                                                                    \
+      usize         kept = 0;                                                                                          \
+      for (usize i = begin; i < end; ++i) kept += __pred(job->items[i], job->ctx) ? 1 : 0;                             \
+      job->offsets[chunk] = kept;                                                                                      \
     }                                                                                                                  \
-    memmove((__arr_ptr)->items + 1, (__arr_ptr)->items, (__arr_ptr)->size * item_size);                                \
-    (__arr_ptr)->items[0] = __value;                                                                                   \
-    ++(__arr_ptr)->size;                                                                                               \
-  } while (0);
+                                                                                                                       \
+    static void __name##_copy_chunk(anyptr job_ptr, usize chunk, usize begin, usize end) {                             \
+      __name##_Job *job    = job_ptr;                                                                                  \
+      __T          *out    = job->out;                                                                                 \
+      usize         offset = job->offsets[chunk];                                                                      \
+      for (usize i = begin; i < end; ++i) {                                                                            \
+        if (__pred(job->items[i], job->ctx)) out[offset++] = job->items[i];                                            \
+      }                                                                                                                \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline bool __name(                                                                                         \
+        Yoru_ThreadPool *pool,                                                                                         \
+        const __T       *items,                                                                                        \
+        usize            count,                                                                                        \
+        __T             *out,                                                                                          \
+        usize           *out_count,                                                                                    \
+        anyptr           ctx,                                                                                          \
+        Yoru_Allocator  *scratch_allocator) {                                                                          \
+      assert(out_count && "must not be null");                                                                         \
+      usize chunk_size  = yoru_parallel_chunk_size(sizeof(__T));                                                       \
+      usize chunk_count = yoru_parallel_chunk_count(count, chunk_size);                                                \
+      if (chunk_count == 0) {                                                                                          \
+        *out_count = 0;                                                                                                \
+        return true;                                                                                                   \
+      }                                                                                                                \
+      Yoru_Opt maybe_offsets = yoru_allocator_alloc_uninit(scratch_allocator, chunk_count * sizeof(usize));            \
+      if (!maybe_offsets.has_value) return false;                                                                      \
+                                                                                                                       \
+      __name##_Job job = {.items = items, .out = out, .offsets = maybe_offsets.ptr, .ctx = ctx};                       \
+      yoru_thread_pool_run(pool, count, chunk_size, __name##_count_chunk, &job);                                       \
+      usize total = 0;                                                                                                 \
+      for (usize chunk = 0; chunk < chunk_count; ++chunk) {                                                            \
+        usize kept          = job.offsets[chunk];                                                                      \
+        job.offsets[chunk]  = total;                                                                                   \
+        total              += kept;                                                                                    \
+      }                                                                                                                \
+      yoru_thread_pool_run(pool, count, chunk_size, __name##_copy_chunk, &job);                                        \
+      *out_count = total;                                                                                              \
+                                                                                                                       \
+      yoru_allocator_dealloc(scratch_allocator, maybe_offsets.ptr);                                                    \
+      return true;                                                                                                     \
+    }
 
-#define yoru_arraylist_resize(__arr_ptr, __new_capacity)                                                               \
-  do {                                                                                                                 \
-    usize item_size = sizeof((__arr_ptr)->items[0]);                                                                   \
-    assert((__arr_ptr));                                                                                               \
-    Yoru_Opt maybe_new_ptr = yoru_allocator_realloc(                                                                   \
-        (__arr_ptr)->allocator,                                                                                        \
-        (__arr_ptr)->capacity * item_size,                                                                             \
-        (__arr_ptr)->items,                                                                                            \
-        (__new_capacity) * item_size);                                                                                 \
-    assert(maybe_new_ptr.has_value && "could not append new value");                                                   \
-    anyptr new_ptr        = maybe_new_ptr.ptr;                                                                         \
-    (__arr_ptr)->items    = new_ptr;                                                                                   \
-    (__arr_ptr)->size     = (__arr_ptr)->size < (__new_capacity) ? (__arr_ptr)->size : (__new_capacity);               \
-    (__arr_ptr)->capacity = (__new_capacity);                                                                          \
-  } while (0);
+/// calls the function from `YORU_PARALLEL_FOR_EACH_DEFINE` on every item of
+/// an arraylist
+#  define yoru_arraylist_parallel_for_each(__pool, __arr_ptr, __name, __ctx)                                           \
+    __name((__pool), (__arr_ptr)->items, (__arr_ptr)->size, (__ctx))
+
+/// replaces the items of `__out_arr_ptr` with the items of `__arr_ptr` mapped
+/// by the function from `YORU_PARALLEL_MAP_DEFINE`
+#  define yoru_arraylist_parallel_map_with(__kind, __pool, __arr_ptr, __out_arr_ptr, __name, __ctx)                    \
+    do {                                                                                                               \
+      assert((__arr_ptr));                                                                                             \
+      assert((__out_arr_ptr));                                                                                         \
+      yoru_arraylist_reserve_with(__kind, (__out_arr_ptr), (__arr_ptr)->size);                                         \
+      __name((__pool), (__arr_ptr)->items, (__arr_ptr)->size, (__out_arr_ptr)->items, (__ctx));                        \
+      (__out_arr_ptr)->size = (__arr_ptr)->size;                                                                       \
+    } while (0)
+
+#  define yoru_arraylist_parallel_map(__pool, __arr_ptr, __out_arr_ptr, __name, __ctx)                                 \
+    yoru_arraylist_parallel_map_with(dynamic, __pool, __arr_ptr, __out_arr_ptr, __name, __ctx)
+
+/// combines the items of an arraylist with the function from
+/// `YORU_PARALLEL_REDUCE_DEFINE`, returns false if there was no memory for
+/// scratch
+#  define yoru_arraylist_parallel_reduce(__pool, __arr_ptr, __name, __init, __out_result, __scratch_allocator)         \
+    __name((__pool), (__arr_ptr)->items, (__arr_ptr)->size, (__init), (__out_result), (__scratch_allocator))
+
+/// replaces the items of `__out_arr_ptr` with the items of `__arr_ptr` that
+/// the function from `YORU_PARALLEL_FILTER_DEFINE` keeps
+#  define yoru_arraylist_parallel_filter_with(__kind, __pool, __arr_ptr, __out_arr_ptr, __name, __ctx, __scratch)      \
+    do {                                                                                                               \
+      assert((__arr_ptr));                                                                                             \
+      assert((__out_arr_ptr));                                                                                         \
+      yoru_arraylist_reserve_with(__kind, (__out_arr_ptr), (__arr_ptr)->size);                                         \
+      usize filtered_count = 0;                                                                                        \
+      bool  filtered       = __name(                                                                                   \
+          (__pool),                                                                                                    \
+          (__arr_ptr)->items,                                                                                          \
+          (__arr_ptr)->size,                                                                                           \
+          (__out_arr_ptr)->items,                                                                                      \
+          &filtered_count,                                                                                             \
+          (__ctx),                                                                                                     \
+          (__scratch));                                                                                                \
+      assert(filtered && "could not allocate scratch for filter");                                                     \
+      (void)filtered;                                                                                                  \
+      (__out_arr_ptr)->size = filtered_count;                                                                          \
+    } while (0)
+
+#  define yoru_arraylist_parallel_filter(__pool, __arr_ptr, __out_arr_ptr, __name, __ctx, __scratch)                   \
+    yoru_arraylist_parallel_filter_with(dynamic, __pool, __arr_ptr, __out_arr_ptr, __name, __ctx, __scratch)
+
+#  ifdef YORU_IMPL
+struct Yoru_ThreadPool {
+  /* taken by every thread for every chunk, keep it away from the fields
+     that are only read */
+  _Atomic usize next_chunk;
+  u8            next_chunk_padding[YORU_CACHE_LINE_SIZE - sizeof(usize)];
+
+  Yoru_Mutex   mutex;     // guards everything below up to `workers`
+  Yoru_CondVar job_ready; // a new job was published or the pool shuts down
+  Yoru_CondVar job_done;  // the last worker finished the current job
+  u64          generation;
+  usize        busy_workers; // workers that did not finish the current job yet
+  bool         shutdown;
+
+  Yoru_ParallelChunkFunc func;
+  anyptr                 ctx;
+  usize                  count;
+  usize                  chunk_size;
+  usize                  chunk_count;
+
+  Yoru_Thread *workers;
+  usize        worker_count;
+};
+
+/// runs chunks of the current job until none are left
+static void __yoru_thread_pool_work(Yoru_ThreadPool *pool) {
+  for (;;) {
+    usize chunk = atomic_fetch_add_explicit(&pool->next_chunk, 1, memory_order_relaxed);
+    if (chunk >= pool->chunk_count) return;
+    usize begin = chunk * pool->chunk_size;
+    usize end   = pool->count - begin > pool->chunk_size ? begin + pool->chunk_size : pool->count;
+    pool->func(pool->ctx, chunk, begin, end);
+  }
+}
+
+static void __yoru_thread_pool_worker(anyptr arg) {
+  Yoru_ThreadPool *pool = arg;
+  u64              seen = 0;
+
+  yoru_mutex_lock(&pool->mutex);
+  for (;;) {
+    while (!pool->shutdown && pool->generation == seen) {
+      yoru_condvar_wait(&pool->job_ready, &pool->mutex);
+    }
+    if (pool->shutdown) break;
+    seen = pool->generation;
+    yoru_mutex_unlock(&pool->mutex);
+
+    __yoru_thread_pool_work(pool);
+
+    yoru_mutex_lock(&pool->mutex);
+    if (--pool->busy_workers == 0) yoru_condvar_signal(&pool->job_done);
+  }
+  yoru_mutex_unlock(&pool->mutex);
+}
+
+Yoru_ThreadPool *yoru_thread_pool_make(usize thread_count) {
+  if (thread_count == 0) thread_count = yoru_get_cpu_count();
+
+  Yoru_ThreadPool *pool = calloc(1, sizeof(Yoru_ThreadPool));
+  if (!pool) return NULL;
+  if (!yoru_mutex_init(&pool->mutex)) goto err;
+  if (!yoru_condvar_init(&pool->job_ready)) goto err_mutex;
+  if (!yoru_condvar_init(&pool->job_done)) goto err_job_ready;
+
+  /* the thread that runs a job works on it too, so one thread less is spawned */
+  pool->workers = calloc(thread_count, sizeof(Yoru_Thread));
+  if (!pool->workers) goto err_job_done;
+  for (; pool->worker_count < thread_count - 1; ++pool->worker_count) {
+    if (!yoru_thread_spawn(&pool->workers[pool->worker_count], __yoru_thread_pool_worker, pool)) {
+      yoru_thread_pool_destroy(pool);
+      return NULL;
+    }
+  }
+  return pool;
+
+err_job_done:
+  yoru_condvar_destroy(&pool->job_done);
+err_job_ready:
+  yoru_condvar_destroy(&pool->job_ready);
+err_mutex:
+  yoru_mutex_destroy(&pool->mutex);
+err:
+  free(pool);
+  return NULL;
+}
+
+usize yoru_thread_pool_thread_count(const Yoru_ThreadPool *pool) {
+  return pool ? pool->worker_count + 1 : 1;
+}
+
+void yoru_thread_pool_run(
+    Yoru_ThreadPool *pool, usize count, usize chunk_size, Yoru_ParallelChunkFunc func, anyptr ctx) {
+  assert(func && "must not be null");
+  assert(chunk_size > 0 && "chunks must not be empty");
+
+  usize chunk_count = yoru_parallel_chunk_count(count, chunk_size);
+  if (!pool || pool->worker_count == 0 || chunk_count < 2) {
+    for (usize chunk = 0; chunk < chunk_count; ++chunk) {
+      usize begin = chunk * chunk_size;
+      usize end   = count - begin > chunk_size ? begin + chunk_size : count;
+      func(ctx, chunk, begin, end);
+    }
+    return;
+  }
+
+  yoru_mutex_lock(&pool->mutex);
+  assert(pool->busy_workers == 0 && "a pool runs one job at a time");
+  pool->func        = func;
+  pool->ctx         = ctx;
+  pool->count       = count;
+  pool->chunk_size  = chunk_size;
+  pool->chunk_count = chunk_count;
+  atomic_store_explicit(&pool->next_chunk, 0, memory_order_relaxed);
+  pool->busy_workers = pool->worker_count;
+  ++pool->generation;
+  yoru_condvar_broadcast(&pool->job_ready);
+  yoru_mutex_unlock(&pool->mutex);
+
+  __yoru_thread_pool_work(pool);
+
+  /* every worker has to check in, so none of them can still be taking
+     chunks of this job once the next one resets `next_chunk` */
+  yoru_mutex_lock(&pool->mutex);
+  while (pool->busy_workers > 0) {
+    yoru_condvar_wait(&pool->job_done, &pool->mutex);
+  }
+  yoru_mutex_unlock(&pool->mutex);
+}
+
+void yoru_thread_pool_destroy(Yoru_ThreadPool *pool) {
+  if (!pool) return;
+
+  yoru_mutex_lock(&pool->mutex);
+  pool->shutdown = true;
+  yoru_condvar_broadcast(&pool->job_ready);
+  yoru_mutex_unlock(&pool->mutex);
+  for (usize i = 0; i < pool->worker_count; ++i) {
+    yoru_thread_join(&pool->workers[i]);
+  }
+
+  free(pool->workers);
+  yoru_condvar_destroy(&pool->job_done);
+  yoru_condvar_destroy(&pool->job_ready);
+  yoru_mutex_destroy(&pool->mutex);
+  free(pool);
+}
+#  endif // YORU_IMPL
+#endif   // Platform Check
 
 /* ============================================================
    MODULE: HashMap
@@ -822,26 +6155,34 @@ typedef struct {
     Yoru_Allocator *allocator;                                                                                         \
   }
 
-#define yoru_hashmap_init(__map_ptr, __allocator_ptr)                                                                  \
+#define yoru_hashmap_init_with(__kind, __map_ptr, __allocator_ptr)                                                     \
   do {                                                                                                                 \
     assert((__map_ptr));                                                                                               \
-    yoru_arraylist_init(&(__map_ptr)->entries, (__allocator_ptr), YORU_HASHMAP_INITIAL_CAPACITY);                      \
+    yoru_arraylist_init_with(__kind, &(__map_ptr)->entries, (__allocator_ptr), YORU_HASHMAP_INITIAL_CAPACITY);         \
+    /* the slots are probed through `set`, so they have to start out empty */                                          \
+    yoru_arraylist_clear(&(__map_ptr)->entries);                                                                       \
     (__map_ptr)->allocator = (__allocator_ptr);                                                                        \
-    yoru_arraylist_init(&(__map_ptr)->keys, (__allocator_ptr), YORU_HASHMAP_INITIAL_CAPACITY);                         \
+    yoru_arraylist_init_with(__kind, &(__map_ptr)->keys, (__allocator_ptr), YORU_HASHMAP_INITIAL_CAPACITY);            \
   } while (0);
 
-#define yoru_hashmap_destroy(__map_ptr)                                                                                \
+#define yoru_hashmap_init(__map_ptr, __allocator_ptr)                                                                  \
+  yoru_hashmap_init_with(dynamic, __map_ptr, __allocator_ptr)
+
+#define yoru_hashmap_destroy_with(__kind, __map_ptr)                                                                   \
   do {                                                                                                                 \
     assert((__map_ptr));                                                                                               \
-    yoru_arraylist_destroy(&(__map_ptr)->entries);                                                                     \
+    yoru_arraylist_destroy_with(__kind, &(__map_ptr)->entries);                                                        \
     for (usize i = 0; i < (__map_ptr)->keys.size; ++i) {                                                               \
       if ((__map_ptr)->keys.items[i].key) free((__map_ptr)->keys.items[i].key);                                        \
     }                                                                                                                  \
-    yoru_arraylist_destroy(&(__map_ptr)->keys);                                                                        \
+    yoru_arraylist_destroy_with(__kind, &(__map_ptr)->keys);                                                           \
     (__map_ptr)->allocator = NULL;                                                                                     \
   } while (0);
 
-#define yoru_hashmap_grow_if_needed(__map_ptr)                                                                         \
+#define yoru_hashmap_destroy(__map_ptr)                                                                                \
+  yoru_hashmap_destroy_with(dynamic, __map_ptr)
+
+#define yoru_hashmap_grow_if_needed_with(__kind, __map_ptr)                                                            \
   do {                                                                                                                 \
     assert((__map_ptr));                                                                                               \
     assert((__map_ptr)->allocator);                                                                                    \
@@ -852,11 +6193,12 @@ typedef struct {
     /* still within acceptable load -> nothing to do */                                                                \
     if (load < YORU_HASHMAP_LOAD_FACTOR) break;                                                                        \
     usize    new_capacity         = 2 * capacity;                                                                      \
-    Yoru_Opt maybe_old_items_copy = yoru_allocator_alloc(allocator, capacity * sizeof((__map_ptr)->entries.items[0])); \
+    usize    entries_size         = capacity * sizeof((__map_ptr)->entries.items[0]);                                  \
+    Yoru_Opt maybe_old_items_copy = yoru_allocator_alloc_uninit_with(__kind, allocator, entries_size);                 \
     assert(maybe_old_items_copy.has_value);                                                                            \
     anyptr old_items_copy = maybe_old_items_copy.ptr;                                                                  \
-    memcpy(old_items_copy, (__map_ptr)->entries.items, capacity * sizeof((__map_ptr)->entries.items[0]));              \
-    yoru_arraylist_resize(&(__map_ptr)->entries, new_capacity);                                                        \
+    memcpy(old_items_copy, (__map_ptr)->entries.items, entries_size);                                                  \
+    yoru_arraylist_resize_with(__kind, &(__map_ptr)->entries, new_capacity);                                           \
     yoru_arraylist_clear(&(__map_ptr)->entries);                                                                       \
     (__map_ptr)->entries.size = size;                                                                                  \
     for (usize i = 0; i < (__map_ptr)->keys.size; ++i) {                                                               \
@@ -876,14 +6218,17 @@ typedef struct {
       /* update key index */                                                                                           \
       (__map_ptr)->keys.items[i].index = new_index;                                                                    \
     }                                                                                                                  \
-    yoru_allocator_dealloc(allocator, old_items_copy);                                                                 \
+    yoru_allocator_dealloc_with(__kind, allocator, old_items_copy);                                                    \
   } while (0);
 
-#define yoru_hashmap_set(__map_ptr, __key, __value)                                                                    \
+#define yoru_hashmap_grow_if_needed(__map_ptr)                                                                         \
+  yoru_hashmap_grow_if_needed_with(dynamic, __map_ptr)
+
+#define yoru_hashmap_set_with(__kind, __map_ptr, __key, __value)                                                       \
   do {                                                                                                                 \
     assert((__map_ptr));                                                                                               \
     assert((__key));                                                                                                   \
-    yoru_hashmap_grow_if_needed((__map_ptr));                                                                          \
+    yoru_hashmap_grow_if_needed_with(__kind, (__map_ptr));                                                             \
     usize capacity = (__map_ptr)->entries.capacity;                                                                    \
     usize hash     = yoru_hash_djb2((__key));                                                                          \
     usize index    = hash % capacity;                                                                                  \
@@ -894,7 +6239,8 @@ typedef struct {
         (__map_ptr)->entries.items[index].key   = key_copy;                                                            \
         (__map_ptr)->entries.items[index].value = (__value);                                                           \
         (__map_ptr)->entries.items[index].set   = true;                                                                \
-        yoru_arraylist_append(&((__map_ptr)->keys), ((Yoru_IndexedKey){.key = key_copy, .index = index}));             \
+        Yoru_IndexedKey indexed_key = {.key = key_copy, .index = index};                                               \
+        yoru_arraylist_append_with(__kind, &((__map_ptr)->keys), indexed_key);                                         \
         ++(__map_ptr)->entries.size;                                                                                   \
         break;                                                                                                         \
       }                                                                                                                \
@@ -907,6 +6253,9 @@ typedef struct {
     }                                                                                                                  \
   } while (0)
 
+#define yoru_hashmap_set(__map_ptr, __key, __value)                                                                    \
+  yoru_hashmap_set_with(dynamic, __map_ptr, __key, __value)
+
 #define yoru_hashmap_get(__map_ptr, __key, __out_value_ptr)                                                            \
   do {                                                                                                                 \
     assert((__map_ptr));                                                                                               \
@@ -1199,7 +6548,9 @@ bool yoru_string_make(Yoru_Allocator *allocator, usize length, const char *initi
   assert(allocator);
   assert(out_string);
 
-  Yoru_Opt maybe_data = yoru_allocator_alloc(allocator, length * sizeof(u8));
+  /* the memory only has to be zeroed if nothing is copied into it */
+  Yoru_Opt maybe_data = initial_value ? yoru_allocator_alloc_uninit(allocator, length * sizeof(u8))
+                                      : yoru_allocator_alloc(allocator, length * sizeof(u8));
   if (!maybe_data.has_value) return false;
   if (initial_value != NULL) { memcpy(maybe_data.ptr, initial_value, length); }
 
@@ -1214,9 +6565,7 @@ bool yoru_string_copy(Yoru_Allocator *allocator, Yoru_String *src, Yoru_String *
   assert(src);
   assert(dest);
 
-  if (!yoru_string_make(allocator, src->length, NULL, dest)) return false;
-  memcpy((anyptr)dest->data, src->data, src->length);
-  return true;
+  return yoru_string_make(allocator, src->length, (const char *)src->data, dest);
 }
 
 bool yoru_string_substring(Yoru_String *s, usize start, usize end, Yoru_StringView *out_stringview) {
@@ -1391,10 +6740,14 @@ Yoru_String yoru_file_read_exact(Yoru_Allocator *allocator, const char *filepath
   // make sure that we do not try to read more than we can
   usize read_size = file_size - offset_bytes;
   if (read_size > max_bytes) read_size = max_bytes;
-  if (!yoru_string_make(allocator, read_size, NULL, &res)) goto cleanup;
+  /* the buffer is overwritten by fread, so there is no need to zero it */
+  Yoru_Opt maybe_data = yoru_allocator_alloc_uninit(allocator, read_size);
+  if (!maybe_data.has_value) goto cleanup;
+  res.data      = maybe_data.ptr;
+  res.allocator = allocator;
 
   fseek(file, offset_bytes, SEEK_SET);
-  fread((anyptr)res.data, sizeof(u8), res.length, file);
+  res.length = fread((anyptr)res.data, sizeof(u8), read_size, file);
   fclose(file);
   return res;
 